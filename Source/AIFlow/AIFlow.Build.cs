@@ -12,6 +12,7 @@ public class AIFlow : ModuleRules
 		{
 			"AIModule",
 			"Flow",
+			"MassEntity",
 			// <RGI> #UE56Fix
 			//"StructUtils",
 			// </RGI>
@@ -3,15 +3,26 @@
 #include "AIFlowActorBlackboardHelper.h"
 #include "AIFlowAsset.h"
 #include "AIFlowLogChannels.h"
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType.h"
+#include "Blackboard/AIFlowBlackboardEntryValueRegistry.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
 #include "Blackboard/FlowBlackboardEntryValue.h"
+#include "Mass/AIFlowMassBlackboardSubsystem.h"
+#include "Subsystems/AIFlowBlackboardKeyAgeSubsystem.h"
 #include "Types/FlowArray.h"
 #include "Types/FlowInjectComponentsManager.h"
 #include "Types/FlowInjectComponentsHelper.h"
+#include "Engine/Level.h"
 #include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/StringBuilder.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/GameState.h"
 #include "GameFramework/Pawn.h"
+#include "TimerManager.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowActorBlackboardHelper)
 
@@ -160,39 +171,568 @@ UBlackboardComponent* FAIFlowActorBlackboardHelper::TryFindBlackboardComponent(U
 	return nullptr;
 }
 
-void FAIFlowActorBlackboardHelper::ApplyBlackboardEntries(UBlackboardComponent& BlackboardComponent, const TArray<UFlowBlackboardEntryValue*>& EntriesToApply)
+void FAIFlowActorBlackboardHelper::ApplyBlackboardOptionsToBlackboardComponent(
+	UBlackboardComponent& BlackboardComponent,
+	EPerActorOptionsAssignmentMethod ApplicationMethod,
+	const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
+	const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions)
 {
-	for (const UFlowBlackboardEntryValue* Entry : EntriesToApply)
+	const UWorld* World = BlackboardComponent.GetWorld();
+	UAIFlowBlackboardKeyAgeSubsystem* KeyAgeSubsystem = IsValid(World) ? World->GetSubsystem<UAIFlowBlackboardKeyAgeSubsystem>() : nullptr;
+
+	if (!EntriesForEveryActor.Entries.IsEmpty())
+	{
+		ApplyBlackboardEntries(BlackboardComponent, EntriesForEveryActor.Entries, KeyAgeSubsystem);
+	}
+
+	if (PerActorOptions && !PerActorOptions->IsEmpty())
 	{
-		if (IsValid(Entry))
+		const int32 PerActorOptionIndex =
+			EPerActorOptionsAssignmentMethod_Classifiers::IsStateless(ApplicationMethod) ?
+				ChooseHashedBlackboardOptionIndex(GetActorIdentityHash(BlackboardComponent), AssignmentSeed, PerActorOptions->Num()) :
+				ChooseNextBlackboardOptionIndex(ApplicationMethod, (*PerActorOptions));
+
+		if (PerActorOptionIndex != INDEX_NONE)
 		{
-			Entry->SetOnBlackboardComponent(&BlackboardComponent);
+			const FAIFlowConfigureBlackboardOption& Option = (*PerActorOptions)[PerActorOptionIndex];
+
+			ApplyBlackboardEntries(BlackboardComponent, Option.Entries, KeyAgeSubsystem);
 		}
 	}
 }
 
-void FAIFlowActorBlackboardHelper::ApplyBlackboardOptionsToBlackboardComponent(
-	UBlackboardComponent& BlackboardComponent,
+namespace AIFlowActorBlackboardHelper_Private
+{
+	// The KeyIDs for a list of entries on one blackboard asset (they are the same for every component that uses the asset)
+	struct FResolvedEntryKeyIDs
+	{
+		const UBlackboardData* BlackboardData = nullptr;
+		const TArray<UFlowBlackboardEntryValue*>* Entries = nullptr;
+		TArray<FBlackboard::FKey, TInlineAllocator<8>> KeyIDs;
+	};
+
+	using FResolvedEntryKeyIDsCache = TArray<FResolvedEntryKeyIDs, TInlineAllocator<4>>;
+
+	const FResolvedEntryKeyIDs& FindOrResolveEntryKeyIDs(FResolvedEntryKeyIDsCache& InOutCache, const UBlackboardData& BlackboardData, const TArray<UFlowBlackboardEntryValue*>& Entries)
+	{
+		for (const FResolvedEntryKeyIDs& Resolved : InOutCache)
+		{
+			if (Resolved.BlackboardData == &BlackboardData && Resolved.Entries == &Entries)
+			{
+				return Resolved;
+			}
+		}
+
+		FResolvedEntryKeyIDs& Resolved = InOutCache.AddDefaulted_GetRef();
+		Resolved.BlackboardData = &BlackboardData;
+		Resolved.Entries = &Entries;
+		Resolved.KeyIDs.Reserve(Entries.Num());
+
+		// Keys that the entries cannot write (missing, or of another key type, which the blackboard would refuse)
+		// are resolved to InvalidKey, so that they are neither written nor recorded as written
+		const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(BlackboardData);
+		for (const UFlowBlackboardEntryValue* Entry : Entries)
+		{
+			const FAIFlowBlackboardKeyTableEntry* KeyEntry = IsValid(Entry) ? KeyTable->FindEntry(Entry->Key.GetKeyName()) : nullptr;
+			const TSubclassOf<UBlackboardKeyType> SupportedKeyType = KeyEntry ? Entry->GetSupportedBlackboardKeyType() : nullptr;
+			const bool bCanWriteKey = KeyEntry && KeyEntry->KeyType && (!SupportedKeyType || KeyEntry->KeyType->IsA(SupportedKeyType));
+
+			Resolved.KeyIDs.Add(bCanWriteKey ? KeyEntry->KeyID : FBlackboard::InvalidKey);
+		}
+
+		return Resolved;
+	}
+
+	void ApplyBlackboardEntriesWithKeyIDs(
+		UBlackboardComponent& BlackboardComponent,
+		const TArray<UFlowBlackboardEntryValue*>& Entries,
+		FResolvedEntryKeyIDsCache& InOutCache,
+		UAIFlowBlackboardKeyAgeSubsystem* KeyAgeSubsystem)
+	{
+		const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+		if (!IsValid(BlackboardData))
+		{
+			// Not initialized yet, so there are no keys to write
+			return;
+		}
+
+		const FResolvedEntryKeyIDs& Resolved = FindOrResolveEntryKeyIDs(InOutCache, *BlackboardData, Entries);
+
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			const FBlackboard::FKey KeyID = Resolved.KeyIDs[EntryIndex];
+			if (KeyID == FBlackboard::InvalidKey)
+			{
+				continue;
+			}
+
+			const UFlowBlackboardEntryValue* Entry = Entries[EntryIndex];
+
+			if (KeyAgeSubsystem)
+			{
+				KeyAgeSubsystem->WriteAndRecordKey(BlackboardComponent, KeyID, [Entry, &BlackboardComponent, KeyID]()
+					{
+						Entry->SetOnBlackboardComponentWithKeyID(BlackboardComponent, KeyID);
+					});
+			}
+			else
+			{
+				Entry->SetOnBlackboardComponentWithKeyID(BlackboardComponent, KeyID);
+			}
+		}
+	}
+}
+
+void FAIFlowActorBlackboardHelper::ApplyBlackboardEntries(UBlackboardComponent& BlackboardComponent, const TArray<UFlowBlackboardEntryValue*>& EntriesToApply, UAIFlowBlackboardKeyAgeSubsystem* KeyAgeSubsystem)
+{
+	using namespace AIFlowActorBlackboardHelper_Private;
+
+	FResolvedEntryKeyIDsCache ResolvedKeyIDsCache;
+	ApplyBlackboardEntriesWithKeyIDs(BlackboardComponent, EntriesToApply, ResolvedKeyIDsCache, KeyAgeSubsystem);
+}
+
+void FAIFlowActorBlackboardHelper::ApplyBlackboardOptionsToBlackboardComponents(
+	TArrayView<UBlackboardComponent* const> BlackboardComponents,
 	EPerActorOptionsAssignmentMethod ApplicationMethod,
 	const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
 	const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions)
 {
-	if (!EntriesForEveryActor.Entries.IsEmpty())
+	using namespace AIFlowActorBlackboardHelper_Private;
+
+	// Choose all of the options up-front, one per valid component, so the choice sequence matches the per-component version
+	TArray<UBlackboardComponent*, TInlineAllocator<16>> ValidComponents;
+	ValidComponents.Reserve(BlackboardComponents.Num());
+
+	for (UBlackboardComponent* BlackboardComponent : BlackboardComponents)
+	{
+		if (IsValid(BlackboardComponent))
+		{
+			ValidComponents.Add(BlackboardComponent);
+		}
+	}
+
+	if (ValidComponents.IsEmpty())
 	{
-		ApplyBlackboardEntries(BlackboardComponent, EntriesForEveryActor.Entries);
+		return;
 	}
 
+	TArray<int32> PerActorOptionIndices;
 	if (PerActorOptions && !PerActorOptions->IsEmpty())
 	{
-		const int32 PerActorOptionIndex = ChooseNextBlackboardOptionIndex(ApplicationMethod, (*PerActorOptions));
+		ChooseBlackboardOptionIndicesForComponents(ApplicationMethod, *PerActorOptions, ValidComponents, PerActorOptionIndices);
+	}
+
+	// The entries' KeyIDs are resolved once per blackboard asset (rather than by name for every component)
+	FResolvedEntryKeyIDsCache ResolvedKeyIDsCache;
+
+	const UWorld* World = ValidComponents[0]->GetWorld();
+	UAIFlowBlackboardKeyAgeSubsystem* KeyAgeSubsystem = IsValid(World) ? World->GetSubsystem<UAIFlowBlackboardKeyAgeSubsystem>() : nullptr;
 
+	for (int32 ValidIndex = 0; ValidIndex < ValidComponents.Num(); ++ValidIndex)
+	{
+		UBlackboardComponent& BlackboardComponent = *ValidComponents[ValidIndex];
+
+		if (!EntriesForEveryActor.Entries.IsEmpty())
+		{
+			ApplyBlackboardEntriesWithKeyIDs(BlackboardComponent, EntriesForEveryActor.Entries, ResolvedKeyIDsCache, KeyAgeSubsystem);
+		}
+
+		const int32 PerActorOptionIndex = PerActorOptionIndices.IsValidIndex(ValidIndex) ? PerActorOptionIndices[ValidIndex] : INDEX_NONE;
 		if (PerActorOptionIndex != INDEX_NONE)
 		{
 			const FAIFlowConfigureBlackboardOption& Option = (*PerActorOptions)[PerActorOptionIndex];
 
-			ApplyBlackboardEntries(BlackboardComponent, Option.Entries);
+			ApplyBlackboardEntriesWithKeyIDs(BlackboardComponent, Option.Entries, ResolvedKeyIDsCache, KeyAgeSubsystem);
+		}
+	}
+}
+
+int32 FAIFlowActorBlackboardHelper::ExtractAndQueueBlackboardOptionsForMassAgents(
+	UWorld& World,
+	TArray<AActor*>& InOutActors,
+	EPerActorOptionsAssignmentMethod ApplicationMethod,
+	const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
+	const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions,
+	const UBlackboardData* OptionalBlackboardData)
+{
+	UAIFlowMassBlackboardSubsystem* MassBlackboardSubsystem = World.GetSubsystem<UAIFlowMassBlackboardSubsystem>();
+	if (!MassBlackboardSubsystem)
+	{
+		return 0;
+	}
+
+	TArray<AActor*> MassAgentActors;
+	MassBlackboardSubsystem->ExtractMassAgentActors(InOutActors, MassAgentActors);
+
+	if (MassAgentActors.IsEmpty())
+	{
+		return 0;
+	}
+
+	TArray<FMassEntityHandle> Entities;
+	TArray<uint32> ActorIdentityHashes;
+	Entities.Reserve(MassAgentActors.Num());
+	ActorIdentityHashes.Reserve(MassAgentActors.Num());
+
+	for (const AActor* MassAgentActor : MassAgentActors)
+	{
+		const FMassEntityHandle Entity = MassBlackboardSubsystem->FindEntityForActor(MassAgentActor);
+
+		if (OptionalBlackboardData)
+		{
+			(void) MassBlackboardSubsystem->EnsureEntityBlackboard(Entity, *OptionalBlackboardData);
+		}
+
+		if (!MassBlackboardSubsystem->FindEntityBlackboardData(Entity))
+		{
+			UE_LOG(LogAIFlow, Error, TEXT("Mass agent %s has no blackboard to set values on."), *MassAgentActor->GetName());
+
+			continue;
+		}
+
+		Entities.Add(Entity);
+		ActorIdentityHashes.Add(GetActorIdentityHash(*MassAgentActor));
+	}
+
+	// Choose the options as ApplyBlackboardOptionsToBlackboardComponents() does (one per valid agent)
+	TArray<int32> PerActorOptionIndices;
+	if (PerActorOptions && !PerActorOptions->IsEmpty())
+	{
+		if (EPerActorOptionsAssignmentMethod_Classifiers::IsStateless(ApplicationMethod))
+		{
+			ChooseHashedBlackboardOptionIndices(ApplicationMethod, ActorIdentityHashes, AssignmentSeed, PerActorOptions->Num(), PerActorOptionIndices);
+		}
+		else
+		{
+			ChooseBlackboardOptionIndices(ApplicationMethod, *PerActorOptions, Entities.Num(), PerActorOptionIndices);
+		}
+	}
+
+	for (int32 EntityIndex = 0; EntityIndex < Entities.Num(); ++EntityIndex)
+	{
+		MassBlackboardSubsystem->QueueEntryWrites(Entities[EntityIndex], EntriesForEveryActor.Entries);
+
+		const int32 PerActorOptionIndex = PerActorOptionIndices.IsValidIndex(EntityIndex) ? PerActorOptionIndices[EntityIndex] : INDEX_NONE;
+		if (PerActorOptionIndex != INDEX_NONE)
+		{
+			MassBlackboardSubsystem->QueueEntryWrites(Entities[EntityIndex], (*PerActorOptions)[PerActorOptionIndex].Entries);
+		}
+	}
+
+	return Entities.Num();
+}
+
+void FAIFlowActorBlackboardHelper::ChooseBlackboardOptionIndices(
+	EPerActorOptionsAssignmentMethod ApplicationMethod,
+	const TArray<FAIFlowConfigureBlackboardOption>& PerActorOptions,
+	int32 NumActors,
+	TArray<int32>& OutOptionIndices)
+{
+	OutOptionIndices.Reset(NumActors);
+
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		OutOptionIndices.Add(ChooseNextBlackboardOptionIndex(ApplicationMethod, PerActorOptions));
+	}
+}
+
+void FAIFlowActorBlackboardHelper::ChooseBlackboardOptionIndicesForComponents(
+	EPerActorOptionsAssignmentMethod ApplicationMethod,
+	const TArray<FAIFlowConfigureBlackboardOption>& PerActorOptions,
+	TArrayView<UBlackboardComponent* const> BlackboardComponents,
+	TArray<int32>& OutOptionIndices)
+{
+	if (!EPerActorOptionsAssignmentMethod_Classifiers::IsStateless(ApplicationMethod))
+	{
+		ChooseBlackboardOptionIndices(ApplicationMethod, PerActorOptions, BlackboardComponents.Num(), OutOptionIndices);
+
+		return;
+	}
+
+	// The identity hashes are independent, so only go wide for larger batches
+	constexpr int32 MinComponentsForParallelHashing = 256;
+
+	TArray<uint32> ActorIdentityHashes;
+	ActorIdentityHashes.SetNumUninitialized(BlackboardComponents.Num());
+
+	ParallelFor(
+		BlackboardComponents.Num(),
+		[&](int32 ComponentIndex)
+		{
+			ActorIdentityHashes[ComponentIndex] = GetActorIdentityHash(*BlackboardComponents[ComponentIndex]);
+		},
+		BlackboardComponents.Num() < MinComponentsForParallelHashing ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+
+	ChooseHashedBlackboardOptionIndices(ApplicationMethod, ActorIdentityHashes, AssignmentSeed, PerActorOptions.Num(), OutOptionIndices);
+}
+
+uint32 FAIFlowActorBlackboardHelper::GetActorIdentityHash(const UBlackboardComponent& BlackboardComponent)
+{
+	// Blackboards on a controller are configured for the controlled pawn, so prefer the pawn's identity
+	const AActor* IdentityActor = BlackboardComponent.GetOwner();
+	if (const AController* Controller = Cast<AController>(IdentityActor))
+	{
+		if (const APawn* Pawn = Controller->GetPawn())
+		{
+			IdentityActor = Pawn;
+		}
+	}
+
+	if (IsValid(IdentityActor))
+	{
+		return GetActorIdentityHash(*IdentityActor);
+	}
+
+	TStringBuilder<128> ComponentName;
+	BlackboardComponent.GetFName().ToString(ComponentName);
+
+	return FCrc::StrCrc32(ComponentName.ToString());
+}
+
+uint32 FAIFlowActorBlackboardHelper::GetActorIdentityHash(const AActor& Actor)
+{
+	// Placed actors keep their (level relative) path between runs, and it matches on the server and clients
+	if (Actor.IsNetStartupActor() || Actor.HasAnyFlags(RF_WasLoaded))
+	{
+		const FString LevelRelativePath = Actor.GetPathName(Actor.GetLevel());
+		return FCrc::StrCrc32(*LevelRelativePath);
+	}
+
+	// Spawned actors hash their name, which is fixed when they are spawned
+	// (so the choice does not depend on the order the actors are configured in)
+	TStringBuilder<128> ActorName;
+	Actor.GetFName().ToString(ActorName);
+
+	return FCrc::StrCrc32(ActorName.ToString());
+}
+
+int32 FAIFlowActorBlackboardHelper::ChooseHashedBlackboardOptionIndex(uint32 ActorIdentityHash, int32 AssignmentSeed, int32 NumOptions)
+{
+	if (NumOptions <= 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const uint32 SeededHash = HashCombine(ActorIdentityHash, static_cast<uint32>(AssignmentSeed));
+	return static_cast<int32>(SeededHash % static_cast<uint32>(NumOptions));
+}
+
+void FAIFlowActorBlackboardHelper::ChooseHashedBlackboardOptionIndices(
+	EPerActorOptionsAssignmentMethod ApplicationMethod,
+	TArrayView<const uint32> ActorIdentityHashes,
+	int32 AssignmentSeed,
+	int32 NumOptions,
+	TArray<int32>& OutOptionIndices)
+{
+	static_assert(static_cast<uint8>(EPerActorOptionsAssignmentMethod::Max) == 5, "update this code when changing enum");
+
+	const int32 NumActors = ActorIdentityHashes.Num();
+	OutOptionIndices.Reset(NumActors);
+
+	if (NumOptions <= 0)
+	{
+		OutOptionIndices.Init(INDEX_NONE, NumActors);
+
+		return;
+	}
+
+	if (ApplicationMethod != EPerActorOptionsAssignmentMethod::HashedBalanced || NumActors <= 1)
+	{
+		for (const uint32 ActorIdentityHash : ActorIdentityHashes)
+		{
+			OutOptionIndices.Add(ChooseHashedBlackboardOptionIndex(ActorIdentityHash, AssignmentSeed, NumOptions));
+		}
+
+		return;
+	}
+
+	// Rank the actors by their seeded hash (so the ranking does not depend on the order they were supplied in),
+	// then deal the options out by rank, starting from the lowest-ranked actor's hashed option
+	TArray<uint32> SeededHashes;
+	TArray<int32> RankedActorIndices;
+	SeededHashes.Reserve(NumActors);
+	RankedActorIndices.Reserve(NumActors);
+
+	for (int32 ActorIndex = 0; ActorIndex < NumActors; ++ActorIndex)
+	{
+		SeededHashes.Add(HashCombine(ActorIdentityHashes[ActorIndex], static_cast<uint32>(AssignmentSeed)));
+		RankedActorIndices.Add(ActorIndex);
+	}
+
+	Algo::Sort(RankedActorIndices, [&SeededHashes](int32 A, int32 B)
+		{
+			return SeededHashes[A] < SeededHashes[B];
+		});
+
+	const uint32 DealOffset = SeededHashes[RankedActorIndices[0]] % static_cast<uint32>(NumOptions);
+
+	OutOptionIndices.SetNumUninitialized(NumActors);
+
+	for (int32 Rank = 0; Rank < NumActors; ++Rank)
+	{
+		OutOptionIndices[RankedActorIndices[Rank]] = static_cast<int32>((Rank + DealOffset) % static_cast<uint32>(NumOptions));
+	}
+}
+
+void FAIFlowActorBlackboardHelper::ResetOptionAssignmentState()
+{
+	OrderedOptionIndex = INDEX_NONE;
+	OrderedOptionIndices.Reset();
+
+	CancelTimeSlicedApplication();
+}
+
+void FAIFlowActorBlackboardHelper::BeginTimeSlicedApplication(
+	TArrayView<UBlackboardComponent* const> BlackboardComponents,
+	EPerActorOptionsAssignmentMethod ApplicationMethod,
+	const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions)
+{
+	CancelTimeSlicedApplication();
+
+	TArray<UBlackboardComponent*> ValidComponents;
+	ValidComponents.Reserve(BlackboardComponents.Num());
+
+	for (UBlackboardComponent* BlackboardComponent : BlackboardComponents)
+	{
+		if (IsValid(BlackboardComponent))
+		{
+			ValidComponents.Add(BlackboardComponent);
 		}
 	}
+
+	TimeSlicedBlackboardComponents.Append(ValidComponents);
+
+	if (PerActorOptions && !PerActorOptions->IsEmpty())
+	{
+		ChooseBlackboardOptionIndicesForComponents(ApplicationMethod, *PerActorOptions, ValidComponents, TimeSlicedOptionIndices);
+	}
+
+	TimeSlicedNextIndex = 0;
+}
+
+bool FAIFlowActorBlackboardHelper::ApplyNextTimeSlice(
+	const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
+	const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions,
+	int32 MaxBlackboardsPerSlice,
+	int32 MaxMicrosecondsPerSlice)
+{
+	using namespace AIFlowActorBlackboardHelper_Private;
+
+	if (!IsTimeSlicedApplicationInProgress())
+	{
+		return true;
+	}
+
+	// The entries' KeyIDs are resolved once per blackboard asset for the slice
+	FResolvedEntryKeyIDsCache ResolvedKeyIDsCache;
+	UAIFlowBlackboardKeyAgeSubsystem* KeyAgeSubsystem = nullptr;
+
+	const double StartSeconds = FPlatformTime::Seconds();
+	const double BudgetSeconds = MaxMicrosecondsPerSlice * 0.000001;
+
+	int32 NumApplied = 0;
+	while (TimeSlicedNextIndex < TimeSlicedBlackboardComponents.Num())
+	{
+		if (NumApplied > 0)
+		{
+			const bool bReachedCountBudget = MaxBlackboardsPerSlice > 0 && NumApplied >= MaxBlackboardsPerSlice;
+			const bool bReachedTimeBudget = MaxMicrosecondsPerSlice > 0 && (FPlatformTime::Seconds() - StartSeconds) >= BudgetSeconds;
+			if (bReachedCountBudget || bReachedTimeBudget)
+			{
+				break;
+			}
+		}
+
+		const int32 ApplyIndex = TimeSlicedNextIndex++;
+
+		// The actor (and its blackboard) may have been destroyed since the application began
+		UBlackboardComponent* BlackboardComponent = TimeSlicedBlackboardComponents[ApplyIndex].Get();
+		if (!IsValid(BlackboardComponent))
+		{
+			continue;
+		}
+
+		if (NumApplied == 0)
+		{
+			const UWorld* World = BlackboardComponent->GetWorld();
+			KeyAgeSubsystem = IsValid(World) ? World->GetSubsystem<UAIFlowBlackboardKeyAgeSubsystem>() : nullptr;
+		}
+
+		if (!EntriesForEveryActor.Entries.IsEmpty())
+		{
+			ApplyBlackboardEntriesWithKeyIDs(*BlackboardComponent, EntriesForEveryActor.Entries, ResolvedKeyIDsCache, KeyAgeSubsystem);
+		}
+
+		const int32 PerActorOptionIndex = TimeSlicedOptionIndices.IsValidIndex(ApplyIndex) ? TimeSlicedOptionIndices[ApplyIndex] : INDEX_NONE;
+		if (PerActorOptions && PerActorOptions->IsValidIndex(PerActorOptionIndex))
+		{
+			ApplyBlackboardEntriesWithKeyIDs(*BlackboardComponent, (*PerActorOptions)[PerActorOptionIndex].Entries, ResolvedKeyIDsCache, KeyAgeSubsystem);
+		}
+
+		++NumApplied;
+	}
+
+	if (TimeSlicedNextIndex >= TimeSlicedBlackboardComponents.Num())
+	{
+		// Completed, rather than cancelled, so the serial is not changed
+		TimeSlicedBlackboardComponents.Reset();
+		TimeSlicedOptionIndices.Reset();
+		TimeSlicedNextIndex = INDEX_NONE;
+
+		return true;
+	}
+
+	return false;
+}
+
+bool FAIFlowActorBlackboardHelper::ApplyNextTimeSliceAndScheduleNext(
+	UWorld* World,
+	const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
+	const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions,
+	int32 MaxBlackboardsPerSlice,
+	int32 MaxMicrosecondsPerSlice,
+	const FTimerDelegate& OnNextSlice)
+{
+	TimeSliceTimerHandle.Invalidate();
+	TimeSliceTimerWorld.Reset();
+
+	// Without a world to schedule the next slice, apply the remainder immediately
+	const bool bCanSchedule = IsValid(World);
+
+	const bool bIsComplete = ApplyNextTimeSlice(
+		EntriesForEveryActor,
+		PerActorOptions,
+		bCanSchedule ? MaxBlackboardsPerSlice : 0,
+		bCanSchedule ? MaxMicrosecondsPerSlice : 0);
+
+	if (!bIsComplete)
+	{
+		TimeSliceTimerHandle = World->GetTimerManager().SetTimerForNextTick(OnNextSlice);
+		TimeSliceTimerWorld = World;
+	}
+
+	return bIsComplete;
+}
+
+void FAIFlowActorBlackboardHelper::CancelTimeSlicedApplication()
+{
+	if (TimeSliceTimerHandle.IsValid())
+	{
+		if (UWorld* World = TimeSliceTimerWorld.Get())
+		{
+			World->GetTimerManager().ClearTimer(TimeSliceTimerHandle);
+		}
+
+		TimeSliceTimerHandle.Invalidate();
+	}
+
+	TimeSliceTimerWorld.Reset();
+
+	++TimeSlicedApplicationSerial;
+
+	TimeSlicedBlackboardComponents.Reset();
+	TimeSlicedOptionIndices.Reset();
+	TimeSlicedNextIndex = INDEX_NONE;
 }
 
 TArray<UBlackboardComponent*> FAIFlowActorBlackboardHelper::FindOrAddBlackboardComponentOnActors(
@@ -238,7 +778,7 @@ int32 FAIFlowActorBlackboardHelper::ChooseNextBlackboardOptionIndex(
 	EPerActorOptionsAssignmentMethod ApplicationMethod, 
 	const TArray<FAIFlowConfigureBlackboardOption>& PerActorOptions)
 {
-	static_assert(static_cast<uint8>(EPerActorOptionsAssignmentMethod::Max) == 3, "update this code when changing enum");
+	static_assert(static_cast<uint8>(EPerActorOptionsAssignmentMethod::Max) == 5, "update this code when changing enum");
 
 	if (PerActorOptions.IsEmpty())
 	{
@@ -273,6 +813,11 @@ int32 FAIFlowActorBlackboardHelper::ChooseNextBlackboardOptionIndex(
 		case EPerActorOptionsAssignmentMethod::InOrderWithWrapping:
 			break;
 
+		case EPerActorOptionsAssignmentMethod::HashedByActorIdentity:
+		case EPerActorOptionsAssignmentMethod::HashedBalanced:
+			// Without the actor's identity, the stateless methods fall back to in-order
+			break;
+
 		default: break;
 		}
 
@@ -336,18 +881,18 @@ EFlowDataPinResolveResult FAIFlowActorBlackboardHelper::TryProvideFlowDataPinPro
 		return EFlowDataPinResolveResult::FailedMismatchedType;
 	}
 
-	FBlackboard::FKey BlackboardKeyID = FBlackboard::InvalidKey;
-
 	if (IsValid(OptionalBlackboardComponent))
 	{
-		BlackboardKeyID = OptionalBlackboardComponent->GetKeyID(BlackboardKeyName);
+		const UBlackboardData* BlackboardAsset = OptionalBlackboardComponent->GetBlackboardAsset();
+		const UBlackboardKeyType* FoundKey =
+			IsValid(BlackboardAsset) ? FAIFlowBlackboardKeyTable::Get(*BlackboardAsset)->FindKeyType(BlackboardKeyName) : nullptr;
 
-		if (BlackboardKeyID == FBlackboard::InvalidKey)
+		if (!FoundKey)
 		{
 			return EFlowDataPinResolveResult::FailedUnknownPin;
 		}
 
-		const TSubclassOf<UBlackboardKeyType> FoundKeyType = OptionalBlackboardComponent->GetKeyType(BlackboardKeyID);
+		const TSubclassOf<UBlackboardKeyType> FoundKeyType = FoundKey->GetClass();
 		if (!BlackboardKeyType->IsA(FoundKeyType))
 		{
 			UE_LOG(
@@ -363,12 +908,26 @@ EFlowDataPinResolveResult FAIFlowActorBlackboardHelper::TryProvideFlowDataPinPro
 		}
 	}
 
-	// TODO (gtaylor) Ideally, we optimize this lookup at some point, perhaps with a map?
+	// Fast lookup of the subclass that supports this key type
+	if (const UClass* SupportingSubclass = FAIFlowBlackboardEntryValueRegistry::FindEntryValueSubclassForKeyType(BlackboardKeyType->GetClass()))
+	{
+		const UFlowBlackboardEntryValue* TypedSubclassCDO = Cast<UFlowBlackboardEntryValue>(SupportingSubclass->GetDefaultObject(IsInGameThread()));
+
+		if (TypedSubclassCDO &&
+			TypedSubclassCDO->TryProvideFlowDataPinPropertyFromBlackboardEntry(
+				BlackboardKeyName,
+				*BlackboardKeyType,
+				OptionalBlackboardComponent,
+				OutFlowDataPinProperty))
+		{
+			return EFlowDataPinResolveResult::Success;
+		}
+	}
 
 	// Slow lookup through all of the subclasses until we find one that can do the conversion.
-	const TArray<TWeakObjectPtr<UClass>> Subclasses = UFlowBlackboardEntryValue::EnsureBlackboardEntryValueSubclassArray();
+	const FAIFlowBlackboardEntryValueRegistry::FSnapshotRef Snapshot = FAIFlowBlackboardEntryValueRegistry::GetSnapshot();
 
-	for (TWeakObjectPtr<UClass> SubclassPtr : Subclasses)
+	for (const TWeakObjectPtr<UClass>& SubclassPtr : Snapshot->EntryValueSubclasses)
 	{
 		UClass* Subclass = SubclassPtr.Get();
 		if (!IsValid(Subclass))
@@ -376,13 +935,14 @@ EFlowDataPinResolveResult FAIFlowActorBlackboardHelper::TryProvideFlowDataPinPro
 			continue;
 		}
 
-		const UFlowBlackboardEntryValue* TypedSubclassCDO = Cast<UFlowBlackboardEntryValue>(Subclass->GetDefaultObject());
+		const UFlowBlackboardEntryValue* TypedSubclassCDO = Cast<UFlowBlackboardEntryValue>(Subclass->GetDefaultObject(IsInGameThread()));
 
-		if (TypedSubclassCDO->TryProvideFlowDataPinPropertyFromBlackboardEntry(
-			BlackboardKeyName,
-			*BlackboardKeyType,
-			OptionalBlackboardComponent,
-			OutFlowDataPinProperty))
+		if (TypedSubclassCDO &&
+			TypedSubclassCDO->TryProvideFlowDataPinPropertyFromBlackboardEntry(
+				BlackboardKeyName,
+				*BlackboardKeyType,
+				OptionalBlackboardComponent,
+				OutFlowDataPinProperty))
 		{
 			return EFlowDataPinResolveResult::Success;
 		}
@@ -391,6 +951,28 @@ EFlowDataPinResolveResult FAIFlowActorBlackboardHelper::TryProvideFlowDataPinPro
 	return EFlowDataPinResolveResult::FailedMismatchedType;
 }
 
+EFlowDataPinResolveResult FAIFlowActorBlackboardHelper::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+	const UBlackboardKeyType& BlackboardKeyType,
+	const uint8* RawKeyMemory,
+	TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty)
+{
+	if (!RawKeyMemory)
+	{
+		return EFlowDataPinResolveResult::FailedUnknownPin;
+	}
+
+	// Only the registered subclass for the key type is tried, as raw key memory is only supported by the plain-old-data types
+	const UClass* SupportingSubclass = FAIFlowBlackboardEntryValueRegistry::FindEntryValueSubclassForKeyType(BlackboardKeyType.GetClass());
+	const UFlowBlackboardEntryValue* TypedSubclassCDO = SupportingSubclass ? Cast<UFlowBlackboardEntryValue>(SupportingSubclass->GetDefaultObject(IsInGameThread())) : nullptr;
+
+	if (TypedSubclassCDO && TypedSubclassCDO->TryProvideFlowDataPinPropertyFromRawKeyMemory(BlackboardKeyType, RawKeyMemory, OutFlowDataPinProperty))
+	{
+		return EFlowDataPinResolveResult::Success;
+	}
+
+	return EFlowDataPinResolveResult::FailedMismatchedType;
+}
+
 // FAIFlowCachedBlackboardReference ---
 
 bool FAIFlowCachedBlackboardReference::TryCacheBlackboardReference(const UFlowNodeBase& FlowNodeBase, UBlackboardData* OptionalSpecificBlackboardData, EActorBlackboardSearchRule SpecificBlackboardSearchRule)
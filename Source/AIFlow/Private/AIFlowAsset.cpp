@@ -2,17 +2,31 @@
 
 #include "AIFlowAsset.h"
 #include "AIFlowLogChannels.h"
+#include "AIFlowStats.h"
+#include "AddOns/AIFlowNodeAddOn.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "Blackboard/AIFlowRuntimeBlackboardData.h"
+#include "Nodes/AIFlowNode.h"
+#include "Subsystems/AIFlowColumnarBlackboardSubsystem.h"
 #include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_String.h"
+#include "Engine/AssetManager.h"
 #include "GameFramework/Actor.h"
 #include "GameFramework/Controller.h"
 #include "GameFramework/Pawn.h"
 #include "Interfaces/AIFlowOwnerInterface.h"
+#include "HAL/PlatformTime.h"
 #include "Misc/DataValidation.h"
 #include "Types/FlowInjectComponentsHelper.h"
 #include "Types/FlowInjectComponentsManager.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/UnrealType.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowAsset)
 
+DECLARE_CYCLE_STAT(TEXT("Bulk Initialize Instances"), STAT_AIFlow_BulkInitializeInstances, STATGROUP_AIFlow);
+
 UAIFlowAsset::UAIFlowAsset(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
@@ -21,23 +35,133 @@ UAIFlowAsset::UAIFlowAsset(const FObjectInitializer& ObjectInitializer)
 
 void UAIFlowAsset::InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFlowAsset& InTemplateAsset)
 {
+	// Request the preload first, so that the assets are streaming in while the instance is initialized
+	// (InitializeInstances has already requested it for the whole batch)
+	const UAIFlowAsset* AITemplateAsset = Cast<UAIFlowAsset>(&InTemplateAsset);
+	if (bPreloadManifestOnInitialize && IsValid(AITemplateAsset) && !bIsBulkInitializing)
+	{
+		PreloadHandle = RequestPreloadManifest(*AITemplateAsset, FStreamableDelegate::CreateUObject(this, &ThisClass::OnPreloadManifestLoaded));
+	}
+
 	Super::InitializeInstance(InOwner, InTemplateAsset);
 
 	check(Owner == InOwner.Get());
 
-	// Start with a 'random' random seed, 
-	// this could be overridden with a stable random seed if subclasses wish.
+	if (!bIsBulkInitializing)
+	{
+		// Start with a 'random' random seed, 
+		// this could be overridden with a stable random seed if subclasses wish.
+		const FDateTime& CurrentTime = FDateTime::Now();
+		FRandomStream RandomStream(static_cast<int32>(CurrentTime.GetTicks()));
+		RandomSeed = RandomStream.RandHelper(INT32_MAX);
+	}
+
+	InitializeInstanceBlackboard();
+
+	NotifyOwnerPostInitializeInstance();
+}
+
+int32 UAIFlowAsset::InitializeInstances(
+	UFlowAsset& TemplateAsset,
+	TArrayView<UAIFlowAsset* const> Instances,
+	TArrayView<const TWeakObjectPtr<UObject>> Owners)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_BulkInitializeInstances);
+
+	if (Instances.Num() != Owners.Num())
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("UAIFlowAsset::InitializeInstances requires one Owner per Instance (%d Instances, %d Owners) for %s."), Instances.Num(), Owners.Num(), *TemplateAsset.GetName());
+
+		return 0;
+	}
+
+	const double StartSeconds = FPlatformTime::Seconds();
+
+	// One seed stream for the whole batch, rather than one clock query per instance
 	const FDateTime& CurrentTime = FDateTime::Now();
-	FRandomStream RandomStream(static_cast<int32>(CurrentTime.GetTicks()));
-	RandomSeed = RandomStream.RandHelper(INT32_MAX);
+	FRandomStream SeedStream(static_cast<int32>(CurrentTime.GetTicks()));
+
+	// One PreloadManifest request for the whole batch, rather than resolving every path once per instance
+	TSharedPtr<FStreamableHandle> SharedPreloadHandle;
+	const UAIFlowAsset* AITemplateAsset = Cast<UAIFlowAsset>(&TemplateAsset);
+	if (IsValid(AITemplateAsset) && AITemplateAsset->bPreloadManifestOnInitialize)
+	{
+		TArray<TWeakObjectPtr<UAIFlowAsset>> WeakInstances;
+		WeakInstances.Reserve(Instances.Num());
+
+		for (UAIFlowAsset* Instance : Instances)
+		{
+			WeakInstances.Add(Instance);
+		}
+
+		SharedPreloadHandle = RequestPreloadManifest(
+			*AITemplateAsset,
+			FStreamableDelegate::CreateLambda([WeakInstances = MoveTemp(WeakInstances)]()
+				{
+					for (const TWeakObjectPtr<UAIFlowAsset>& WeakInstance : WeakInstances)
+					{
+						if (UAIFlowAsset* Instance = WeakInstance.Get())
+						{
+							Instance->OnPreloadManifestLoaded();
+						}
+					}
+				}));
+	}
+
+	// One blackboard component base name for the whole batch, rather than building the string once per instance
+	const UBlackboardData* TemplateBlackboardAsset = IsValid(AITemplateAsset) ? AITemplateAsset->BlackboardAsset.Get() : nullptr;
+	const FName SharedBlackboardComponentBaseName = IsValid(TemplateBlackboardAsset) ? MakeBlackboardComponentBaseName(*TemplateBlackboardAsset) : NAME_None;
+
+	int32 NumInitializedInstances = 0;
+
+	for (int32 Index = 0; Index < Instances.Num(); ++Index)
+	{
+		UAIFlowAsset* Instance = Instances[Index];
+		if (!IsValid(Instance))
+		{
+			continue;
+		}
+
+		Instance->RandomSeed = SeedStream.RandHelper(INT32_MAX);
+		Instance->PreloadHandle = SharedPreloadHandle;
+		Instance->bIsPreloadHandleShared = SharedPreloadHandle.IsValid();
+
+		Instance->bIsBulkInitializing = true;
+		Instance->BulkBlackboardComponentBaseName = (Instance->BlackboardAsset == TemplateBlackboardAsset) ? SharedBlackboardComponentBaseName : NAME_None;
+		Instance->InitializeInstance(Owners[Index], TemplateAsset);
+		Instance->BulkBlackboardComponentBaseName = NAME_None;
+		Instance->bIsBulkInitializing = false;
+
+		++NumInitializedInstances;
+	}
+
+	const double ElapsedMilliseconds = (FPlatformTime::Seconds() - StartSeconds) * 1000.0;
+	UE_LOG(LogAIFlow, Verbose, TEXT("Bulk initialized %d instances of %s in %.3f ms"), NumInitializedInstances, *TemplateAsset.GetName(), ElapsedMilliseconds);
 
-	if (UObject* FlowOwnerActor = TryFindActorOwner())
+	return NumInitializedInstances;
+}
+
+void UAIFlowAsset::InitializeInstanceBlackboard()
+{
+	if (!IsValid(TryFindActorOwner()))
+	{
+		return;
+	}
+
+	if (bDeferBlackboardComponentCreation)
+	{
+		bPendingDeferredBlackboardCreation = true;
+	}
+	else
 	{
 		CreateAndRegisterBlackboardComponent();
 
 		SetKeySelfOnBlackboardComponent(BlackboardComponent.Get());
 	}
+}
 
+void UAIFlowAsset::NotifyOwnerPostInitializeInstance()
+{
 	UObject* OwnerObject = Owner.Get();
 	if (IsValid(OwnerObject) && OwnerObject->Implements<UAIFlowOwnerInterface>())
 	{
@@ -47,10 +171,271 @@ void UAIFlowAsset::InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFl
 
 void UAIFlowAsset::DeinitializeInstance()
 {
+	// Nodes that access the blackboard while they are deinitialized must not create the deferred blackboard component
+	bPendingDeferredBlackboardCreation = false;
+
 	Super::DeinitializeInstance();
 
 	// We want to keep the blackboard around until we have deinitialized everything else. 
 	DestroyAndUnregisterBlackboardComponent();
+
+	// Remove all of the injected components (for this asset and its nodes) in one sweep
+	ShutdownInjectComponentsManager();
+
+	RuntimeBlackboardData = nullptr;
+
+	bPendingPreloadedStartFlow = false;
+	PendingStartFlowDataPinValueSupplier.Reset();
+
+	// A shared handle is still in use by the rest of its batch
+	if (PreloadHandle.IsValid() && !bIsPreloadHandleShared)
+	{
+		PreloadHandle->CancelHandle();
+	}
+
+	PreloadHandle.Reset();
+	bIsPreloadHandleShared = false;
+}
+
+void UAIFlowAsset::StartFlow(IFlowDataPinValueSupplierInterface* DataPinValueSupplier)
+{
+	if (bDeferStartFlowUntilPreloaded && IsPreloadManifestLoading())
+	{
+		UE_LOG(LogAIFlow, Verbose, TEXT("Deferring StartFlow for %s until its preload manifest has loaded."), *GetName());
+
+		bPendingPreloadedStartFlow = true;
+		PendingStartFlowDataPinValueSupplier = DataPinValueSupplier;
+
+		return;
+	}
+
+	Super::StartFlow(DataPinValueSupplier);
+}
+
+void UAIFlowAsset::OnPreloadManifestLoaded()
+{
+	if (!bPendingPreloadedStartFlow)
+	{
+		return;
+	}
+
+	bPendingPreloadedStartFlow = false;
+
+	IFlowDataPinValueSupplierInterface* DataPinValueSupplier = PendingStartFlowDataPinValueSupplier.Get();
+	PendingStartFlowDataPinValueSupplier.Reset();
+
+	Super::StartFlow(DataPinValueSupplier);
+}
+
+TSharedPtr<FStreamableHandle> UAIFlowAsset::RequestPreloadManifest(const UAIFlowAsset& TemplateAsset, FStreamableDelegate OnLoaded)
+{
+	TArray<FSoftObjectPath> PathsToLoad;
+	PathsToLoad.Reserve(TemplateAsset.PreloadManifest.Num());
+
+	for (const FSoftObjectPath& Path : TemplateAsset.PreloadManifest)
+	{
+		if (!Path.IsNull() && !Path.ResolveObject())
+		{
+			PathsToLoad.Add(Path);
+		}
+	}
+
+	if (PathsToLoad.IsEmpty())
+	{
+		return nullptr;
+	}
+
+	if (!UAssetManager::IsInitialized())
+	{
+		UE_LOG(LogAIFlow, Warning, TEXT("Cannot preload the manifest for %s without an AssetManager, its assets will load when first used."), *TemplateAsset.GetName());
+
+		return nullptr;
+	}
+
+	return UAssetManager::GetStreamableManager().RequestAsyncLoad(
+		MoveTemp(PathsToLoad),
+		MoveTemp(OnLoaded),
+		FStreamableManager::AsyncLoadHighPriority,
+		false,
+		false,
+		FString::Printf(TEXT("AIFlow Preload %s"), *TemplateAsset.GetName()));
+}
+
+void UAIFlowAsset::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+#if WITH_EDITOR
+	if (!ObjectSaveContext.IsProceduralSave())
+	{
+		PreloadManifest.Reset();
+		GatherPreloadManifest(PreloadManifest);
+	}
+#endif // WITH_EDITOR
+
+	Super::PreSave(ObjectSaveContext);
+}
+
+#if WITH_EDITOR
+namespace AIFlowAsset_Private
+{
+	void GatherPreloadReferences(const UObject& Object, const UAIFlowAsset& FlowAsset, TSet<const UObject*>& VisitedObjects, TArray<FSoftObjectPath>& OutPreloadManifest)
+	{
+		bool bAlreadyVisited = false;
+		VisitedObjects.Add(&Object, &bAlreadyVisited);
+		if (bAlreadyVisited)
+		{
+			return;
+		}
+
+		for (TPropertyValueIterator<FProperty> It(Object.GetClass(), &Object, EPropertyValueIteratorFlags::FullRecursion); It; ++It)
+		{
+			const FProperty* Property = It.Key();
+			const void* PropertyValue = It.Value();
+
+			if (Property->HasAnyPropertyFlags(CPF_Transient))
+			{
+				It.SkipRecursiveProperty();
+
+				continue;
+			}
+
+			// Only soft references (including soft class references) need preloading,
+			// hard references are already loaded along with the flow asset
+			if (const FSoftObjectProperty* SoftObjectProperty = CastField<FSoftObjectProperty>(Property))
+			{
+				const FSoftObjectPath& SoftPath = static_cast<const FSoftObjectPtr*>(PropertyValue)->ToSoftObjectPath();
+				if (!SoftPath.IsNull())
+				{
+					OutPreloadManifest.AddUnique(SoftPath);
+				}
+			}
+			else if (const FObjectProperty* ObjectProperty = CastField<FObjectProperty>(Property))
+			{
+				// Instanced subobjects (eg, blackboard entry values) can hold soft references too
+				const UObject* ReferencedObject = ObjectProperty->GetObjectPropertyValue(PropertyValue);
+				if (ReferencedObject && ReferencedObject->IsIn(&FlowAsset))
+				{
+					GatherPreloadReferences(*ReferencedObject, FlowAsset, VisitedObjects, OutPreloadManifest);
+				}
+			}
+		}
+	}
+
+	void GatherAddOnPreloadReferences(const UFlowNodeBase& FlowNodeBase, const UAIFlowAsset& FlowAsset, TSet<const UObject*>& VisitedObjects, TArray<FSoftObjectPath>& OutPreloadManifest)
+	{
+		for (const UFlowNodeAddOn* AddOn : FlowNodeBase.GetFlowNodeAddOnChildren())
+		{
+			if (IsValid(AddOn))
+			{
+				GatherPreloadReferences(*AddOn, FlowAsset, VisitedObjects, OutPreloadManifest);
+				GatherAddOnPreloadReferences(*AddOn, FlowAsset, VisitedObjects, OutPreloadManifest);
+			}
+		}
+	}
+}
+
+void UAIFlowAsset::GatherPreloadManifest(TArray<FSoftObjectPath>& OutPreloadManifest) const
+{
+	TSet<const UObject*> VisitedObjects;
+
+	for (const TPair<FGuid, UFlowNode*>& NodePair : GetNodes())
+	{
+		const UFlowNode* Node = NodePair.Value;
+		if (IsValid(Node))
+		{
+			AIFlowAsset_Private::GatherPreloadReferences(*Node, *this, VisitedObjects, OutPreloadManifest);
+			AIFlowAsset_Private::GatherAddOnPreloadReferences(*Node, *this, VisitedObjects, OutPreloadManifest);
+		}
+	}
+
+	// The flow asset itself (and its subobjects) are loaded by the time its manifest is read
+	const FSoftObjectPath ThisPath(this);
+	OutPreloadManifest.RemoveAll(
+		[&ThisPath](const FSoftObjectPath& Path)
+		{
+			return Path.GetAssetPath() == ThisPath.GetAssetPath();
+		});
+}
+#endif // WITH_EDITOR
+
+namespace AIFlowAsset_Private
+{
+	void ResetAddOnsForReuse(const UFlowNodeBase& FlowNodeBase)
+	{
+		for (UFlowNodeAddOn* AddOn : FlowNodeBase.GetFlowNodeAddOnChildren())
+		{
+			if (!IsValid(AddOn))
+			{
+				continue;
+			}
+
+			if (UAIFlowNodeAddOn* AIAddOn = Cast<UAIFlowNodeAddOn>(AddOn))
+			{
+				AIAddOn->ResetInstanceForReuse();
+			}
+
+			ResetAddOnsForReuse(*AddOn);
+		}
+	}
+
+	// InitializeInstance replaces each of the Nodes with a new node instance that has it as its archetype,
+	// so a reused instance's Nodes are restored to the template's (rather than growing the archetype chain on each reuse)
+	bool RestoreTemplateNodes(UFlowAsset& Instance, const UFlowAsset& TemplateAsset)
+	{
+		static const FMapProperty* NodesProperty = FindFProperty<FMapProperty>(UFlowAsset::StaticClass(), TEXT("Nodes"));
+		if (!NodesProperty)
+		{
+			return false;
+		}
+
+		NodesProperty->CopyCompleteValue_InContainer(&Instance, &TemplateAsset);
+
+		return true;
+	}
+}
+
+bool UAIFlowAsset::ResetInstanceForReuse()
+{
+	// The manager is shut down in DeinitializeInstance, so this instance is still initialized
+	if (!ensureMsgf(!IsValid(InjectComponentsManager), TEXT("%s must be deinitialized before it is reset for reuse."), *GetName()))
+	{
+		return false;
+	}
+
+	for (const TPair<FGuid, UFlowNode*>& NodePair : GetNodes())
+	{
+		UFlowNode* Node = NodePair.Value;
+		if (!IsValid(Node))
+		{
+			continue;
+		}
+
+		if (UAIFlowNode* AINode = Cast<UAIFlowNode>(Node))
+		{
+			AINode->ResetInstanceForReuse();
+		}
+
+		AIFlowAsset_Private::ResetAddOnsForReuse(*Node);
+	}
+
+	const UFlowAsset* InstanceTemplateAsset = GetTemplateAsset();
+	if (!IsValid(InstanceTemplateAsset) || !AIFlowAsset_Private::RestoreTemplateNodes(*this, *InstanceTemplateAsset))
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot reset %s for reuse, its nodes could not be restored from its template."), *GetName());
+
+		return false;
+	}
+
+	BlackboardComponent = nullptr;
+	bPendingDeferredBlackboardCreation = false;
+	RuntimeBlackboardData = nullptr;
+	RandomSeed = 0;
+
+	bPendingPreloadedStartFlow = false;
+	PendingStartFlowDataPinValueSupplier.Reset();
+	PreloadHandle.Reset();
+	bIsPreloadHandleShared = false;
+
+	return true;
 }
 
 UBlackboardData* UAIFlowAsset::GetBlackboardAsset() const
@@ -63,6 +448,31 @@ UBlackboardComponent* UAIFlowAsset::GetBlackboardComponent() const
 	return BlackboardComponent.Get();
 }
 
+UBlackboardComponent* UAIFlowAsset::EnsureBlackboardComponent()
+{
+	if (bPendingDeferredBlackboardCreation)
+	{
+		CreateDeferredBlackboardComponent();
+	}
+
+	return BlackboardComponent.Get();
+}
+
+void UAIFlowAsset::CreateDeferredBlackboardComponent()
+{
+	// Only ever attempt the deferred creation once per instance
+	bPendingDeferredBlackboardCreation = false;
+
+	if (!IsValid(TryFindActorOwner()))
+	{
+		return;
+	}
+
+	CreateAndRegisterBlackboardComponent();
+
+	SetKeySelfOnBlackboardComponent(BlackboardComponent.Get());
+}
+
 UBlackboardComponent* UAIFlowAsset::BP_TryFindBlackboardComponentOnActor(AActor* Actor, UBlackboardData* OptionalBlackboardData)
 {
 	if (IsValid(Actor))
@@ -139,33 +549,372 @@ void UAIFlowAsset::CreateAndRegisterBlackboardComponent()
 	}
 
 	// If the desired blackboard component does not already exist, add it to the ActorOwner
-	const FName InstanceBaseName = FName(FString(TEXT("Comp_") + BlackboardAsset->GetName()));
+	const FName InstanceBaseName = BulkBlackboardComponentBaseName.IsNone() ? MakeBlackboardComponentBaseName(*BlackboardAsset) : BulkBlackboardComponentBaseName;
 	UActorComponent* ComponentInstance = FFlowInjectComponentsHelper::TryCreateComponentInstanceForActorFromClass(*ActorOwner, BlackboardComponentClass, InstanceBaseName);
 	BlackboardComponent = CastChecked<UBlackboardComponent>(ComponentInstance);
 
-	// Create the manager object if we're injecting a component
-	InjectComponentsManager = NewObject<UFlowInjectComponentsManager>(this);
-	InjectComponentsManager->InitializeRuntime();
-
 	// Inject the desired component
-	InjectComponentsManager->InjectComponentOnActor(*ActorOwner, *ComponentInstance);
+	EnsureInjectComponentsManager()->InjectComponentOnActor(*ActorOwner, *ComponentInstance);
 
 	// Ensure the Runtime BlackboardData is instanced (if subclasses need to instance it)
+	BuildRuntimeBlackboardData();
 	UBlackboardData* RuntimeBlackboard = EnsureRuntimeBlackboardData();
+	if (!IsValid(RuntimeBlackboard))
+	{
+		return;
+	}
 
 	BlackboardComponent->InitializeBlackboard(*RuntimeBlackboard);
+
+	UAIFlowColumnarBlackboardSubsystem::SyncComponentRegistration(*BlackboardComponent);
+}
+
+FName UAIFlowAsset::MakeBlackboardComponentBaseName(const UBlackboardData& BlackboardData)
+{
+	return FName(FString(TEXT("Comp_") + BlackboardData.GetName()));
+}
+
+UBlackboardData* UAIFlowAsset::EnsureRuntimeBlackboardData() const
+{
+	// The runtime blackboard data (if any) is built by BuildRuntimeBlackboardData() before it is first needed
+	if (IsValid(RuntimeBlackboardData))
+	{
+		return RuntimeBlackboardData;
+	}
+
+	return BlackboardAsset;
+}
+
+void UAIFlowAsset::BuildRuntimeBlackboardData()
+{
+	if (IsValid(RuntimeBlackboardData) || !IsValid(BlackboardAsset))
+	{
+		return;
+	}
+
+	TArray<FBlackboardEntry> RuntimeKeys;
+	GatherRuntimeBlackboardKeys(RuntimeKeys);
+
+	if (RuntimeKeys.IsEmpty())
+	{
+		return;
+	}
+
+	if (bShareRuntimeBlackboardData)
+	{
+		RuntimeBlackboardData = FAIFlowRuntimeBlackboardDataRegistry::FindOrCreateShared(*BlackboardAsset, RuntimeKeys);
+	}
+	else
+	{
+		RuntimeBlackboardData = FAIFlowRuntimeBlackboardDataRegistry::CreateUnshared(*this, *BlackboardAsset, RuntimeKeys);
+	}
+}
+
+namespace AIFlowAsset_Private
+{
+	struct FBlackboardKeyValueSnapshot
+	{
+		FName KeyName = NAME_None;
+		const UClass* KeyTypeClass = nullptr;
+
+		// Raw value memory (for the key types without key instances)
+		TArray<uint8> RawValue;
+
+		// String keys keep their value in a key instance, so are copied by value
+		FString StringValue;
+	};
+
+	void SnapshotKeyValues(const UBlackboardComponent& BlackboardComponent, TArray<FBlackboardKeyValueSnapshot>& OutSnapshots)
+	{
+		const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+		if (!IsValid(BlackboardData))
+		{
+			return;
+		}
+
+		const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(*BlackboardData);
+		OutSnapshots.Reserve(KeyTable->GetEntries().Num());
+
+		for (const FAIFlowBlackboardKeyTableEntry& Entry : KeyTable->GetEntries())
+		{
+			if (!Entry.KeyType)
+			{
+				continue;
+			}
+
+			if (Entry.KeyType->IsA<UBlackboardKeyType_String>())
+			{
+				FBlackboardKeyValueSnapshot& Snapshot = OutSnapshots.AddDefaulted_GetRef();
+				Snapshot.KeyName = Entry.KeyName;
+				Snapshot.KeyTypeClass = Entry.KeyType->GetClass();
+				Snapshot.StringValue = BlackboardComponent.GetValue<UBlackboardKeyType_String>(Entry.KeyID);
+
+				continue;
+			}
+
+			// Other instanced key types (eg, Struct) are re-initialized to their defaults
+			const uint8* RawData = Entry.KeyType->HasInstance() ? nullptr : BlackboardComponent.GetKeyRawData(Entry.KeyID);
+			if (!RawData)
+			{
+				continue;
+			}
+
+			FBlackboardKeyValueSnapshot& Snapshot = OutSnapshots.AddDefaulted_GetRef();
+			Snapshot.KeyName = Entry.KeyName;
+			Snapshot.KeyTypeClass = Entry.KeyType->GetClass();
+			Snapshot.RawValue.Append(RawData, Entry.KeyType->GetValueSize());
+		}
+	}
+
+	// Restore the snapshot values to the keys (with the same name and key type) of the re-initialized BlackboardComponent.
+	// Raw values are restored directly (without notifying observers), since (from their point of view) they are unchanged.
+	void RestoreKeyValues(UBlackboardComponent& BlackboardComponent, TConstArrayView<FBlackboardKeyValueSnapshot> Snapshots)
+	{
+		const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+		if (!IsValid(BlackboardData))
+		{
+			return;
+		}
+
+		const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(*BlackboardData);
+
+		for (const FBlackboardKeyValueSnapshot& Snapshot : Snapshots)
+		{
+			const FAIFlowBlackboardKeyTableEntry* Entry = KeyTable->FindEntry(Snapshot.KeyName);
+			if (!Entry || !Entry->KeyType || Entry->KeyType->GetClass() != Snapshot.KeyTypeClass)
+			{
+				continue;
+			}
+
+			if (Entry->KeyType->IsA<UBlackboardKeyType_String>())
+			{
+				(void) BlackboardComponent.SetValue<UBlackboardKeyType_String>(Entry->KeyID, Snapshot.StringValue);
+
+				continue;
+			}
+
+			uint8* RawData = BlackboardComponent.GetKeyRawData(Entry->KeyID);
+			if (RawData && Snapshot.RawValue.Num() == Entry->KeyType->GetValueSize())
+			{
+				FMemory::Memcpy(RawData, Snapshot.RawValue.GetData(), Snapshot.RawValue.Num());
+			}
+		}
+	}
+}
+
+UBlackboardData* UAIFlowAsset::DivergeRuntimeBlackboardData(TFunctionRef<void(UBlackboardData&)> ModifyBlackboardData)
+{
+	using namespace AIFlowAsset_Private;
+
+	if (!IsValid(BlackboardAsset))
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot diverge the runtime blackboard data for %s without a BlackboardAsset."), *GetName());
+
+		return nullptr;
+	}
+
+	BuildRuntimeBlackboardData();
+
+	UBlackboardData* SourceBlackboardData = EnsureRuntimeBlackboardData();
+	if (!IsValid(SourceBlackboardData))
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot diverge the runtime blackboard data for %s without a runtime blackboard data to diverge from."), *GetName());
+
+		return nullptr;
+	}
+
+	// Snapshot the values of the blackboard component that this asset initialized, before its data is changed
+	UBlackboardComponent* BlackboardComp = BlackboardComponent.Get();
+	const bool bReinitializeBlackboardComponent = IsValid(BlackboardComp) && BlackboardComp->GetBlackboardAsset() == SourceBlackboardData;
+
+	TArray<FBlackboardKeyValueSnapshot> KeyValueSnapshots;
+	if (bReinitializeBlackboardComponent)
+	{
+		SnapshotKeyValues(*BlackboardComp, KeyValueSnapshots);
+	}
+
+	// Clone the shared (or base, or subclass provided) blackboard data, so that the modification only affects this instance
+	const bool bIsOwnedByThisInstance = (SourceBlackboardData == RuntimeBlackboardData) && !FAIFlowRuntimeBlackboardDataRegistry::IsShared(*SourceBlackboardData);
+	if (SourceBlackboardData == BlackboardAsset)
+	{
+		RuntimeBlackboardData = FAIFlowRuntimeBlackboardDataRegistry::CreateUnshared(*this, *BlackboardAsset, {});
+	}
+	else if (!bIsOwnedByThisInstance)
+	{
+		RuntimeBlackboardData = FAIFlowRuntimeBlackboardDataRegistry::CloneUnshared(*this, *SourceBlackboardData);
+	}
+
+	if (!IsValid(RuntimeBlackboardData))
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Could not create the diverged runtime blackboard data for %s."), *GetName());
+
+		return nullptr;
+	}
+
+	ModifyBlackboardData(*RuntimeBlackboardData);
+
+	FAIFlowRuntimeBlackboardDataRegistry::UpdateRuntimeKeys(*RuntimeBlackboardData);
+
+	// Data modified in place may already have a (now stale) cached key table
+	if (bIsOwnedByThisInstance)
+	{
+		FAIFlowBlackboardKeyTable::Invalidate(*RuntimeBlackboardData);
+	}
+
+	// Only re-initialize a blackboard component that this asset initialized with its runtime blackboard data
+	if (bReinitializeBlackboardComponent)
+	{
+		BlackboardComp->InitializeBlackboard(*RuntimeBlackboardData);
+
+		UAIFlowColumnarBlackboardSubsystem::SyncComponentRegistration(*BlackboardComp);
+
+		RestoreKeyValues(*BlackboardComp, KeyValueSnapshots);
+
+		SetKeySelfOnBlackboardComponent(BlackboardComp);
+	}
+
+	return RuntimeBlackboardData;
 }
 
 void UAIFlowAsset::DestroyAndUnregisterBlackboardComponent()
+{
+	// The injected blackboard component (if any) is removed when the InjectComponentsManager is shut down
+	BlackboardComponent = nullptr;
+}
+
+UFlowInjectComponentsManager* UAIFlowAsset::AcquireInjectComponentsManager(const UObject& User, const FAIFlowOnBeforeInjectedActorRemoved& OnBeforeActorRemoved)
+{
+	FInjectComponentsManagerUser& ManagerUser = InjectComponentsManagerUsers.FindOrAdd(&User);
+	if (ManagerUser.RefCount++ == 0 && !ManagerUser.OnBeforeActorRemoved.IsBound())
+	{
+		ManagerUser.OnBeforeActorRemoved = OnBeforeActorRemoved;
+	}
+
+	return EnsureInjectComponentsManager();
+}
+
+void UAIFlowAsset::ReleaseInjectComponentsManager(const UObject& User)
+{
+	FInjectComponentsManagerUser* ManagerUser = InjectComponentsManagerUsers.Find(&User);
+	if (!ManagerUser || ManagerUser->RefCount <= 0)
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("%s released the InjectComponentsManager for %s without acquiring it."), *User.GetName(), *GetName());
+
+		return;
+	}
+
+	if (--ManagerUser->RefCount > 0)
+	{
+		return;
+	}
+
+	// Notify the User of its actors now, as it was when it shut down its own manager
+	// (their components are removed when the shared manager is shut down)
+	const FAIFlowOnBeforeInjectedActorRemoved OnBeforeActorRemoved = ManagerUser->OnBeforeActorRemoved;
+	InjectComponentsManagerUsers.Remove(&User);
+
+	const TObjectKey<UObject> UserKey(&User);
+	TArray<AActor*, TInlineAllocator<8>> UserActors;
+
+	for (auto It = InjectedActorUsers.CreateIterator(); It; ++It)
+	{
+		if (It->Value.RemoveSingleSwap(UserKey, EAllowShrinking::No) == 0)
+		{
+			continue;
+		}
+
+		if (AActor* Actor = It->Key.ResolveObjectPtr())
+		{
+			UserActors.Add(Actor);
+		}
+
+		if (It->Value.IsEmpty())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (AActor* Actor : UserActors)
+	{
+		OnBeforeActorRemoved.ExecuteIfBound(Actor);
+	}
+}
+
+void UAIFlowAsset::RegisterInjectedActorUser(const UObject& User, AActor& Actor)
+{
+	// Prune the entries for actors that were destroyed without the manager removing their components
+	constexpr int32 NumInjectedActorsRegisteredPerPrune = 64;
+	if (++NumInjectedActorsRegisteredSincePrune >= NumInjectedActorsRegisteredPerPrune)
+	{
+		for (auto It = InjectedActorUsers.CreateIterator(); It; ++It)
+		{
+			if (!It->Key.ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+
+		NumInjectedActorsRegisteredSincePrune = 0;
+	}
+
+	InjectedActorUsers.FindOrAdd(&Actor).AddUnique(&User);
+}
+
+UFlowInjectComponentsManager* UAIFlowAsset::EnsureInjectComponentsManager()
+{
+	if (!IsValid(InjectComponentsManager))
+	{
+		InjectComponentsManager = NewObject<UFlowInjectComponentsManager>(this);
+
+		InjectComponentsManager->InitializeRuntime();
+		InjectComponentsManager->BeforeActorRemovedDelegate.AddDynamic(this, &ThisClass::OnBeforeInjectedActorRemoved);
+	}
+
+	return InjectComponentsManager;
+}
+
+void UAIFlowAsset::ShutdownInjectComponentsManager()
 {
 	if (IsValid(InjectComponentsManager))
 	{
 		InjectComponentsManager->ShutdownRuntime();
+
+		InjectComponentsManager->BeforeActorRemovedDelegate.RemoveDynamic(this, &ThisClass::OnBeforeInjectedActorRemoved);
 	}
 
 	InjectComponentsManager = nullptr;
 
-	BlackboardComponent = nullptr;
+	InjectComponentsManagerUsers.Reset();
+	InjectedActorUsers.Reset();
+	NumInjectedActorsRegisteredSincePrune = 0;
+}
+
+void UAIFlowAsset::OnBeforeInjectedActorRemoved(AActor* RemovedActor)
+{
+	if (!IsValid(RemovedActor))
+	{
+		return;
+	}
+
+	// Only notify the users that injected onto this actor (the asset's own blackboard has no users)
+	TArray<TObjectKey<UObject>, TInlineAllocator<1>> ActorUsers;
+	if (!InjectedActorUsers.RemoveAndCopyValue(RemovedActor, ActorUsers))
+	{
+		return;
+	}
+
+	for (const TObjectKey<UObject>& UserKey : ActorUsers)
+	{
+		const FInjectComponentsManagerUser* ManagerUser = InjectComponentsManagerUsers.Find(UserKey);
+		if (!ManagerUser)
+		{
+			continue;
+		}
+
+		// Copied, because the user may release the manager in response
+		const FAIFlowOnBeforeInjectedActorRemoved OnBeforeActorRemoved = ManagerUser->OnBeforeActorRemoved;
+		OnBeforeActorRemoved.ExecuteIfBound(RemovedActor);
+	}
 }
 
 void UAIFlowAsset::SetKeySelfOnBlackboardComponent(UBlackboardComponent* BlackboardComp) const
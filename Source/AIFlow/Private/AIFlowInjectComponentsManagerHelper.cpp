@@ -0,0 +1,78 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "AIFlowInjectComponentsManagerHelper.h"
+#include "AIFlowAsset.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Nodes/FlowNodeBase.h"
+#include "Types/FlowInjectComponentsManager.h"
+
+void FAIFlowInjectComponentsManagerHelper::EnsureManager(UFlowNodeBase& User, TObjectPtr<UFlowInjectComponentsManager>& InOutManager, const FName& OnBeforeActorRemovedFunctionName)
+{
+	if (IsValid(InOutManager))
+	{
+		return;
+	}
+
+	// Prefer the flow instance's shared manager, so that injected actors are tracked once per flow instance
+	if (UAIFlowAsset* AIFlowAsset = Cast<UAIFlowAsset>(User.GetFlowAsset()))
+	{
+		InOutManager = AIFlowAsset->AcquireInjectComponentsManager(
+			User,
+			FAIFlowOnBeforeInjectedActorRemoved::CreateUFunction(&User, OnBeforeActorRemovedFunctionName));
+
+		return;
+	}
+
+	InOutManager = NewObject<UFlowInjectComponentsManager>(&User);
+
+	InOutManager->InitializeRuntime();
+
+	FScriptDelegate OnBeforeActorRemoved;
+	OnBeforeActorRemoved.BindUFunction(&User, OnBeforeActorRemovedFunctionName);
+	InOutManager->BeforeActorRemovedDelegate.Add(OnBeforeActorRemoved);
+}
+
+void FAIFlowInjectComponentsManagerHelper::CleanupManager(UFlowNodeBase& User, TObjectPtr<UFlowInjectComponentsManager>& InOutManager, const FName& OnBeforeActorRemovedFunctionName)
+{
+	if (IsValid(InOutManager))
+	{
+		// Only a manager that EnsureManager created for the User is shut down,
+		// a shared manager is released to the flow instance that owns it (and shut down by it)
+		if (InOutManager->GetOuter() == &User)
+		{
+			InOutManager->ShutdownRuntime();
+			InOutManager->BeforeActorRemovedDelegate.Remove(&User, OnBeforeActorRemovedFunctionName);
+		}
+		else if (UAIFlowAsset* OwningAIFlowAsset = Cast<UAIFlowAsset>(InOutManager->GetOuter()))
+		{
+			OwningAIFlowAsset->ReleaseInjectComponentsManager(User);
+		}
+	}
+
+	InOutManager = nullptr;
+}
+
+void FAIFlowInjectComponentsManagerHelper::NoteInjectedActor(const UFlowNodeBase& User, const UFlowInjectComponentsManager* Manager, AActor& Actor)
+{
+	if (!IsValid(Manager))
+	{
+		return;
+	}
+
+	// A manager that the User owns only reports the User's own actors
+	UAIFlowAsset* AIFlowAsset = Cast<UAIFlowAsset>(Manager->GetOuter());
+	if (IsValid(AIFlowAsset))
+	{
+		AIFlowAsset->RegisterInjectedActorUser(User, Actor);
+	}
+}
+
+void FAIFlowInjectComponentsManagerHelper::NoteInjectedBlackboardComponentOwner(const UFlowNodeBase& User, const UFlowInjectComponentsManager* Manager, const UBlackboardComponent* BlackboardComponent)
+{
+	// The blackboard may have been injected onto the actor's controller, rather than the actor itself
+	AActor* OwnerActor = IsValid(BlackboardComponent) ? BlackboardComponent->GetOwner() : nullptr;
+	if (IsValid(OwnerActor))
+	{
+		NoteInjectedActor(User, Manager, *OwnerActor);
+	}
+}
@@ -1,6 +1,8 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "AIFlowModule.h"
+#include "Blackboard/AIFlowBlackboardEntryValueRegistry.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
 
 #include "Modules/ModuleManager.h"
 
@@ -8,10 +10,14 @@
 
 void FAIFlowModule::StartupModule()
 {
+	FAIFlowBlackboardKeyTable::StartupKeyTables();
+	FAIFlowBlackboardEntryValueRegistry::StartupRegistry();
 }
 
 void FAIFlowModule::ShutdownModule()
 {
+	FAIFlowBlackboardEntryValueRegistry::ShutdownRegistry();
+	FAIFlowBlackboardKeyTable::ShutdownKeyTables();
 }
 
 #undef LOCTEXT_NAMESPACE
@@ -0,0 +1,209 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "AIFlowPredicateEvaluationContext.h"
+#include "AIFlowStats.h"
+#include "Nodes/FlowNode.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Predicate Context Shared Blackboard Resolves"), STAT_AIFlow_PredicateContextSharedResolves, STATGROUP_AIFlow);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Predicate Context Shared Key Values"), STAT_AIFlow_PredicateContextSharedKeyValues, STATGROUP_AIFlow);
+
+namespace AIFlowPredicateEvaluationContext_Private
+{
+	struct FImplicitContext
+	{
+		TUniquePtr<FAIFlowPredicateEvaluationContext> Context;
+
+		// Predicates that have resolved in the Context (one resolving again starts the next pass)
+		TArray<TObjectKey<UFlowNodeBase>, TInlineAllocator<4>> ResolvedPredicates;
+	};
+
+	// Implicit contexts for the nodes evaluated in ImplicitContextsFrame (all are discarded on the next frame)
+	TMap<TObjectKey<UFlowNode>, FImplicitContext> ImplicitContexts;
+	uint64 ImplicitContextsFrame = 0;
+}
+
+TArray<FAIFlowPredicateEvaluationContext*>& FAIFlowPredicateEvaluationContext::GetActiveContexts()
+{
+	static TArray<FAIFlowPredicateEvaluationContext*> ActiveContexts;
+	return ActiveContexts;
+}
+
+const UFlowNode* FAIFlowPredicateEvaluationContext::GetOwningFlowNode(const UFlowNodeBase& FlowNodeBase)
+{
+	// Add-ons are (possibly nested) subobjects of their node
+	const UFlowNode* OwningFlowNode = Cast<UFlowNode>(&FlowNodeBase);
+	return OwningFlowNode ? OwningFlowNode : FlowNodeBase.GetTypedOuter<UFlowNode>();
+}
+
+FAIFlowPredicateEvaluationContext* FAIFlowPredicateEvaluationContext::FindActiveContext(const UFlowNodeBase& FlowNodeBase)
+{
+	const TArray<FAIFlowPredicateEvaluationContext*>& ActiveContexts = GetActiveContexts();
+	if (ActiveContexts.IsEmpty() || !IsInGameThread())
+	{
+		return nullptr;
+	}
+
+	const UFlowNode* OwningFlowNode = GetOwningFlowNode(FlowNodeBase);
+
+	for (int32 Index = ActiveContexts.Num() - 1; Index >= 0; --Index)
+	{
+		if (ActiveContexts[Index]->FlowNode == OwningFlowNode)
+		{
+			return ActiveContexts[Index];
+		}
+	}
+
+	return nullptr;
+}
+
+FAIFlowCachedBlackboardReference FAIFlowPredicateEvaluationContext::ResolveBlackboard(const UFlowNodeBase& FlowNodeBase, UBlackboardData* OptionalSpecificBlackboardData, EActorBlackboardSearchRule SpecificBlackboardSearchRule)
+{
+	const TObjectKey<UBlackboardData> SpecificBlackboardDataKey(OptionalSpecificBlackboardData);
+
+	for (const FResolvedBlackboard& ResolvedBlackboard : ResolvedBlackboards)
+	{
+		if (ResolvedBlackboard.SpecificBlackboardData == SpecificBlackboardDataKey && ResolvedBlackboard.SpecificBlackboardSearchRule == SpecificBlackboardSearchRule)
+		{
+			++NumSharedBlackboardResolves;
+			INC_DWORD_STAT(STAT_AIFlow_PredicateContextSharedResolves);
+
+			return ResolvedBlackboard.CachedBlackboard;
+		}
+	}
+
+	FResolvedBlackboard& ResolvedBlackboard = ResolvedBlackboards.AddDefaulted_GetRef();
+	ResolvedBlackboard.SpecificBlackboardData = SpecificBlackboardDataKey;
+	ResolvedBlackboard.SpecificBlackboardSearchRule = SpecificBlackboardSearchRule;
+	ResolvedBlackboard.CachedBlackboard = FAIFlowCachedBlackboardReference(FlowNodeBase, OptionalSpecificBlackboardData, SpecificBlackboardSearchRule);
+
+	return ResolvedBlackboard.CachedBlackboard;
+}
+
+FAIFlowCachedBlackboardReference FAIFlowPredicateEvaluationContext::ResolveBlackboardForPredicate(const UFlowNodeBase& FlowNodeBase, UBlackboardData* OptionalSpecificBlackboardData, EActorBlackboardSearchRule SpecificBlackboardSearchRule)
+{
+	FAIFlowPredicateEvaluationContext* EvaluationContext = FindActiveContext(FlowNodeBase);
+	if (!EvaluationContext)
+	{
+		EvaluationContext = FindOrRenewImplicitContext(FlowNodeBase);
+	}
+
+	if (EvaluationContext)
+	{
+		return EvaluationContext->ResolveBlackboard(FlowNodeBase, OptionalSpecificBlackboardData, SpecificBlackboardSearchRule);
+	}
+
+	return FAIFlowCachedBlackboardReference(FlowNodeBase, OptionalSpecificBlackboardData, SpecificBlackboardSearchRule);
+}
+
+FAIFlowPredicateEvaluationContext* FAIFlowPredicateEvaluationContext::FindOrRenewImplicitContext(const UFlowNodeBase& FlowNodeBase)
+{
+	using namespace AIFlowPredicateEvaluationContext_Private;
+
+	if (!IsInGameThread())
+	{
+		return nullptr;
+	}
+
+	const UFlowNode* OwningFlowNode = GetOwningFlowNode(FlowNodeBase);
+	if (!OwningFlowNode)
+	{
+		return nullptr;
+	}
+
+	// Only the current frame's contexts are kept, so a blackboard resolved on an earlier frame is never reused
+	if (ImplicitContextsFrame != GFrameCounter)
+	{
+		ImplicitContexts.Reset();
+		ImplicitContextsFrame = GFrameCounter;
+	}
+
+	FImplicitContext& ImplicitContext = ImplicitContexts.FindOrAdd(OwningFlowNode);
+
+	// A predicate resolving again means the node has started another evaluation pass
+	const TObjectKey<UFlowNodeBase> PredicateKey(&FlowNodeBase);
+	if (!ImplicitContext.Context.IsValid() || ImplicitContext.ResolvedPredicates.Contains(PredicateKey))
+	{
+		ImplicitContext.Context = MakeUnique<FAIFlowPredicateEvaluationContext>(*OwningFlowNode);
+		ImplicitContext.ResolvedPredicates.Reset();
+	}
+
+	ImplicitContext.ResolvedPredicates.Add(PredicateKey);
+
+	return ImplicitContext.Context.Get();
+}
+
+bool FAIFlowPredicateEvaluationContext::TryGetNumericalValue(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, int32& OutIntValue, float& OutFloatValue)
+{
+	const TObjectKey<UBlackboardComponent> BlackboardComponentKey(&BlackboardComponent);
+
+	for (const FGatheredKeyValue& GatheredKeyValue : GatheredKeyValues)
+	{
+		if (GatheredKeyValue.KeyID == KeyID && GatheredKeyValue.BlackboardComponent == BlackboardComponentKey)
+		{
+			++NumSharedKeyValues;
+			INC_DWORD_STAT(STAT_AIFlow_PredicateContextSharedKeyValues);
+
+			OutIntValue = GatheredKeyValue.IntValue;
+			OutFloatValue = GatheredKeyValue.FloatValue;
+
+			return GatheredKeyValue.bIsValid;
+		}
+	}
+
+	FGatheredKeyValue& GatheredKeyValue = GatheredKeyValues.AddDefaulted_GetRef();
+	GatheredKeyValue.BlackboardComponent = BlackboardComponentKey;
+	GatheredKeyValue.KeyID = KeyID;
+
+	const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+	const FBlackboardEntry* BlackboardEntry = BlackboardData ? BlackboardData->GetKey(KeyID) : nullptr;
+	const uint8* RawData = BlackboardEntry ? BlackboardComponent.GetKeyRawData(KeyID) : nullptr;
+
+	if (RawData)
+	{
+		if (const UBlackboardKeyType_Float* FloatKeyType = Cast<UBlackboardKeyType_Float>(BlackboardEntry->KeyType))
+		{
+			GatheredKeyValue.FloatValue = UBlackboardKeyType_Float::GetValue(FloatKeyType, RawData);
+			GatheredKeyValue.IntValue = FMath::FloorToInt32(GatheredKeyValue.FloatValue);
+			GatheredKeyValue.bIsValid = true;
+		}
+		else if (const UBlackboardKeyType_Int* IntKeyType = Cast<UBlackboardKeyType_Int>(BlackboardEntry->KeyType))
+		{
+			GatheredKeyValue.IntValue = UBlackboardKeyType_Int::GetValue(IntKeyType, RawData);
+			GatheredKeyValue.FloatValue = static_cast<float>(GatheredKeyValue.IntValue);
+			GatheredKeyValue.bIsValid = true;
+		}
+		else if (const UBlackboardKeyType_Enum* EnumKeyType = Cast<UBlackboardKeyType_Enum>(BlackboardEntry->KeyType))
+		{
+			GatheredKeyValue.IntValue = UBlackboardKeyType_Enum::GetValue(EnumKeyType, RawData);
+			GatheredKeyValue.FloatValue = static_cast<float>(GatheredKeyValue.IntValue);
+			GatheredKeyValue.bIsValid = true;
+		}
+	}
+
+	OutIntValue = GatheredKeyValue.IntValue;
+	OutFloatValue = GatheredKeyValue.FloatValue;
+
+	return GatheredKeyValue.bIsValid;
+}
+
+FAIFlowScopedPredicateEvaluationContext::FAIFlowScopedPredicateEvaluationContext(const UFlowNode& FlowNode)
+	: Context(FlowNode)
+{
+	check(IsInGameThread());
+
+	FAIFlowPredicateEvaluationContext::GetActiveContexts().Push(&Context);
+}
+
+FAIFlowScopedPredicateEvaluationContext::~FAIFlowScopedPredicateEvaluationContext()
+{
+	TArray<FAIFlowPredicateEvaluationContext*>& ActiveContexts = FAIFlowPredicateEvaluationContext::GetActiveContexts();
+	check(!ActiveContexts.IsEmpty() && ActiveContexts.Last() == &Context);
+
+	ActiveContexts.Pop(EAllowShrinking::No);
+}
@@ -1,12 +1,18 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "AddOns/AIFlowNodeAddOn.h"
-#include "FlowAsset.h"
+#include "AIFlowAsset.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowNodeAddOn)
 
 UBlackboardComponent* UAIFlowNodeAddOn::GetBlackboardComponent() const
 {
+	// Accessing the flow instance's blackboard creates it, if its creation was deferred
+	if (UAIFlowAsset* AIFlowAsset = Cast<UAIFlowAsset>(GetFlowAsset()))
+	{
+		return AIFlowAsset->EnsureBlackboardComponent();
+	}
+
 	if (IFlowBlackboardInterface* FlowBlackboardInterface = Cast<IFlowBlackboardInterface>(GetFlowAsset()))
 	{
 		return FlowBlackboardInterface->GetBlackboardComponent();
@@ -5,6 +5,8 @@
 #include "Blackboard/FlowBlackboardEntryValue.h"
 #include "Types/FlowInjectComponentsManager.h"
 #include "AIFlowAsset.h"
+#include "AIFlowInjectComponentsManagerHelper.h"
+#include "Engine/World.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNodeAddOn_ConfigureSpawnedActorBlackboard)
 
@@ -15,10 +17,20 @@ UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::UFlowNodeAddOn_ConfigureSpawnedA
 
 void UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::FinishedSpawningActor_Implementation(AActor* SpawnedActor, UFlowNodeBase* SpawningNodeOrAddOn)
 {
-	UBlackboardComponent* BlackboardComponent = TryEnsureBlackboardComponentToApplyTo(SpawnedActor, SpawningNodeOrAddOn);
+	SpawnedActorScratch.Reset();
+	if (IsValid(SpawnedActor))
+	{
+		SpawnedActorScratch.Add(SpawnedActor);
+	}
+
+	const bool bIsMassAgent = (QueueBlackboardOptionsForMassAgents(SpawnedActorScratch) > 0);
+	SpawnedActorScratch.Reset();
+
+	UBlackboardComponent* BlackboardComponent = bIsMassAgent ? nullptr : TryEnsureBlackboardComponentToApplyTo(SpawnedActor, SpawningNodeOrAddOn);
 
 	if (IsValid(BlackboardComponent))
 	{
+		ActorBlackboardHelper.SetAssignmentSeed(GetRandomSeed());
 		ActorBlackboardHelper.ApplyBlackboardOptionsToBlackboardComponent(
 			*BlackboardComponent,
 			PerActorOptionsAssignmentMethod,
@@ -29,6 +41,76 @@ void UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::FinishedSpawningActor_Imple
 	Super::FinishedSpawningActor_Implementation(SpawnedActor, SpawningNodeOrAddOn);
 }
 
+void UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::FinishedSpawningActors(TArrayView<AActor* const> SpawnedActors, UFlowNodeBase* SpawningNodeOrAddOn)
+{
+	if (!CanUseBatchedSpawnPath(*UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::StaticClass()))
+	{
+		IFlowPerSpawnedActorInterface::FinishedSpawningActors(SpawnedActors, SpawningNodeOrAddOn);
+
+		return;
+	}
+
+	// Spawned Mass agents have their options queued for their blackboard fragments, the rest are applied to blackboard components
+	TArray<AActor*> SpawnedComponentActors(SpawnedActors.GetData(), SpawnedActors.Num());
+	(void) QueueBlackboardOptionsForMassAgents(SpawnedComponentActors);
+
+	TArray<UBlackboardComponent*, TInlineAllocator<16>> BlackboardComponents;
+	BlackboardComponents.Reserve(SpawnedComponentActors.Num());
+
+	// Resolve the manager and the component class once for the whole batch, rather than per actor
+	// (CanUseBatchedSpawnPath has ruled out native overrides of TryEnsureBlackboardComponentToApplyTo)
+	const bool bMayInjectComponent = EActorBlackboardInjectRule_Classifiers::NeedsInjectComponentsManager(InjectRule);
+	if (bMayInjectComponent && !SpawnedComponentActors.IsEmpty())
+	{
+		EnsureInjectComponentsManager();
+	}
+
+	const TSubclassOf<UBlackboardComponent> BlackboardComponentClass = GetBlackboardComponentClassToInject();
+
+	for (AActor* SpawnedActor : SpawnedComponentActors)
+	{
+		if (IsValid(SpawnedActor))
+		{
+			BlackboardComponents.Add(FindOrAddBlackboardComponentOnSpawnedActor(*SpawnedActor, BlackboardComponentClass, bMayInjectComponent));
+		}
+	}
+
+	ActorBlackboardHelper.SetAssignmentSeed(GetRandomSeed());
+	ActorBlackboardHelper.ApplyBlackboardOptionsToBlackboardComponents(
+		BlackboardComponents,
+		PerActorOptionsAssignmentMethod,
+		EntriesForEveryActor,
+		&PerActorOptions);
+
+	for (AActor* SpawnedActor : SpawnedActors)
+	{
+		Super::FinishedSpawningActor_Implementation(SpawnedActor, SpawningNodeOrAddOn);
+	}
+}
+
+int32 UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::QueueBlackboardOptionsForMassAgents(TArray<AActor*>& InOutSpawnedActors)
+{
+	UWorld* World = GetWorld();
+	if (!IsValid(World) || InOutSpawnedActors.IsEmpty())
+	{
+		return 0;
+	}
+
+	// Mass agents without a blackboard are given one for the expected blackboard, if the InjectRule allows it
+	const bool bMayInjectBlackboard = EActorBlackboardInjectRule_Classifiers::NeedsInjectComponentsManager(InjectRule);
+	const UBlackboardData* BlackboardDataToInject = bMayInjectBlackboard ? GetBlackboardAsset() : nullptr;
+
+	ActorBlackboardHelper.SetAssignmentSeed(GetRandomSeed());
+
+	return ActorBlackboardHelper.ExtractAndQueueBlackboardOptionsForMassAgents(
+		*World,
+		InOutSpawnedActors,
+		PerActorOptionsAssignmentMethod,
+		EntriesForEveryActor,
+		&PerActorOptions,
+		BlackboardDataToInject);
+}
+
 UBlackboardComponent* UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::TryEnsureBlackboardComponentToApplyTo(AActor* SpawnedActor, UFlowNodeBase* SpawningNodeOrAddOn)
 {
 	if (!IsValid(SpawnedActor))
@@ -42,18 +124,15 @@ UBlackboardComponent* UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::TryEnsureB
 		EnsureInjectComponentsManager();
 	}
 
-	// Get the BlackboardComponentClass to use from the FlowAsset
-	TSubclassOf<UBlackboardComponent> BlackboardComponentClass = UBlackboardComponent::StaticClass();
-	UAIFlowAsset* AIFlowAsset = Cast<UAIFlowAsset>(GetFlowAsset());
-	if (IsValid(AIFlowAsset))
-	{
-		BlackboardComponentClass = AIFlowAsset->GetBlackboardComponentClass();
-	}
+	return FindOrAddBlackboardComponentOnSpawnedActor(*SpawnedActor, GetBlackboardComponentClassToInject(), bMayInjectComponent);
+}
 
+UBlackboardComponent* UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::FindOrAddBlackboardComponentOnSpawnedActor(AActor& SpawnedActor, TSubclassOf<UBlackboardComponent> BlackboardComponentClass, bool bMayInjectComponent)
+{
 	// Find or add the blackboard component
 	UBlackboardComponent* BlackboardComponent = 
 		FAIFlowActorBlackboardHelper::FindOrAddBlackboardComponentOnActor(
-			*SpawnedActor,
+			SpawnedActor,
 			InjectComponentsManager,
 			BlackboardComponentClass,
 			ExpectedBlackboardData,
@@ -63,13 +142,33 @@ UBlackboardComponent* UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::TryEnsureB
 	// Start monitoring the actor, if we (potentially) injected a blackboard component
 	if (bMayInjectComponent)
 	{
+		FAIFlowInjectComponentsManagerHelper::NoteInjectedBlackboardComponentOwner(*this, InjectComponentsManager, BlackboardComponent);
+
 		// Inform subclasses that we are monitoring this Actor
-		OnStartMonitoringActor(*SpawnedActor);
+		OnStartMonitoringActor(SpawnedActor);
 	}
 
 	return BlackboardComponent;
 }
 
+TSubclassOf<UBlackboardComponent> UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::GetBlackboardComponentClassToInject() const
+{
+	// Get the BlackboardComponentClass to use from the FlowAsset
+	if (const UAIFlowAsset* AIFlowAsset = Cast<UAIFlowAsset>(GetFlowAsset()))
+	{
+		return AIFlowAsset->GetBlackboardComponentClass();
+	}
+
+	return UBlackboardComponent::StaticClass();
+}
+
+void UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::ResetInstanceForReuse()
+{
+	Super::ResetInstanceForReuse();
+
+	ActorBlackboardHelper.ResetOptionAssignmentState();
+}
+
 void UFlowNodeAddOn_ConfigureSpawnedActorBlackboard::UpdateNodeConfigText_Implementation()
 {
 #if WITH_EDITOR
@@ -2,7 +2,10 @@
 
 #include "AddOns/FlowNodeAddOn_InjectComponents.h"
 #include "Components/ActorComponent.h"
+#include "Subsystems/AIFlowInjectionQueueSubsystem.h"
+#include "Engine/World.h"
 #include "Types/FlowInjectComponentsManager.h"
+#include "AIFlowInjectComponentsManagerHelper.h"
 #include "GameFramework/Actor.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNodeAddOn_InjectComponents)
@@ -17,23 +20,120 @@ void UFlowNodeAddOn_InjectComponents::FinishedSpawningActor_Implementation(AActo
 	// It is possible to fail spawning, and we will still get a nullptr call to this function
 	// (in case the AddOn is simply counting spawn attempts, etc.)
 
-	if (IsValid(SpawnedActor))
+	if (IsValid(SpawnedActor) && HasComponentsToInject())
 	{
-		const TArray<UActorComponent*> ComponentInstances = InjectComponentsHelper.CreateComponentInstancesForActor(*SpawnedActor);
-		if (!ComponentInstances.IsEmpty())
+		if (UAIFlowInjectionQueueSubsystem* InjectionQueue = FindInjectionQueue())
 		{
-			EnsureInjectComponentsManager();
+			// Notified once the components are injected (see FinishQueuedInjection)
+			InjectionQueue->EnqueueInjection(*SpawnedActor, *this, SpawningFlowNodeBase);
 
-			InjectComponentsManager->InjectComponentsOnActor(*SpawnedActor, ComponentInstances);
-
-			// Inform subclasses that we are monitoring this Actor
-			OnStartMonitoringActor(*SpawnedActor);
+			return;
 		}
+
+		InjectComponentsOnActorNow(*SpawnedActor);
 	}
 
 	Super::FinishedSpawningActor_Implementation(SpawnedActor, SpawningFlowNodeBase);
 }
 
+void UFlowNodeAddOn_InjectComponents::FinishedSpawningActors(TArrayView<AActor* const> SpawnedActors, UFlowNodeBase* SpawningFlowNodeBase)
+{
+	if (!CanUseBatchedSpawnPath(*UFlowNodeAddOn_InjectComponents::StaticClass()))
+	{
+		IFlowPerSpawnedActorInterface::FinishedSpawningActors(SpawnedActors, SpawningFlowNodeBase);
+
+		return;
+	}
+
+	const bool bHasComponentsToInject = HasComponentsToInject();
+
+	// Resolve the injection queue and the manager once for the whole batch, rather than per actor
+	UAIFlowInjectionQueueSubsystem* InjectionQueue = bHasComponentsToInject ? FindInjectionQueue() : nullptr;
+	if (bHasComponentsToInject && !InjectionQueue)
+	{
+		EnsureInjectComponentsManager();
+	}
+
+	UFlowInjectComponentsManager* Manager = InjectComponentsManager;
+
+	for (AActor* SpawnedActor : SpawnedActors)
+	{
+		if (bHasComponentsToInject && IsValid(SpawnedActor))
+		{
+			if (InjectionQueue)
+			{
+				// Notified once the components are injected (see FinishQueuedInjection)
+				InjectionQueue->EnqueueInjection(*SpawnedActor, *this, SpawningFlowNodeBase);
+
+				continue;
+			}
+
+			if (IsValid(Manager))
+			{
+				InjectComponentsOnActorWithManager(*SpawnedActor, *Manager);
+			}
+		}
+
+		Super::FinishedSpawningActor_Implementation(SpawnedActor, SpawningFlowNodeBase);
+	}
+}
+
+void UFlowNodeAddOn_InjectComponents::DeinitializeInstance()
+{
+	if (UAIFlowInjectionQueueSubsystem* InjectionQueue = FindInjectionQueue())
+	{
+		InjectionQueue->CancelRequestsFrom(*this);
+	}
+
+	Super::DeinitializeInstance();
+}
+
+void UFlowNodeAddOn_InjectComponents::FinishQueuedInjection(AActor& SpawnedActor, UFlowNodeBase* SpawningFlowNodeBase)
+{
+	InjectComponentsOnActorNow(SpawnedActor);
+
+	Super::FinishedSpawningActor_Implementation(&SpawnedActor, SpawningFlowNodeBase);
+}
+
+void UFlowNodeAddOn_InjectComponents::InjectComponentsOnActorNow(AActor& SpawnedActor)
+{
+	EnsureInjectComponentsManager();
+
+	if (IsValid(InjectComponentsManager))
+	{
+		InjectComponentsOnActorWithManager(SpawnedActor, *InjectComponentsManager);
+	}
+}
+
+void UFlowNodeAddOn_InjectComponents::InjectComponentsOnActorWithManager(AActor& SpawnedActor, UFlowInjectComponentsManager& Manager)
+{
+	const TArray<UActorComponent*> ComponentInstances = InjectComponentsHelper.CreateComponentInstancesForActor(SpawnedActor);
+	if (!ComponentInstances.IsEmpty())
+	{
+		Manager.InjectComponentsOnActor(SpawnedActor, ComponentInstances);
+		FAIFlowInjectComponentsManagerHelper::NoteInjectedActor(*this, &Manager, SpawnedActor);
+
+		// Inform subclasses that we are monitoring this Actor
+		OnStartMonitoringActor(SpawnedActor);
+	}
+}
+
+UAIFlowInjectionQueueSubsystem* UFlowNodeAddOn_InjectComponents::FindInjectionQueue() const
+{
+	if (!bUseInjectionQueue)
+	{
+		return nullptr;
+	}
+
+	const UWorld* World = GetWorld();
+	return IsValid(World) ? World->GetSubsystem<UAIFlowInjectionQueueSubsystem>() : nullptr;
+}
+
+bool UFlowNodeAddOn_InjectComponents::HasComponentsToInject() const
+{
+	return !InjectComponentsHelper.ComponentTemplates.IsEmpty() || !InjectComponentsHelper.ComponentClasses.IsEmpty();
+}
+
 void UFlowNodeAddOn_InjectComponents::UpdateNodeConfigText_Implementation()
 {
 #if WITH_EDITOR
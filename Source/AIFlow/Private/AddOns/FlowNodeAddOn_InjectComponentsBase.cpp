@@ -3,6 +3,8 @@
 #include "AddOns/FlowNodeAddOn_InjectComponentsBase.h"
 #include "Components/ActorComponent.h"
 #include "Types/FlowInjectComponentsManager.h"
+#include "AIFlowAsset.h"
+#include "AIFlowInjectComponentsManagerHelper.h"
 #include "GameFramework/Actor.h"
 #include "AIFlowLogChannels.h"
 
@@ -19,27 +21,12 @@ UFlowNodeAddOn_InjectComponentsBase::UFlowNodeAddOn_InjectComponentsBase()
 
 void UFlowNodeAddOn_InjectComponentsBase::EnsureInjectComponentsManager()
 {
-	if (IsValid(InjectComponentsManager))
-	{
-		return;
-	}
-
-	InjectComponentsManager = NewObject<UFlowInjectComponentsManager>(this);
-
-	InjectComponentsManager->InitializeRuntime();
-	InjectComponentsManager->BeforeActorRemovedDelegate.AddDynamic(this, &UFlowNodeAddOn_InjectComponentsBase::OnBeforeActorRemoved);
+	FAIFlowInjectComponentsManagerHelper::EnsureManager(*this, InjectComponentsManager, GET_FUNCTION_NAME_CHECKED(UFlowNodeAddOn_InjectComponentsBase, OnBeforeActorRemoved));
 }
 
 void UFlowNodeAddOn_InjectComponentsBase::CleanupInjectComponentsManager()
 {
-	if (IsValid(InjectComponentsManager))
-	{
-		InjectComponentsManager->ShutdownRuntime();
-
-		InjectComponentsManager->BeforeActorRemovedDelegate.RemoveDynamic(this, &UFlowNodeAddOn_InjectComponentsBase::OnBeforeActorRemoved);
-	}
-
-	InjectComponentsManager = nullptr;
+	FAIFlowInjectComponentsManagerHelper::CleanupManager(*this, InjectComponentsManager, GET_FUNCTION_NAME_CHECKED(UFlowNodeAddOn_InjectComponentsBase, OnBeforeActorRemoved));
 }
 
 void UFlowNodeAddOn_InjectComponentsBase::DeinitializeInstance()
@@ -57,6 +44,17 @@ void UFlowNodeAddOn_InjectComponentsBase::OnBeforeActorRemoved(AActor* RemovedAc
 	}
 }
 
+bool UFlowNodeAddOn_InjectComponentsBase::CanUseBatchedSpawnPath(const UClass& BatchingClass) const
+{
+	const UClass* NativeClass = GetClass();
+	while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+
+	return NativeClass == &BatchingClass;
+}
+
 void UFlowNodeAddOn_InjectComponentsBase::FinishedSpawningActor_Implementation(AActor* SpawnedActor, UFlowNodeBase* SpawningFlowNodeBase)
 {
 }
@@ -0,0 +1,218 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "AddOns/FlowNodeAddOn_PredicateBlackboardDistance.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "AIFlowPredicateEvaluationContext.h"
+#include "FlowSettings.h"
+#include "Mass/AIFlowMassBlackboardFragment.h"
+#include "Mass/AIFlowMassBlackboardSubsystem.h"
+
+#include "AISystem.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+
+#define LOCTEXT_NAMESPACE "FlowNodeAddOn_PredicateBlackboardDistance"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNodeAddOn_PredicateBlackboardDistance)
+
+UFlowNodeAddOn_PredicateBlackboardDistance::UFlowNodeAddOn_PredicateBlackboardDistance()
+	: Super()
+{
+#if WITH_EDITOR
+	NodeDisplayStyle = FlowNodeStyle::AddOn_Predicate;
+	Category = TEXT("Blackboard");
+#endif
+}
+
+#if WITH_EDITOR
+
+FText UFlowNodeAddOn_PredicateBlackboardDistance::K2_GetNodeTitle_Implementation() const
+{
+	if (KeyA.GetKeyName().IsNone() || !GetDefault<UFlowSettings>()->bUseAdaptiveNodeTitles)
+	{
+		return Super::K2_GetNodeTitle_Implementation();
+	}
+
+	FText LocationB;
+	switch (SourceB)
+	{
+	case EAIFlowDistanceOperandSource::BlackboardKey:
+		LocationB = FText::FromName(KeyB.GetKeyName());
+		break;
+	case EAIFlowDistanceOperandSource::OwnerActor:
+		LocationB = LOCTEXT("OwnerActorLocation", "Owner");
+		break;
+	default:
+		// Quoting "" the explicit location, as the compare predicate does for explicit values
+		LocationB = FText::FromString(TEXT("\"") + ExplicitLocationB.ToCompactString() + TEXT("\""));
+		break;
+	}
+
+	const FText CompareText = (Compare == EAIFlowDistanceCompare::WithinRadius) ? LOCTEXT("WithinRadius", "within") : LOCTEXT("OutsideRadius", "outside");
+
+	return FText::Format(LOCTEXT("BlackboardDistanceTitle", "{0} {1} {2} of {3}"), { FText::FromName(KeyA.GetKeyName()), CompareText, FText::AsNumber(Radius), LocationB });
+}
+
+UBlackboardData* UFlowNodeAddOn_PredicateBlackboardDistance::GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const
+{
+	if (IsValid(SpecificBlackboardAsset))
+	{
+		return SpecificBlackboardAsset;
+	}
+
+	return Super::GetBlackboardAssetForPropertyHandle(PropertyHandle);
+}
+
+#endif // WITH_EDITOR
+
+bool UFlowNodeAddOn_PredicateBlackboardDistance::EvaluatePredicate_Implementation() const
+{
+	FVector LocationA = FVector::ZeroVector;
+	FVector LocationB = FVector::ZeroVector;
+
+	const bool bNeedsKeyB = (SourceB == EAIFlowDistanceOperandSource::BlackboardKey);
+	if (!bNeedsKeyB && !TryGetNonKeyLocationB(LocationB))
+	{
+		return false;
+	}
+
+	// Share the resolved blackboard with the node's other predicates, if they are being evaluated together
+	const FAIFlowCachedBlackboardReference CachedBlackboard =
+		FAIFlowPredicateEvaluationContext::ResolveBlackboardForPredicate(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+
+	if (CachedBlackboard.IsValid())
+	{
+		const UBlackboardComponent& BlackboardComponent = *CachedBlackboard.BlackboardComponent;
+
+		if (!TryGetKeyLocation(BlackboardComponent, KeyA, LocationA) ||
+			(bNeedsKeyB && !TryGetKeyLocation(BlackboardComponent, KeyB, LocationB)))
+		{
+			return false;
+		}
+	}
+	else if (const FAIFlowMassBlackboardFragment* MassBlackboardFragment = UAIFlowMassBlackboardSubsystem::FindBlackboardFragmentForActorInWorld(GetWorld(), TryGetRootFlowActorOwner(), SpecificBlackboardAsset))
+	{
+		if (!TryGetKeyLocation(*MassBlackboardFragment, KeyA, LocationA) ||
+			(bNeedsKeyB && !TryGetKeyLocation(*MassBlackboardFragment, KeyB, LocationB)))
+		{
+			return false;
+		}
+	}
+	else
+	{
+		LogError(TEXT("Cannot EvaluatePredicate on a blackboard distance without a Blackboard Component or Asset"));
+
+		return false;
+	}
+
+	return FAIFlowDistanceBatch::TestPair(LocationA, LocationB, Compare, Radius, bIgnoreZ);
+}
+
+FAIFlowCachedBlackboardReference UFlowNodeAddOn_PredicateBlackboardDistance::ResolveBlackboardForEvaluation() const
+{
+	return FAIFlowCachedBlackboardReference(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+}
+
+bool UFlowNodeAddOn_PredicateBlackboardDistance::TryEvaluateBatch(const UBlackboardData& BlackboardData, TConstArrayView<const UBlackboardComponent*> BlackboardComponents, TArray<bool>& OutResults) const
+{
+	if (!CanEvaluateAsBatch() || !FAISystem::IsValidLocation(ExplicitLocationB))
+	{
+		return false;
+	}
+
+	// Object keys need their actors' locations (and invalid keys report their errors), so they are evaluated individually
+	const FAIFlowBlackboardKeyTableEntry* KeyEntry = FAIFlowBlackboardKeyTable::Get(BlackboardData)->FindEntry(KeyA.GetKeyName());
+	if (!KeyEntry || !KeyEntry->KeyType || !KeyEntry->KeyType->IsA<UBlackboardKeyType_Vector>())
+	{
+		return false;
+	}
+
+	FAIFlowDistanceBatch DistanceBatch;
+	DistanceBatch.Reset(ExplicitLocationB, BlackboardComponents.Num());
+	DistanceBatch.AddBlackboardVectorKeys(BlackboardComponents, KeyEntry->KeyID);
+	DistanceBatch.Test(Compare, Radius, bIgnoreZ, OutResults);
+
+	return true;
+}
+
+bool UFlowNodeAddOn_PredicateBlackboardDistance::TryGetKeyLocation(const UBlackboardComponent& BlackboardComponent, const FFlowBlackboardEntry& Key, FVector& OutLocation) const
+{
+	const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+	const FAIFlowBlackboardKeyTableEntry* KeyEntry = BlackboardData ? FAIFlowBlackboardKeyTable::Get(*BlackboardData)->FindEntry(Key.GetKeyName()) : nullptr;
+	if (!KeyEntry || !KeyEntry->KeyType)
+	{
+		LogError(FString::Printf(TEXT("Blackboard has no key %s for a distance"), *Key.GetKeyName().ToString()));
+
+		return false;
+	}
+
+	if (KeyEntry->KeyType->IsA<UBlackboardKeyType_Vector>())
+	{
+		OutLocation = BlackboardComponent.GetValue<UBlackboardKeyType_Vector>(KeyEntry->KeyID);
+
+		return true;
+	}
+
+	if (KeyEntry->KeyType->IsA<UBlackboardKeyType_Object>())
+	{
+		// An empty (or non-Actor) Object key has no location, which fails the predicate without an error
+		const AActor* Actor = Cast<AActor>(BlackboardComponent.GetValue<UBlackboardKeyType_Object>(KeyEntry->KeyID));
+		if (!IsValid(Actor))
+		{
+			return false;
+		}
+
+		OutLocation = Actor->GetActorLocation();
+
+		return true;
+	}
+
+	LogError(FString::Printf(TEXT("Key %s must be a Vector key or an Object key (holding an Actor) for a distance"), *Key.GetKeyName().ToString()));
+
+	return false;
+}
+
+bool UFlowNodeAddOn_PredicateBlackboardDistance::TryGetKeyLocation(const FAIFlowMassBlackboardFragment& MassBlackboardFragment, const FFlowBlackboardEntry& Key, FVector& OutLocation) const
+{
+	// Mass blackboards only store the plain-old-data key types, so only Vector keys have locations
+	const FBlackboard::FKey KeyID = MassBlackboardFragment.GetKeyID(Key.GetKeyName());
+	const UBlackboardKeyType* KeyType = MassBlackboardFragment.GetKeyType(KeyID);
+	if (!KeyType || !KeyType->IsA<UBlackboardKeyType_Vector>())
+	{
+		LogError(FString::Printf(TEXT("Key %s must be a Vector key for a distance on a Mass blackboard"), *Key.GetKeyName().ToString()));
+
+		return false;
+	}
+
+	OutLocation = MassBlackboardFragment.GetValue<UBlackboardKeyType_Vector>(KeyID);
+
+	return true;
+}
+
+bool UFlowNodeAddOn_PredicateBlackboardDistance::TryGetNonKeyLocationB(FVector& OutLocation) const
+{
+	if (SourceB == EAIFlowDistanceOperandSource::ExplicitLocation)
+	{
+		OutLocation = ExplicitLocationB;
+
+		return true;
+	}
+
+	const AActor* OwnerActor = TryGetRootFlowActorOwner();
+	if (!IsValid(OwnerActor))
+	{
+		LogError(TEXT("Cannot measure a blackboard distance to the Flow Owner Actor without an owning actor"));
+
+		return false;
+	}
+
+	OutLocation = OwnerActor->GetActorLocation();
+
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,141 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "AddOns/FlowNodeAddOn_PredicateBlackboardExpression.h"
+#include "Blackboard/FlowBlackboardEntryValue.h"
+#include "AIFlowPredicateEvaluationContext.h"
+#include "FlowSettings.h"
+#include "Mass/AIFlowMassBlackboardFragment.h"
+#include "Mass/AIFlowMassBlackboardSubsystem.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Engine/World.h"
+
+#define LOCTEXT_NAMESPACE "FlowNodeAddOn_PredicateBlackboardExpression"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNodeAddOn_PredicateBlackboardExpression)
+
+UFlowNodeAddOn_PredicateBlackboardExpression::UFlowNodeAddOn_PredicateBlackboardExpression()
+	: Super()
+{
+#if WITH_EDITOR
+	NodeDisplayStyle = FlowNodeStyle::AddOn_Predicate;
+	Category = TEXT("Blackboard");
+#endif
+}
+
+#if WITH_EDITOR
+
+void UFlowNodeAddOn_PredicateBlackboardExpression::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	Program.Reset();
+}
+
+FText UFlowNodeAddOn_PredicateBlackboardExpression::K2_GetNodeTitle_Implementation() const
+{
+	if (Clauses.IsEmpty() || !GetDefault<UFlowSettings>()->bUseAdaptiveNodeTitles)
+	{
+		return Super::K2_GetNodeTitle_Implementation();
+	}
+
+	TStringBuilder<256> TitleBuilder;
+
+	for (int32 ClauseIndex = 0; ClauseIndex < Clauses.Num(); ++ClauseIndex)
+	{
+		const FAIFlowBlackboardExpressionClause& Clause = Clauses[ClauseIndex];
+
+		if (ClauseIndex > 0)
+		{
+			TitleBuilder << (Clause.Join == EAIFlowBlackboardExpressionJoin::Or ? TEXT(" OR ") : TEXT(" AND "));
+		}
+
+		if (Clause.bNot)
+		{
+			TitleBuilder << TEXT("NOT ");
+		}
+
+		TitleBuilder << Clause.KeyLeft.GetKeyName() << TEXT(" ") << GetOperatorSymbolString(Clause.OperatorType) << TEXT(" ");
+
+		// Quoting "" the explicit value to make a key/literal comparison visually distinct from a key/key comparison
+		if (Clause.bUseExplicitValueForRightHandSide)
+		{
+			TitleBuilder << TEXT("\"") << (Clause.ExplicitValueRight ? Clause.ExplicitValueRight->GetEditorValueString() : FString(TEXT("<unknown>"))) << TEXT("\"");
+		}
+		else
+		{
+			TitleBuilder << Clause.KeyRight.GetKeyName();
+		}
+	}
+
+	return FText::FromStringView(TitleBuilder.ToView());
+}
+
+UBlackboardData* UFlowNodeAddOn_PredicateBlackboardExpression::GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const
+{
+	if (IsValid(SpecificBlackboardAsset))
+	{
+		return SpecificBlackboardAsset;
+	}
+
+	return Super::GetBlackboardAssetForPropertyHandle(PropertyHandle);
+}
+
+#endif // WITH_EDITOR
+
+bool UFlowNodeAddOn_PredicateBlackboardExpression::EvaluatePredicate_Implementation() const
+{
+	// Share the resolved blackboard with the node's other predicates, if they are being evaluated together
+	const FAIFlowCachedBlackboardReference CachedBlackboard =
+		FAIFlowPredicateEvaluationContext::ResolveBlackboardForPredicate(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+
+	if (CachedBlackboard.IsValid())
+	{
+		if (!EnsureProgramCompiled(*CachedBlackboard.BlackboardData))
+		{
+			return false;
+		}
+
+		return Program.Execute(*CachedBlackboard.BlackboardComponent);
+	}
+
+	if (const FAIFlowMassBlackboardFragment* MassBlackboardFragment = UAIFlowMassBlackboardSubsystem::FindBlackboardFragmentForActorInWorld(GetWorld(), TryGetRootFlowActorOwner(), SpecificBlackboardAsset))
+	{
+		if (!EnsureProgramCompiled(*MassBlackboardFragment->GetBlackboardData()))
+		{
+			return false;
+		}
+
+		return Program.Execute(*MassBlackboardFragment);
+	}
+
+	LogError(TEXT("Cannot EvaluatePredicate on a blackboard expression without a Blackboard Component or Asset"));
+
+	return false;
+}
+
+bool UFlowNodeAddOn_PredicateBlackboardExpression::EnsureProgramCompiled(const UBlackboardData& BlackboardData) const
+{
+	if (Program.IsCompiledFor(BlackboardData))
+	{
+		return true;
+	}
+
+	// The failure was already logged, it is not retried until the clauses are edited or the blackboard keys change
+	if (Program.HasFailedToCompileFor(BlackboardData))
+	{
+		return false;
+	}
+
+	FString CompileError;
+	if (!Program.Compile(BlackboardData, Clauses, CompileError))
+	{
+		LogError(FString::Printf(TEXT("Could not compile blackboard expression: %s"), *CompileError));
+
+		return false;
+	}
+
+	return true;
+}
+
+#undef LOCTEXT_NAMESPACE
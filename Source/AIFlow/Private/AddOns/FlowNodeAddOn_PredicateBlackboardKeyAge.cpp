@@ -0,0 +1,89 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "AddOns/FlowNodeAddOn_PredicateBlackboardKeyAge.h"
+#include "AIFlowPredicateEvaluationContext.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "FlowSettings.h"
+#include "Subsystems/AIFlowBlackboardKeyAgeSubsystem.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Engine/World.h"
+
+#define LOCTEXT_NAMESPACE "FlowNodeAddOn_PredicateBlackboardKeyAge"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNodeAddOn_PredicateBlackboardKeyAge)
+
+UFlowNodeAddOn_PredicateBlackboardKeyAge::UFlowNodeAddOn_PredicateBlackboardKeyAge()
+	: Super()
+{
+#if WITH_EDITOR
+	NodeDisplayStyle = FlowNodeStyle::AddOn_Predicate;
+	Category = TEXT("Blackboard");
+#endif
+}
+
+#if WITH_EDITOR
+
+FText UFlowNodeAddOn_PredicateBlackboardKeyAge::K2_GetNodeTitle_Implementation() const
+{
+	if (Key.GetKeyName().IsNone() || !GetDefault<UFlowSettings>()->bUseAdaptiveNodeTitles)
+	{
+		return Super::K2_GetNodeTitle_Implementation();
+	}
+
+	const TCHAR* CompareString = (Compare == EAIFlowKeyAgeCompare::NotWrittenWithin) ? TEXT("not written within") : TEXT("written within");
+
+	return FText::FromString(FString::Printf(TEXT("%s %s %.2fs"), *Key.GetKeyName().ToString(), CompareString, ThresholdSeconds));
+}
+
+UBlackboardData* UFlowNodeAddOn_PredicateBlackboardKeyAge::GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const
+{
+	if (IsValid(SpecificBlackboardAsset))
+	{
+		return SpecificBlackboardAsset;
+	}
+
+	return Super::GetBlackboardAssetForPropertyHandle(PropertyHandle);
+}
+
+#endif // WITH_EDITOR
+
+bool UFlowNodeAddOn_PredicateBlackboardKeyAge::EvaluatePredicate_Implementation() const
+{
+	// Share the resolved blackboard with the node's other predicates, if they are being evaluated together
+	const FAIFlowCachedBlackboardReference CachedBlackboard =
+		FAIFlowPredicateEvaluationContext::ResolveBlackboardForPredicate(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+
+	if (!CachedBlackboard.IsValid())
+	{
+		// Mass agents' blackboard fragments are written in bulk, so their key write times are not tracked
+		LogError(TEXT("Cannot EvaluatePredicate on a blackboard key age without a Blackboard Component or Asset"));
+
+		return false;
+	}
+
+	const FBlackboard::FKey KeyID = FAIFlowBlackboardKeyTable::Get(*CachedBlackboard.BlackboardData)->FindKeyID(Key.GetKeyName());
+	if (KeyID == FBlackboard::InvalidKey)
+	{
+		LogError(FString::Printf(TEXT("Blackboard %s has no key %s"), *CachedBlackboard.BlackboardData->GetName(), *Key.GetKeyName().ToString()));
+
+		return false;
+	}
+
+	UWorld* World = GetWorld();
+	UAIFlowBlackboardKeyAgeSubsystem* KeyAgeSubsystem = IsValid(World) ? World->GetSubsystem<UAIFlowBlackboardKeyAgeSubsystem>() : nullptr;
+	if (!KeyAgeSubsystem)
+	{
+		return false;
+	}
+
+	float AgeSeconds = 0.0f;
+	const bool bWasWrittenWithin =
+		KeyAgeSubsystem->TryGetKeyAge(*CachedBlackboard.BlackboardComponent, KeyID, AgeSeconds) &&
+		AgeSeconds <= ThresholdSeconds;
+
+	return bWasWrittenWithin == (Compare == EAIFlowKeyAgeCompare::WrittenWithin);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,267 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "AddOns/FlowNodeAddOn_PredicateBlackboardValueInSet.h"
+#include "AIFlowPredicateEvaluationContext.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "FlowSettings.h"
+#include "Mass/AIFlowMassBlackboardFragment.h"
+#include "Mass/AIFlowMassBlackboardSubsystem.h"
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "Engine/World.h"
+
+#define LOCTEXT_NAMESPACE "FlowNodeAddOn_PredicateBlackboardValueInSet"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNodeAddOn_PredicateBlackboardValueInSet)
+
+UFlowNodeAddOn_PredicateBlackboardValueInSet::UFlowNodeAddOn_PredicateBlackboardValueInSet()
+	: Super()
+{
+#if WITH_EDITOR
+	NodeDisplayStyle = FlowNodeStyle::AddOn_Predicate;
+	Category = TEXT("Blackboard");
+#endif
+}
+
+#if WITH_EDITOR
+
+void UFlowNodeAddOn_PredicateBlackboardValueInSet::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	if (!HasAnyFlags(RF_ArchetypeObject | RF_ClassDefaultObject))
+	{
+		if (Key.AllowedTypes.IsEmpty())
+		{
+			// Enum (of any enum type), Native Enum and Int keys are the only ones that can be tested for membership
+			Key.AllowedTypes.Add(NewObject<UBlackboardKeyType_Enum>(this));
+			Key.AllowedTypes.Add(NewObject<UBlackboardKeyType_NativeEnum>(this));
+			Key.AllowedTypes.Add(NewObject<UBlackboardKeyType_Int>(this));
+		}
+	}
+}
+
+void UFlowNodeAddOn_PredicateBlackboardValueInSet::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	bIsEnumValueMaskBuilt = false;
+
+	if (!PropertyChangedEvent.MemberProperty)
+	{
+		return;
+	}
+
+	const FName MemberPropertyName = PropertyChangedEvent.MemberProperty->GetFName();
+	if (MemberPropertyName == GET_MEMBER_NAME_CHECKED(ThisClass, Key) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ThisClass, AllowedEnumValues) ||
+		MemberPropertyName == GET_MEMBER_NAME_CHECKED(ThisClass, SpecificBlackboardAsset))
+	{
+		RefreshAllowedEnumValuesFromKey();
+	}
+}
+
+void UFlowNodeAddOn_PredicateBlackboardValueInSet::RefreshAllowedEnumValuesFromKey()
+{
+	const UBlackboardData* BlackboardData = GetBlackboardAssetForEditor();
+	if (!IsValid(BlackboardData))
+	{
+		return;
+	}
+
+	// Enum keys name their enum with EnumName only when bIsEnumNameValid, Native Enum keys always do
+	const UBlackboardKeyType* KeyType = FAIFlowBlackboardKeyTable::Get(*BlackboardData)->FindKeyType(Key.GetKeyName());
+
+	UEnum* EnumClass = nullptr;
+	FString EnumName;
+
+	if (const UBlackboardKeyType_Enum* KeyTypeEnum = Cast<UBlackboardKeyType_Enum>(KeyType))
+	{
+		EnumClass = KeyTypeEnum->EnumType;
+
+		if (KeyTypeEnum->bIsEnumNameValid)
+		{
+			EnumName = KeyTypeEnum->EnumName;
+		}
+	}
+	else if (const UBlackboardKeyType_NativeEnum* KeyTypeNativeEnum = Cast<UBlackboardKeyType_NativeEnum>(KeyType))
+	{
+		EnumClass = KeyTypeNativeEnum->EnumType;
+		EnumName = KeyTypeNativeEnum->EnumName;
+	}
+	else
+	{
+		return;
+	}
+
+	// As UFlowBlackboardEntryValue_Enum does, apply the key's enum to each of the (FConfigurableEnumProperty) values
+	for (FConfigurableEnumProperty& AllowedEnumValue : AllowedEnumValues)
+	{
+		if (AllowedEnumValue.EnumClass != EnumClass)
+		{
+			AllowedEnumValue.EnumClass = EnumClass;
+			AllowedEnumValue.Value = NAME_None;
+		}
+
+		AllowedEnumValue.EnumName = EnumName;
+	}
+}
+
+FText UFlowNodeAddOn_PredicateBlackboardValueInSet::K2_GetNodeTitle_Implementation() const
+{
+	if (Key.GetKeyName().IsNone() || !GetDefault<UFlowSettings>()->bUseAdaptiveNodeTitles)
+	{
+		return Super::K2_GetNodeTitle_Implementation();
+	}
+
+	TStringBuilder<256> TitleBuilder;
+	TitleBuilder << Key.GetKeyName() << (bNot ? TEXT(" not in ") : TEXT(" in "));
+
+	if (!AllowedEnumValues.IsEmpty())
+	{
+		TitleBuilder << TEXT("{");
+
+		for (int32 Index = 0; Index < AllowedEnumValues.Num(); ++Index)
+		{
+			TitleBuilder << (Index > 0 ? TEXT(", ") : TEXT("")) << AllowedEnumValues[Index].Value;
+		}
+
+		TitleBuilder << TEXT("}");
+	}
+	else
+	{
+		for (int32 Index = 0; Index < AllowedIntRanges.Num(); ++Index)
+		{
+			TitleBuilder.Appendf(TEXT("%s[%d..%d]"), Index > 0 ? TEXT(", ") : TEXT(""), AllowedIntRanges[Index].Min, AllowedIntRanges[Index].Max);
+		}
+	}
+
+	return FText::FromStringView(TitleBuilder.ToView());
+}
+
+UBlackboardData* UFlowNodeAddOn_PredicateBlackboardValueInSet::GetBlackboardAssetForEditor() const
+{
+	if (IsValid(SpecificBlackboardAsset))
+	{
+		return SpecificBlackboardAsset;
+	}
+
+	return GetBlackboardAsset();
+}
+
+UBlackboardData* UFlowNodeAddOn_PredicateBlackboardValueInSet::GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const
+{
+	if (UBlackboardData* BlackboardAssetForEditor = GetBlackboardAssetForEditor())
+	{
+		return BlackboardAssetForEditor;
+	}
+
+	return Super::GetBlackboardAssetForPropertyHandle(PropertyHandle);
+}
+
+#endif // WITH_EDITOR
+
+bool UFlowNodeAddOn_PredicateBlackboardValueInSet::EvaluatePredicate_Implementation() const
+{
+	// Share the resolved blackboard with the node's other predicates, if they are being evaluated together
+	const FAIFlowCachedBlackboardReference CachedBlackboard =
+		FAIFlowPredicateEvaluationContext::ResolveBlackboardForPredicate(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+
+	if (CachedBlackboard.IsValid())
+	{
+		const FAIFlowBlackboardKeyTableEntry* KeyEntry = FAIFlowBlackboardKeyTable::Get(*CachedBlackboard.BlackboardData)->FindEntry(Key.GetKeyName());
+		const uint8* RawKeyMemory = (KeyEntry && KeyEntry->KeyType) ? CachedBlackboard.BlackboardComponent->GetKeyRawData(KeyEntry->KeyID) : nullptr;
+		if (!RawKeyMemory)
+		{
+			LogError(FString::Printf(TEXT("Blackboard %s has no key %s"), *CachedBlackboard.BlackboardData->GetName(), *Key.GetKeyName().ToString()));
+
+			return false;
+		}
+
+		return EvaluateRawKeyValue(*KeyEntry->KeyType, RawKeyMemory);
+	}
+
+	if (const FAIFlowMassBlackboardFragment* MassBlackboardFragment = UAIFlowMassBlackboardSubsystem::FindBlackboardFragmentForActorInWorld(GetWorld(), TryGetRootFlowActorOwner(), SpecificBlackboardAsset))
+	{
+		const FBlackboard::FKey KeyID = MassBlackboardFragment->GetKeyID(Key.GetKeyName());
+		const UBlackboardKeyType* KeyType = MassBlackboardFragment->GetKeyType(KeyID);
+		const uint8* RawKeyMemory = MassBlackboardFragment->GetKeyRawData(KeyID);
+		if (!KeyType || !RawKeyMemory)
+		{
+			LogError(FString::Printf(TEXT("Mass blackboard has no key %s"), *Key.GetKeyName().ToString()));
+
+			return false;
+		}
+
+		return EvaluateRawKeyValue(*KeyType, RawKeyMemory);
+	}
+
+	LogError(TEXT("Cannot EvaluatePredicate on a blackboard value set without a Blackboard Component or Asset"));
+
+	return false;
+}
+
+bool UFlowNodeAddOn_PredicateBlackboardValueInSet::EvaluateRawKeyValue(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const
+{
+	bool bIsInSet = false;
+
+	if (KeyType.IsA<UBlackboardKeyType_Enum>() || KeyType.IsA<UBlackboardKeyType_NativeEnum>())
+	{
+		EnsureEnumValueMaskBuilt();
+
+		bIsInSet = EnumValueMask.Contains(*RawKeyMemory);
+	}
+	else if (const UBlackboardKeyType_Int* IntKeyType = Cast<UBlackboardKeyType_Int>(&KeyType))
+	{
+		const int32 Value = UBlackboardKeyType_Int::GetValue(IntKeyType, RawKeyMemory);
+
+		for (const FAIFlowIntRange& AllowedIntRange : AllowedIntRanges)
+		{
+			if (AllowedIntRange.Contains(Value))
+			{
+				bIsInSet = true;
+				break;
+			}
+		}
+	}
+	else
+	{
+		LogError(FString::Printf(TEXT("Key %s must be an Enum or Int key for a value set"), *Key.GetKeyName().ToString()));
+
+		return false;
+	}
+
+	return bIsInSet != bNot;
+}
+
+void UFlowNodeAddOn_PredicateBlackboardValueInSet::EnsureEnumValueMaskBuilt() const
+{
+	if (bIsEnumValueMaskBuilt)
+	{
+		return;
+	}
+
+	EnumValueMask.Reset();
+
+	for (const FConfigurableEnumProperty& AllowedEnumValue : AllowedEnumValues)
+	{
+		// Converted as UFlowBlackboardEntryValue_Enum converts its FConfigurableEnumProperty
+		const int64 EnumValueAsInt = IsValid(AllowedEnumValue.EnumClass) ? AllowedEnumValue.EnumClass->GetValueByName(AllowedEnumValue.Value) : INDEX_NONE;
+		if (EnumValueAsInt < 0 || EnumValueAsInt > MAX_uint8)
+		{
+			LogError(FString::Printf(TEXT("Allowed enum value %s is not a valid blackboard enum value"), *AllowedEnumValue.Value.ToString()));
+
+			continue;
+		}
+
+		EnumValueMask.Add(static_cast<uint8>(EnumValueAsInt));
+	}
+
+	bIsEnumValueMaskBuilt = true;
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -2,10 +2,16 @@
 
 #include "AddOns/FlowNodeAddOn_PredicateCompareBlackboardValue.h"
 #include "AIFlowActorBlackboardHelper.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
 #include "Blackboard/FlowBlackboardEntryValue.h"
 #include "FlowAsset.h"
 #include "FlowSettings.h"
 #include "AIFlowLogChannels.h"
+#include "AIFlowPredicateEvaluationContext.h"
+#include "AIFlowStats.h"
+#include "Blackboard/AIFlowBlackboardExpression.h"
+#include "Mass/AIFlowMassBlackboardFragment.h"
+#include "Mass/AIFlowMassBlackboardSubsystem.h"
 
 #include "Nodes/FlowNodeBase.h"
 
@@ -14,11 +20,16 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
 #include "EdGraph/EdGraph.h"
+#include "Engine/World.h"
 
 #define LOCTEXT_NAMESPACE "FlowNodeAddOn_PredicateCompareBlackboardValue"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNodeAddOn_PredicateCompareBlackboardValue)
 
+DECLARE_DWORD_COUNTER_STAT(TEXT("Compare Predicate Cached Hits"), STAT_AIFlow_ComparePredicateCachedHits, STATGROUP_AIFlow);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Compare Predicate Recomputes"), STAT_AIFlow_ComparePredicateRecomputes, STATGROUP_AIFlow);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Compare Predicate Absorbed Flips"), STAT_AIFlow_ComparePredicateAbsorbedFlips, STATGROUP_AIFlow);
+
 UFlowNodeAddOn_PredicateCompareBlackboardValue::UFlowNodeAddOn_PredicateCompareBlackboardValue()
 	: Super()
 {
@@ -244,7 +255,9 @@ bool UFlowNodeAddOn_PredicateCompareBlackboardValue::TryGetBlackboardKeyInfo(
 		return false;
 	}
 
-	OutKeyID = BlackboardData.GetKeyID(KeyName);
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(BlackboardData);
+	const FAIFlowBlackboardKeyTableEntry* KeyTableEntry = KeyTable->FindEntry(KeyName);
+	OutKeyID = KeyTableEntry ? KeyTableEntry->KeyID : FBlackboard::InvalidKey;
 
 	if (OutKeyID == FBlackboard::InvalidKey)
 	{
@@ -272,12 +285,93 @@ bool UFlowNodeAddOn_PredicateCompareBlackboardValue::TryGetBlackboardKeyInfo(
 	return true;
 }
 
+void UFlowNodeAddOn_PredicateCompareBlackboardValue::DeinitializeInstance()
+{
+	StopObservingKeys();
+
+	Super::DeinitializeInstance();
+}
+
+void UFlowNodeAddOn_PredicateCompareBlackboardValue::ResetInstanceForReuse()
+{
+	Super::ResetInstanceForReuse();
+
+	StopObservingKeys();
+
+	CachedResultHitCount = 0;
+	RecomputeCount = 0;
+
+	bHasLastResult = false;
+	bLastResult = false;
+	LastResultChangeTime = 0.0;
+	AbsorbedFlipCount = 0;
+}
+
 bool UFlowNodeAddOn_PredicateCompareBlackboardValue::EvaluatePredicate_Implementation() const
 {
-	const FAIFlowCachedBlackboardReference CachedBlackboard(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+	const FAIFlowCachedBlackboardReference CachedBlackboard = ResolveBlackboardForEvaluation();
+
+	// The cached result is only for the observed blackboard (the resolved blackboard can change, eg, when the pawn is possessed)
+	if (bCacheResultWithObservers &&
+		bHasCachedResult &&
+		CachedBlackboard.IsValid() &&
+		ObservedBlackboardComponent.Get() == CachedBlackboard.BlackboardComponent)
+	{
+		++CachedResultHitCount;
+		INC_DWORD_STAT(STAT_AIFlow_ComparePredicateCachedHits);
+
+		return bCachedResult;
+	}
+
+	const bool bComputedResult = ComputePredicateResult(CachedBlackboard);
+	const bool bResult = HasStatefulResult() ? ApplyMinimumHoldTime(bComputedResult) : bComputedResult;
+
+	++RecomputeCount;
+	INC_DWORD_STAT(STAT_AIFlow_ComparePredicateRecomputes);
+
+	// The observers are runtime-only (mutable) state, registered on first evaluation (the predicate interface is const).
+	// A held result is not cached, as it must be recomputed once the hold time has passed (even if the keys are unchanged).
+	if (bCacheResultWithObservers &&
+		bResult == bComputedResult &&
+		CachedBlackboard.IsValid() &&
+		TryObserveKeysForCachedResult(*CachedBlackboard.BlackboardComponent))
+	{
+		bCachedResult = bResult;
+		bHasCachedResult = true;
+	}
+
+	return bResult;
+}
+
+FAIFlowCachedBlackboardReference UFlowNodeAddOn_PredicateCompareBlackboardValue::ResolveBlackboardForEvaluation() const
+{
+	// Share the resolved blackboard with the node's other predicates, if they are being evaluated together
+	return FAIFlowPredicateEvaluationContext::ResolveBlackboardForPredicate(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+}
+
+FAIFlowBlackboardExpressionClause UFlowNodeAddOn_PredicateCompareBlackboardValue::MakeExpressionClause() const
+{
+	FAIFlowBlackboardExpressionClause Clause;
+	Clause.KeyLeft = KeyLeft;
+	Clause.OperatorType = OperatorType;
+
+	// As in EvaluatePredicate, a valid ExplicitValueRight is used in preference to KeyRight
+	Clause.bUseExplicitValueForRightHandSide = IsValid(ExplicitValueRight);
+	Clause.KeyRight = KeyRight;
+	Clause.ExplicitValueRight = ExplicitValueRight;
+
+	return Clause;
+}
 
+bool UFlowNodeAddOn_PredicateCompareBlackboardValue::ComputePredicateResult(const FAIFlowCachedBlackboardReference& CachedBlackboard) const
+{
 	if (!CachedBlackboard.IsValid())
 	{
+		if (const FAIFlowMassBlackboardFragment* MassBlackboardFragment = UAIFlowMassBlackboardSubsystem::FindBlackboardFragmentForActorInWorld(GetWorld(), TryGetRootFlowActorOwner(), SpecificBlackboardAsset))
+		{
+			return EvaluatePredicateOnMassBlackboard(*MassBlackboardFragment);
+		}
+
 		LogError(TEXT("Cannot EvaluatePredicate on a blackboard key without a Blackboard Component or Asset"));
 
 		return false;
@@ -382,15 +476,18 @@ bool UFlowNodeAddOn_PredicateCompareBlackboardValue::ComputeCompareResultWithExp
 
 		const EArithmeticKeyOperation::Type ArithmeticOp = ConvertPredicateCompareOperatorTypeToArithmeticKeyOperation(OperatorType);
 
-		const bool bArithmeticResult = 
-			BlackboardKeyTypeCDO->WrappedTestArithmeticOperation(
-				BlackboardComponent,
-				LeftMemory,
-				ArithmeticOp,
-				RightIntValue,
-				RightFloatValue);
-
-		return bArithmeticResult;
+		auto TestWithRightValues = [&](int32 InRightIntValue, float InRightFloatValue)
+			{
+				return
+					BlackboardKeyTypeCDO->WrappedTestArithmeticOperation(
+						BlackboardComponent,
+						LeftMemory,
+						ArithmeticOp,
+						InRightIntValue,
+						InRightFloatValue);
+			};
+
+		return TestArithmeticWithHysteresis(TestWithRightValues, RightIntValue, RightFloatValue);
 	}
 
 	LogError(FString::Printf(TEXT("Incorrectly configured CompareBlackboardValues %s"), *GetName()));
@@ -404,12 +501,33 @@ bool UFlowNodeAddOn_PredicateCompareBlackboardValue::ComputeCompareResult(
 	const FBlackboard::FKey LeftKeyID,
 	const FBlackboard::FKey RightKeyID) const
 {
+	// Values gathered by an active evaluation context are shared by the node's other predicates that read the keys
+	FAIFlowPredicateEvaluationContext* EvaluationContext = FAIFlowPredicateEvaluationContext::FindActiveContext(*this);
+
 	if (IsEqualityOperation(OperatorType))
 	{
-		// Do the equality (==, !=) comparison
-		const EBlackboardCompare::Type CompareResult = BlackboardComponent.CompareKeyValues(BlackboardKeyType, LeftKeyID, RightKeyID);
+		// Do the equality (==, !=) comparison, on the gathered values for the numerical key types
+		// (with the Float key type's CompareValues tolerance)
+		bool bIsMatch = false;
+
+		int32 LeftIntValue = 0;
+		float LeftFloatValue = 0.0f;
+		int32 RightIntValue = 0;
+		float RightFloatValue = 0.0f;
+		if (EvaluationContext &&
+			EvaluationContext->TryGetNumericalValue(BlackboardComponent, LeftKeyID, LeftIntValue, LeftFloatValue) &&
+			EvaluationContext->TryGetNumericalValue(BlackboardComponent, RightKeyID, RightIntValue, RightFloatValue))
+		{
+			bIsMatch =
+				(BlackboardKeyType == UBlackboardKeyType_Float::StaticClass()) ?
+					FMath::Abs(LeftFloatValue - RightFloatValue) < UE_KINDA_SMALL_NUMBER :
+					LeftIntValue == RightIntValue;
+		}
+		else
+		{
+			bIsMatch = (BlackboardComponent.CompareKeyValues(BlackboardKeyType, LeftKeyID, RightKeyID) == EBlackboardCompare::Equal);
+		}
 
-		const bool bIsMatch = (CompareResult == EBlackboardCompare::Equal);
 		const bool bExpectsMatch = (OperatorType == EPredicateCompareOperatorType::Equal);
 
 		const bool bActualResultMatchedExpectation = (bIsMatch == bExpectsMatch);
@@ -424,48 +542,289 @@ bool UFlowNodeAddOn_PredicateCompareBlackboardValue::ComputeCompareResult(
 		// Fetch the numerical values for the right side blackboard key
 		int32 RightIntValue = 0;
 		float RightFloatValue = 0.0f;
-		if (BlackboardKeyType == UBlackboardKeyType_Float::StaticClass())
+
+		if (!EvaluationContext || !EvaluationContext->TryGetNumericalValue(BlackboardComponent, RightKeyID, RightIntValue, RightFloatValue))
 		{
-			RightFloatValue = BlackboardComponent.GetValueAsFloat(KeyRight.GetKeyName());
-			RightIntValue = FMath::FloorToInt32(RightFloatValue);
+			if (BlackboardKeyType == UBlackboardKeyType_Float::StaticClass())
+			{
+				RightFloatValue = BlackboardComponent.GetValueAsFloat(KeyRight.GetKeyName());
+				RightIntValue = FMath::FloorToInt32(RightFloatValue);
+			}
+			else if (BlackboardKeyType == UBlackboardKeyType_Int::StaticClass())
+			{
+				RightIntValue = BlackboardComponent.GetValueAsInt(KeyRight.GetKeyName());
+				RightFloatValue = static_cast<float>(RightIntValue);
+			}
+			else if (BlackboardKeyType == UBlackboardKeyType_Enum::StaticClass())
+			{
+				RightIntValue = BlackboardComponent.GetValueAsEnum(KeyRight.GetKeyName());
+				RightFloatValue = static_cast<float>(RightIntValue);
+			}
+			else
+			{
+				LogError(
+					FString::Printf(
+						TEXT("%s does not support arithmetic comparison operations"),
+						BlackboardKeyType ? *BlackboardKeyType->GetName() : TEXT("<null>")));
+
+				return false;
+			}
+		}
+
+		// The left key's value is gathered through the context too, and compared as its key type would compare it
+		int32 LeftIntValue = 0;
+		float LeftFloatValue = 0.0f;
+		if (EvaluationContext && EvaluationContext->TryGetNumericalValue(BlackboardComponent, LeftKeyID, LeftIntValue, LeftFloatValue))
+		{
+			const bool bCompareAsFloat = (BlackboardKeyType == UBlackboardKeyType_Float::StaticClass());
+
+			auto TestGatheredWithRightValues = [this, bCompareAsFloat, LeftIntValue, LeftFloatValue](int32 InRightIntValue, float InRightFloatValue)
+				{
+					return TestArithmeticOnValues(bCompareAsFloat, LeftIntValue, LeftFloatValue, InRightIntValue, InRightFloatValue);
+				};
+
+			return TestArithmeticWithHysteresis(TestGatheredWithRightValues, RightIntValue, RightFloatValue);
 		}
-		else if (BlackboardKeyType == UBlackboardKeyType_Int::StaticClass())
+
+		const UBlackboardKeyType * BlackboardKeyTypeCDO = BlackboardKeyType->GetDefaultObject<UBlackboardKeyType>();
+		check(IsValid(BlackboardKeyTypeCDO));
+
+		const uint8* LeftMemory = BlackboardComponent.GetKeyRawData(LeftKeyID);
+		check(LeftMemory);
+
+		const EArithmeticKeyOperation::Type ArithmeticOp = ConvertPredicateCompareOperatorTypeToArithmeticKeyOperation(OperatorType);
+
+		auto TestWithRightValues = [&](int32 InRightIntValue, float InRightFloatValue)
+			{
+				return
+					BlackboardKeyTypeCDO->WrappedTestArithmeticOperation(
+						BlackboardComponent,
+						LeftMemory,
+						ArithmeticOp,
+						InRightIntValue,
+						InRightFloatValue);
+			};
+
+		return TestArithmeticWithHysteresis(TestWithRightValues, RightIntValue, RightFloatValue);
+	}
+
+	LogError(FString::Printf(TEXT("Incorrectly configured CompareBlackboardValues %s"), *GetName()));
+
+	return false;
+}
+
+bool UFlowNodeAddOn_PredicateCompareBlackboardValue::TestArithmeticOnValues(bool bCompareAsFloat, int32 LeftIntValue, float LeftFloatValue, int32 RightIntValue, float RightFloatValue) const
+{
+	const double LeftValue = bCompareAsFloat ? static_cast<double>(LeftFloatValue) : static_cast<double>(LeftIntValue);
+	const double RightValue = bCompareAsFloat ? static_cast<double>(RightFloatValue) : static_cast<double>(RightIntValue);
+
+	static_assert(static_cast<__underlying_type(EPredicateCompareOperatorType)>(EPredicateCompareOperatorType::Max) == 6, "This code may need updating if the enum values change");
+	switch (OperatorType)
+	{
+	case EPredicateCompareOperatorType::Less: return LeftValue < RightValue;
+	case EPredicateCompareOperatorType::LessOrEqual: return LeftValue <= RightValue;
+	case EPredicateCompareOperatorType::Greater: return LeftValue > RightValue;
+	case EPredicateCompareOperatorType::GreaterOrEqual: return LeftValue >= RightValue;
+	default: return false;
+	}
+}
+
+bool UFlowNodeAddOn_PredicateCompareBlackboardValue::TestArithmeticWithHysteresis(
+	TFunctionRef<bool(int32 RightIntValue, float RightFloatValue)> TestWithRightValues,
+	int32 RightIntValue,
+	float RightFloatValue) const
+{
+	const bool bEnterResult = TestWithRightValues(RightIntValue, RightFloatValue);
+	if (bEnterResult || HysteresisMargin <= 0.0f || !bHasLastResult || !bLastResult)
+	{
+		return bEnterResult;
+	}
+
+	// The result is true, so it stays true until Key (left) is past the exit threshold
+	// (the right-hand value, moved back by the margin)
+	const bool bIsLessOperation =
+		OperatorType == EPredicateCompareOperatorType::Less ||
+		OperatorType == EPredicateCompareOperatorType::LessOrEqual;
+
+	const float FloatMargin = bIsLessOperation ? HysteresisMargin : -HysteresisMargin;
+	const int64 IntMargin = bIsLessOperation ? FMath::CeilToInt64(HysteresisMargin) : -FMath::CeilToInt64(HysteresisMargin);
+	const int32 ExitIntValue = static_cast<int32>(FMath::Clamp<int64>(static_cast<int64>(RightIntValue) + IntMargin, MIN_int32, MAX_int32));
+
+	const bool bExitResult = TestWithRightValues(ExitIntValue, RightFloatValue + FloatMargin);
+	if (bExitResult)
+	{
+		++AbsorbedFlipCount;
+		INC_DWORD_STAT(STAT_AIFlow_ComparePredicateAbsorbedFlips);
+	}
+
+	return bExitResult;
+}
+
+bool UFlowNodeAddOn_PredicateCompareBlackboardValue::ApplyMinimumHoldTime(bool bComputedResult) const
+{
+	const UWorld* World = GetWorld();
+	const double CurrentTime = IsValid(World) ? World->GetTimeSeconds() : 0.0;
+
+	if (bHasLastResult && bComputedResult != bLastResult)
+	{
+		if (MinimumHoldSeconds > 0.0f && CurrentTime - LastResultChangeTime < MinimumHoldSeconds)
 		{
-			RightIntValue = BlackboardComponent.GetValueAsInt(KeyRight.GetKeyName());
-			RightFloatValue = static_cast<float>(RightIntValue);
+			++AbsorbedFlipCount;
+			INC_DWORD_STAT(STAT_AIFlow_ComparePredicateAbsorbedFlips);
+
+			return bLastResult;
 		}
-		else if (BlackboardKeyType == UBlackboardKeyType_Enum::StaticClass())
+
+		LastResultChangeTime = CurrentTime;
+	}
+	else if (!bHasLastResult)
+	{
+		LastResultChangeTime = CurrentTime;
+	}
+
+	bHasLastResult = true;
+	bLastResult = bComputedResult;
+
+	return bComputedResult;
+}
+
+bool UFlowNodeAddOn_PredicateCompareBlackboardValue::TryObserveKeysForCachedResult(UBlackboardComponent& BlackboardComponent) const
+{
+	if (ObservedBlackboardComponent.Get() == &BlackboardComponent)
+	{
+		return true;
+	}
+
+	StopObservingKeys();
+
+	const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+	if (!IsValid(BlackboardData))
+	{
+		return false;
+	}
+
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(*BlackboardData);
+
+	const FBlackboard::FKey KeyLeftID = KeyTable->FindKeyID(KeyLeft.GetKeyName());
+	const FBlackboard::FKey KeyRightID = IsValid(ExplicitValueRight) ? FBlackboard::InvalidKey : KeyTable->FindKeyID(KeyRight.GetKeyName());
+
+	const bool bNeedsKeyRight = !IsValid(ExplicitValueRight);
+	if (KeyLeftID == FBlackboard::InvalidKey || (bNeedsKeyRight && KeyRightID == FBlackboard::InvalidKey))
+	{
+		return false;
+	}
+
+	BlackboardComponent.RegisterObserver(KeyLeftID, this, FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnObservedKeyChanged));
+
+	if (KeyRightID != FBlackboard::InvalidKey && KeyRightID != KeyLeftID)
+	{
+		BlackboardComponent.RegisterObserver(KeyRightID, this, FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnObservedKeyChanged));
+	}
+
+	ObservedBlackboardComponent = &BlackboardComponent;
+
+	return true;
+}
+
+void UFlowNodeAddOn_PredicateCompareBlackboardValue::StopObservingKeys() const
+{
+	if (UBlackboardComponent* BlackboardComponent = ObservedBlackboardComponent.Get())
+	{
+		BlackboardComponent->UnregisterObserversFrom(this);
+	}
+
+	ObservedBlackboardComponent.Reset();
+	bHasCachedResult = false;
+}
+
+EBlackboardNotificationResult UFlowNodeAddOn_PredicateCompareBlackboardValue::OnObservedKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey ChangedKeyID) const
+{
+	bHasCachedResult = false;
+
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
+bool UFlowNodeAddOn_PredicateCompareBlackboardValue::EvaluatePredicateOnMassBlackboard(const FAIFlowMassBlackboardFragment& MassBlackboardFragment) const
+{
+	const UBlackboardData* BlackboardData = MassBlackboardFragment.GetBlackboardData();
+	check(BlackboardData);
+
+	constexpr bool bWarnIfBlackboardKeysAreMissing = true;
+	FBlackboard::FKey KeyLeftID = FBlackboard::InvalidKey;
+	FBlackboardEntry const* KeyLeftTypeEntry = nullptr;
+	if (!TryGetBlackboardKeyInfo(*BlackboardData, KeyLeft, KeyLeftID, KeyLeftTypeEntry, bWarnIfBlackboardKeysAreMissing))
+	{
+		LogError(TEXT("Cannot EvaluatePredicate on a blackboard key without a valid Key (left)"));
+
+		return false;
+	}
+
+	const uint8* LeftMemory = MassBlackboardFragment.GetKeyRawData(KeyLeftID);
+	if (!LeftMemory)
+	{
+		LogError(FString::Printf(TEXT("Cannot EvaluatePredicate on key %s, as its key type is not supported by Mass blackboards"), *KeyLeft.GetKeyName().ToString()));
+
+		return false;
+	}
+
+	const bool bExpectsMatch = (OperatorType == EPredicateCompareOperatorType::Equal);
+
+	FBlackboard::FKey KeyRightID = FBlackboard::InvalidKey;
+	if (!IsValid(ExplicitValueRight))
+	{
+		FBlackboardEntry const* KeyRightTypeEntry = nullptr;
+		if (!TryGetBlackboardKeyInfo(*BlackboardData, KeyRight, KeyRightID, KeyRightTypeEntry, bWarnIfBlackboardKeysAreMissing))
 		{
-			RightIntValue = BlackboardComponent.GetValueAsEnum(KeyRight.GetKeyName());
-			RightFloatValue = static_cast<float>(RightIntValue);
+			LogError(TEXT("Cannot EvaluatePredicate on a blackboard key without a valid Key (right)"));
+
+			return false;
 		}
-		else
+	}
+
+	if (IsEqualityOperation(OperatorType))
+	{
+		// Do the equality (==, !=) comparison
+		const EBlackboardCompare::Type CompareResult =
+			IsValid(ExplicitValueRight) ?
+				ExplicitValueRight->CompareRawKeyMemory(*KeyLeftTypeEntry->KeyType, LeftMemory) :
+				MassBlackboardFragment.CompareKeyValues(KeyLeftID, KeyRightID);
+
+		const bool bIsMatch = (CompareResult == EBlackboardCompare::Equal);
+
+		return (bIsMatch == bExpectsMatch);
+	}
+
+	if (IsArithmeticOperation(OperatorType))
+	{
+		// Do the arithmetic (<, <=, >, >=) comparison
+		int32 LeftIntValue = 0;
+		float LeftFloatValue = 0.0f;
+		int32 RightIntValue = 0;
+		float RightFloatValue = 0.0f;
+
+		const bool bHasRightValues =
+			IsValid(ExplicitValueRight) ?
+				ExplicitValueRight->TryGetNumericalValuesForArithmeticOperation(&RightIntValue, &RightFloatValue) :
+				MassBlackboardFragment.TryGetNumericalValue(KeyRightID, RightIntValue, RightFloatValue);
+
+		if (!bHasRightValues || !MassBlackboardFragment.TryGetNumericalValue(KeyLeftID, LeftIntValue, LeftFloatValue))
 		{
 			LogError(
 				FString::Printf(
 					TEXT("%s does not support arithmetic comparison operations"),
-					BlackboardKeyType ? *BlackboardKeyType->GetName() : TEXT("<null>")));
+					*KeyLeftTypeEntry->KeyType->GetClass()->GetName()));
 
 			return false;
 		}
 
-		const UBlackboardKeyType * BlackboardKeyTypeCDO = BlackboardKeyType->GetDefaultObject<UBlackboardKeyType>();
-		check(IsValid(BlackboardKeyTypeCDO));
+		const bool bCompareAsFloat = KeyLeftTypeEntry->KeyType->IsA<UBlackboardKeyType_Float>();
 
-		const uint8* LeftMemory = BlackboardComponent.GetKeyRawData(LeftKeyID);
-		check(LeftMemory);
-
-		const EArithmeticKeyOperation::Type ArithmeticOp = ConvertPredicateCompareOperatorTypeToArithmeticKeyOperation(OperatorType);
-
-		const bool bArithmeticResult =
-			BlackboardKeyTypeCDO->WrappedTestArithmeticOperation(
-				BlackboardComponent,
-				LeftMemory,
-				ArithmeticOp,
-				RightIntValue,
-				RightFloatValue);
+		auto TestWithRightValues = [this, bCompareAsFloat, LeftIntValue, LeftFloatValue](int32 InRightIntValue, float InRightFloatValue)
+			{
+				return TestArithmeticOnValues(bCompareAsFloat, LeftIntValue, LeftFloatValue, InRightIntValue, InRightFloatValue);
+			};
 
-		return bArithmeticResult;
+		return TestArithmeticWithHysteresis(TestWithRightValues, RightIntValue, RightFloatValue);
 	}
 
 	LogError(FString::Printf(TEXT("Incorrectly configured CompareBlackboardValues %s"), *GetName()));
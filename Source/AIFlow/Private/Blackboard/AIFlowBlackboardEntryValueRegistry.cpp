@@ -0,0 +1,179 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Blackboard/AIFlowBlackboardEntryValueRegistry.h"
+#include "Blackboard/FlowBlackboardEntryValue.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+#include "Modules/ModuleManager.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/UObjectHash.h"
+
+namespace AIFlowBlackboardEntryValueRegistry_Private
+{
+	TSharedPtr<const FAIFlowBlackboardEntryValueRegistry::FSnapshot, ESPMode::ThreadSafe> PublishedSnapshot;
+	FRWLock PublishedSnapshotLock;
+
+	// Set when modules are loaded or reloaded, the published snapshot is then rebuilt on the next game thread GetSnapshot()
+	std::atomic<bool> bPublishedSnapshotDirty = false;
+
+	FDelegateHandle OnPostEngineInitHandle;
+	FDelegateHandle OnModulesChangedHandle;
+
+#if WITH_EDITOR
+	FDelegateHandle OnReloadCompleteHandle;
+#endif // WITH_EDITOR
+}
+
+FAIFlowBlackboardEntryValueRegistry::FSnapshotRef FAIFlowBlackboardEntryValueRegistry::GetSnapshot()
+{
+	using namespace AIFlowBlackboardEntryValueRegistry_Private;
+
+	// Only the game thread rebuilds a dirty snapshot (other threads keep using the published one until then)
+	if (bPublishedSnapshotDirty.load(std::memory_order_acquire) && IsInGameThread())
+	{
+		Republish();
+	}
+
+	{
+		FRWScopeLock ReadLock(PublishedSnapshotLock, SLT_ReadOnly);
+
+		if (PublishedSnapshot.IsValid())
+		{
+			return PublishedSnapshot.ToSharedRef();
+		}
+	}
+
+	const FSnapshotRef NewSnapshot = BuildSnapshot();
+
+	FRWScopeLock WriteLock(PublishedSnapshotLock, SLT_Write);
+
+	// Keep the first published snapshot, if another thread raced us
+	if (!PublishedSnapshot.IsValid())
+	{
+		PublishedSnapshot = NewSnapshot;
+	}
+
+	return PublishedSnapshot.ToSharedRef();
+}
+
+UClass* FAIFlowBlackboardEntryValueRegistry::FindEntryValueSubclassForKeyType(const UClass* KeyTypeClass)
+{
+	if (!KeyTypeClass)
+	{
+		return nullptr;
+	}
+
+	const FSnapshotRef Snapshot = GetSnapshot();
+
+	for (const UClass* It = KeyTypeClass; It; It = It->GetSuperClass())
+	{
+		if (const TWeakObjectPtr<UClass>* FoundSubclass = Snapshot->EntryValueSubclassBySupportedKeyType.Find(It))
+		{
+			return FoundSubclass->Get();
+		}
+	}
+
+	return nullptr;
+}
+
+void FAIFlowBlackboardEntryValueRegistry::Republish()
+{
+	using namespace AIFlowBlackboardEntryValueRegistry_Private;
+
+	check(IsInGameThread());
+
+	// Cleared before building, so a module loaded while we build marks the new snapshot dirty again
+	bPublishedSnapshotDirty.store(false, std::memory_order_release);
+
+	const FSnapshotRef NewSnapshot = BuildSnapshot();
+
+	FRWScopeLock WriteLock(PublishedSnapshotLock, SLT_Write);
+
+	PublishedSnapshot = NewSnapshot;
+}
+
+void FAIFlowBlackboardEntryValueRegistry::MarkDirty()
+{
+	AIFlowBlackboardEntryValueRegistry_Private::bPublishedSnapshotDirty.store(true, std::memory_order_release);
+}
+
+void FAIFlowBlackboardEntryValueRegistry::StartupRegistry()
+{
+	using namespace AIFlowBlackboardEntryValueRegistry_Private;
+
+	// Publish once all of the startup modules are loaded
+	OnPostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddStatic(&FAIFlowBlackboardEntryValueRegistry::Republish);
+
+	// Subclasses can be added by modules that load later, so mark the snapshot dirty and let the next lookup rebuild it
+	// (modules are loaded in bursts, and this avoids a rebuild per module)
+	OnModulesChangedHandle = FModuleManager::Get().OnModulesChanged().AddLambda(
+		[](FName, EModuleChangeReason ChangeReason)
+		{
+			if (ChangeReason == EModuleChangeReason::ModuleLoaded)
+			{
+				MarkDirty();
+			}
+		});
+
+#if WITH_EDITOR
+	OnReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) { MarkDirty(); });
+#endif // WITH_EDITOR
+}
+
+void FAIFlowBlackboardEntryValueRegistry::ShutdownRegistry()
+{
+	using namespace AIFlowBlackboardEntryValueRegistry_Private;
+
+	FCoreDelegates::OnPostEngineInit.Remove(OnPostEngineInitHandle);
+
+	FModuleManager::Get().OnModulesChanged().Remove(OnModulesChangedHandle);
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(OnReloadCompleteHandle);
+#endif // WITH_EDITOR
+
+	FRWScopeLock WriteLock(PublishedSnapshotLock, SLT_Write);
+
+	PublishedSnapshot.Reset();
+	bPublishedSnapshotDirty.store(false, std::memory_order_release);
+}
+
+FAIFlowBlackboardEntryValueRegistry::FSnapshotRef FAIFlowBlackboardEntryValueRegistry::BuildSnapshot()
+{
+	const TSharedRef<FSnapshot, ESPMode::ThreadSafe> NewSnapshot = MakeShared<FSnapshot, ESPMode::ThreadSafe>();
+
+	TArray<UClass*> Subclasses;
+	GetDerivedClasses(UFlowBlackboardEntryValue::StaticClass(), Subclasses);
+
+	// CDOs can only be created on the game thread, elsewhere we make do with the ones that already exist
+	const bool bCanCreateDefaultObjects = IsInGameThread();
+
+	NewSnapshot->EntryValueSubclasses.Reserve(Subclasses.Num());
+
+	for (UClass* Subclass : Subclasses)
+	{
+		if (Subclass->HasAnyClassFlags(CLASS_Abstract | CLASS_Deprecated | CLASS_NewerVersionExists))
+		{
+			continue;
+		}
+
+		NewSnapshot->EntryValueSubclasses.Add(Subclass);
+
+		const UFlowBlackboardEntryValue* TypedSubclassCDO = Cast<UFlowBlackboardEntryValue>(Subclass->GetDefaultObject(bCanCreateDefaultObjects));
+		if (!TypedSubclassCDO)
+		{
+			continue;
+		}
+
+		// Taking the first class found that supports the key type (as GetFlowBlackboardEntryValueClassForKeyType() always has)
+		const TSubclassOf<UBlackboardKeyType> SupportedType = TypedSubclassCDO->GetSupportedBlackboardKeyType();
+		if (SupportedType && !NewSnapshot->EntryValueSubclassBySupportedKeyType.Contains(SupportedType.Get()))
+		{
+			NewSnapshot->EntryValueSubclassBySupportedKeyType.Add(SupportedType.Get(), Subclass);
+		}
+	}
+
+	return NewSnapshot;
+}
@@ -0,0 +1,302 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Blackboard/AIFlowBlackboardExpression.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "Blackboard/FlowBlackboardEntryValue.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowBlackboardExpression)
+
+namespace AIFlowBlackboardExpression_Private
+{
+	template <typename TValue>
+	FORCEINLINE TValue ReadValue(const uint8* Memory)
+	{
+		TValue Value;
+		FMemory::Memcpy(&Value, Memory, sizeof(TValue));
+		return Value;
+	}
+
+	bool IsArithmeticValueKind(EAIFlowBlackboardExpressionValueKind ValueKind)
+	{
+		return
+			ValueKind == EAIFlowBlackboardExpressionValueKind::Float ||
+			ValueKind == EAIFlowBlackboardExpressionValueKind::Int ||
+			ValueKind == EAIFlowBlackboardExpressionValueKind::Enum;
+	}
+}
+
+void FAIFlowBlackboardExpressionProgram::Reset()
+{
+	Instructions.Reset();
+	ConstantMemory.Reset();
+	CompiledForBlackboardData.Reset();
+	bIsCompiled = false;
+
+	FailedForBlackboardData.Reset();
+	FailedForKeyTableGeneration = 0;
+}
+
+bool FAIFlowBlackboardExpressionProgram::TryClassifyKeyType(const UBlackboardKeyType& KeyType, EAIFlowBlackboardExpressionValueKind& OutValueKind)
+{
+	if (KeyType.IsA<UBlackboardKeyType_Float>())
+	{
+		OutValueKind = EAIFlowBlackboardExpressionValueKind::Float;
+	}
+	else if (KeyType.IsA<UBlackboardKeyType_Int>())
+	{
+		OutValueKind = EAIFlowBlackboardExpressionValueKind::Int;
+	}
+	else if (KeyType.IsA<UBlackboardKeyType_Enum>() || KeyType.IsA<UBlackboardKeyType_NativeEnum>())
+	{
+		OutValueKind = EAIFlowBlackboardExpressionValueKind::Enum;
+	}
+	else if (KeyType.IsA<UBlackboardKeyType_Vector>())
+	{
+		OutValueKind = EAIFlowBlackboardExpressionValueKind::Vector;
+	}
+	else if (KeyType.IsA<UBlackboardKeyType_Rotator>())
+	{
+		OutValueKind = EAIFlowBlackboardExpressionValueKind::Rotator;
+	}
+	else if (KeyType.IsA<UBlackboardKeyType_Name>())
+	{
+		OutValueKind = EAIFlowBlackboardExpressionValueKind::Name;
+	}
+	else if (KeyType.IsA<UBlackboardKeyType_Bool>())
+	{
+		OutValueKind = EAIFlowBlackboardExpressionValueKind::Bytes;
+	}
+	else
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool FAIFlowBlackboardExpressionProgram::Compile(const UBlackboardData& BlackboardData, TConstArrayView<FAIFlowBlackboardExpressionClause> Clauses, FString& OutError)
+{
+	Reset();
+
+	if (!CompileClauses(BlackboardData, Clauses, OutError))
+	{
+		Reset();
+
+		FailedForBlackboardData = &BlackboardData;
+		FailedForKeyTableGeneration = FAIFlowBlackboardKeyTable::GetGeneration();
+
+		return false;
+	}
+
+	return true;
+}
+
+bool FAIFlowBlackboardExpressionProgram::HasFailedToCompileFor(const UBlackboardData& BlackboardData) const
+{
+	return FailedForBlackboardData.Get() == &BlackboardData && FailedForKeyTableGeneration == FAIFlowBlackboardKeyTable::GetGeneration();
+}
+
+bool FAIFlowBlackboardExpressionProgram::CompileClauses(const UBlackboardData& BlackboardData, TConstArrayView<FAIFlowBlackboardExpressionClause> Clauses, FString& OutError)
+{
+	using namespace AIFlowBlackboardExpression_Private;
+
+	if (Clauses.Num() > MAX_uint16)
+	{
+		OutError = FString::Printf(TEXT("Too many clauses (%d)"), Clauses.Num());
+
+		return false;
+	}
+
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(BlackboardData);
+
+	TArray<int32, TInlineAllocator<8>> GroupStartIndices;
+	Instructions.Reserve(Clauses.Num());
+
+	for (int32 ClauseIndex = 0; ClauseIndex < Clauses.Num(); ++ClauseIndex)
+	{
+		const FAIFlowBlackboardExpressionClause& Clause = Clauses[ClauseIndex];
+
+		const FAIFlowBlackboardKeyTableEntry* LeftEntry = KeyTable->FindEntry(Clause.KeyLeft.GetKeyName());
+		if (!LeftEntry || !LeftEntry->KeyType)
+		{
+			OutError = FString::Printf(TEXT("Clause %d: blackboard %s has no key (left) %s"), ClauseIndex, *BlackboardData.GetName(), *Clause.KeyLeft.GetKeyName().ToString());
+
+			return false;
+		}
+
+		FAIFlowBlackboardExpressionInstruction& Instruction = Instructions.AddDefaulted_GetRef();
+		Instruction.LeftKeyID = LeftEntry->KeyID;
+		Instruction.ValueSize = LeftEntry->KeyType->GetValueSize();
+		Instruction.OperatorType = Clause.OperatorType;
+		Instruction.bNot = Clause.bNot;
+
+		if (!TryClassifyKeyType(*LeftEntry->KeyType, Instruction.ValueKind))
+		{
+			OutError = FString::Printf(TEXT("Clause %d: key %s has an unsupported key type %s"), ClauseIndex, *LeftEntry->KeyName.ToString(), *LeftEntry->KeyType->GetClass()->GetName());
+
+			return false;
+		}
+
+		const bool bIsArithmeticOperation =
+			Clause.OperatorType >= EPredicateCompareOperatorType::ArithmeticFirst &&
+			Clause.OperatorType <= EPredicateCompareOperatorType::ArithmeticLast;
+
+		if (bIsArithmeticOperation && !IsArithmeticValueKind(Instruction.ValueKind))
+		{
+			OutError = FString::Printf(TEXT("Clause %d: key %s does not support arithmetic comparison operations"), ClauseIndex, *LeftEntry->KeyName.ToString());
+
+			return false;
+		}
+
+		if (Clause.bUseExplicitValueForRightHandSide)
+		{
+			// Snapshot the explicit value, laid out as the left key's value
+			const uint32 Alignment = FMath::Min<uint32>(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(Instruction.ValueSize, 1)), 8);
+			const int32 ConstantOffset = Align(ConstantMemory.Num(), Alignment);
+
+			ConstantMemory.SetNumZeroed(ConstantOffset + Instruction.ValueSize);
+
+			if (!IsValid(Clause.ExplicitValueRight) ||
+				ConstantOffset > MAX_uint16 ||
+				!Clause.ExplicitValueRight->TryApplyToRawKeyMemory(*LeftEntry->KeyType, ConstantMemory.GetData() + ConstantOffset))
+			{
+				OutError = FString::Printf(TEXT("Clause %d: the explicit value (right) is missing, or does not match the type of key %s"), ClauseIndex, *LeftEntry->KeyName.ToString());
+
+				return false;
+			}
+
+			Instruction.RightConstantOffset = static_cast<uint16>(ConstantOffset);
+		}
+		else
+		{
+			const FAIFlowBlackboardKeyTableEntry* RightEntry = KeyTable->FindEntry(Clause.KeyRight.GetKeyName());
+			if (!RightEntry || !RightEntry->KeyType || RightEntry->KeyType->GetClass() != LeftEntry->KeyType->GetClass())
+			{
+				OutError = FString::Printf(TEXT("Clause %d: key (right) %s is missing, or is not the same type as key %s"), ClauseIndex, *Clause.KeyRight.GetKeyName().ToString(), *LeftEntry->KeyName.ToString());
+
+				return false;
+			}
+
+			Instruction.RightKeyID = RightEntry->KeyID;
+		}
+
+		// AND binds tighter than OR, so each OR starts a new AND group
+		if (ClauseIndex == 0 || Clause.Join == EAIFlowBlackboardExpressionJoin::Or)
+		{
+			if (ClauseIndex > 0)
+			{
+				Instructions[ClauseIndex - 1].bEndsGroup = true;
+			}
+
+			GroupStartIndices.Add(ClauseIndex);
+		}
+	}
+
+	if (!Instructions.IsEmpty())
+	{
+		Instructions.Last().bEndsGroup = true;
+	}
+
+	// A false clause skips the rest of its AND group, to the start of the next group (or the end, for false)
+	int32 GroupIndex = 0;
+	for (int32 InstructionIndex = 0; InstructionIndex < Instructions.Num(); ++InstructionIndex)
+	{
+		if (GroupStartIndices.IsValidIndex(GroupIndex + 1) && InstructionIndex >= GroupStartIndices[GroupIndex + 1])
+		{
+			++GroupIndex;
+		}
+
+		const int32 NextGroupIndex = GroupStartIndices.IsValidIndex(GroupIndex + 1) ? GroupStartIndices[GroupIndex + 1] : Instructions.Num();
+		Instructions[InstructionIndex].NextGroupIndex = static_cast<uint16>(NextGroupIndex);
+	}
+
+	CompiledForBlackboardData = &BlackboardData;
+	bIsCompiled = true;
+
+	return true;
+}
+
+bool FAIFlowBlackboardExpressionProgram::ExecuteInstruction(const FAIFlowBlackboardExpressionInstruction& Instruction, const uint8* LeftMemory, const uint8* RightMemory) const
+{
+	using namespace AIFlowBlackboardExpression_Private;
+
+	bool bResult = false;
+
+	if (Instruction.OperatorType == EPredicateCompareOperatorType::Equal || Instruction.OperatorType == EPredicateCompareOperatorType::NotEqual)
+	{
+		bool bIsEqual = false;
+
+		switch (Instruction.ValueKind)
+		{
+		case EAIFlowBlackboardExpressionValueKind::Float:
+			// As UBlackboardKeyType_Float::CompareValues, so that compiled and uncompiled compares agree
+			bIsEqual = FMath::Abs(ReadValue<float>(LeftMemory) - ReadValue<float>(RightMemory)) < UE_KINDA_SMALL_NUMBER;
+			break;
+
+		case EAIFlowBlackboardExpressionValueKind::Vector:
+			bIsEqual = ReadValue<FVector>(LeftMemory).Equals(ReadValue<FVector>(RightMemory));
+			break;
+
+		case EAIFlowBlackboardExpressionValueKind::Rotator:
+			bIsEqual = ReadValue<FRotator>(LeftMemory).Equals(ReadValue<FRotator>(RightMemory));
+			break;
+
+		case EAIFlowBlackboardExpressionValueKind::Name:
+			bIsEqual = ReadValue<FName>(LeftMemory) == ReadValue<FName>(RightMemory);
+			break;
+
+		default:
+			bIsEqual = FMemory::Memcmp(LeftMemory, RightMemory, Instruction.ValueSize) == 0;
+			break;
+		}
+
+		bResult = (bIsEqual == (Instruction.OperatorType == EPredicateCompareOperatorType::Equal));
+	}
+	else
+	{
+		double LeftValue = 0.0;
+		double RightValue = 0.0;
+
+		switch (Instruction.ValueKind)
+		{
+		case EAIFlowBlackboardExpressionValueKind::Float:
+			LeftValue = ReadValue<float>(LeftMemory);
+			RightValue = ReadValue<float>(RightMemory);
+			break;
+
+		case EAIFlowBlackboardExpressionValueKind::Int:
+			LeftValue = ReadValue<int32>(LeftMemory);
+			RightValue = ReadValue<int32>(RightMemory);
+			break;
+
+		case EAIFlowBlackboardExpressionValueKind::Enum:
+			LeftValue = ReadValue<uint8>(LeftMemory);
+			RightValue = ReadValue<uint8>(RightMemory);
+			break;
+
+		default:
+			break;
+		}
+
+		static_assert(static_cast<__underlying_type(EPredicateCompareOperatorType)>(EPredicateCompareOperatorType::Max) == 6, "This code may need updating if the enum values change");
+		switch (Instruction.OperatorType)
+		{
+		case EPredicateCompareOperatorType::Less: bResult = LeftValue < RightValue; break;
+		case EPredicateCompareOperatorType::LessOrEqual: bResult = LeftValue <= RightValue; break;
+		case EPredicateCompareOperatorType::Greater: bResult = LeftValue > RightValue; break;
+		case EPredicateCompareOperatorType::GreaterOrEqual: bResult = LeftValue >= RightValue; break;
+		default: break;
+		}
+	}
+
+	return bResult != Instruction.bNot;
+}
@@ -0,0 +1,270 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType.h"
+#include "Misc/ScopeRWLock.h"
+#include <atomic>
+#include "UObject/ObjectKey.h"
+#include "UObject/UObjectGlobals.h"
+
+#if WITH_EDITOR
+#include "Misc/TransactionObjectEvent.h"
+#endif // WITH_EDITOR
+
+namespace AIFlowBlackboardKeyTable_Private
+{
+	TMap<TObjectKey<UBlackboardData>, TSharedPtr<const FAIFlowBlackboardKeyTable, ESPMode::ThreadSafe>> CachedKeyTables;
+	FRWLock CachedKeyTablesLock;
+
+	std::atomic<uint32> Generation = 0;
+
+	FDelegateHandle OnUpdateKeysHandle;
+	FDelegateHandle OnObjectsReplacedHandle;
+	FDelegateHandle PostGarbageCollectHandle;
+
+#if WITH_EDITOR
+	FDelegateHandle OnObjectPropertyChangedHandle;
+	FDelegateHandle OnObjectTransactedHandle;
+	FDelegateHandle OnReloadCompleteHandle;
+#endif // WITH_EDITOR
+
+	void RemoveStaleKeyTables()
+	{
+		FRWScopeLock WriteLock(CachedKeyTablesLock, SLT_Write);
+
+		for (auto It = CachedKeyTables.CreateIterator(); It; ++It)
+		{
+			if (!It.Key().ResolveObjectPtr())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+}
+
+FAIFlowBlackboardKeyTableRef FAIFlowBlackboardKeyTable::Get(const UBlackboardData& BlackboardData)
+{
+	using namespace AIFlowBlackboardKeyTable_Private;
+
+	const TObjectKey<UBlackboardData> BlackboardDataKey(&BlackboardData);
+
+	{
+		FRWScopeLock ReadLock(CachedKeyTablesLock, SLT_ReadOnly);
+
+		if (const TSharedPtr<const FAIFlowBlackboardKeyTable, ESPMode::ThreadSafe>* FoundKeyTable = CachedKeyTables.Find(BlackboardDataKey))
+		{
+			return FoundKeyTable->ToSharedRef();
+		}
+	}
+
+	// Build outside of the lock, then publish (keeping the first published table if another thread raced us).
+	// The generation is captured before building, so that a table built from keys that were invalidated
+	// while it was being built is returned to this caller, but never cached.
+	const uint32 BuildGeneration = Generation.load();
+
+	const TSharedRef<FAIFlowBlackboardKeyTable, ESPMode::ThreadSafe> NewKeyTable = MakeShared<FAIFlowBlackboardKeyTable, ESPMode::ThreadSafe>();
+	NewKeyTable->Build(BlackboardData);
+
+	FRWScopeLock WriteLock(CachedKeyTablesLock, SLT_Write);
+
+	if (Generation.load() != BuildGeneration)
+	{
+		return NewKeyTable;
+	}
+
+	TSharedPtr<const FAIFlowBlackboardKeyTable, ESPMode::ThreadSafe>& KeyTable = CachedKeyTables.FindOrAdd(BlackboardDataKey);
+	if (!KeyTable.IsValid())
+	{
+		KeyTable = NewKeyTable;
+	}
+
+	return KeyTable.ToSharedRef();
+}
+
+void FAIFlowBlackboardKeyTable::InvalidateAll()
+{
+	using namespace AIFlowBlackboardKeyTable_Private;
+
+	// Tables that are still referenced are freed when they are released (their holders must not outlive the current scope)
+	FRWScopeLock WriteLock(CachedKeyTablesLock, SLT_Write);
+
+	CachedKeyTables.Reset();
+
+	++Generation;
+}
+
+void FAIFlowBlackboardKeyTable::Invalidate(const UBlackboardData& BlackboardData)
+{
+	using namespace AIFlowBlackboardKeyTable_Private;
+
+	FRWScopeLock WriteLock(CachedKeyTablesLock, SLT_Write);
+
+	// The tables of blackboards that derive from BlackboardData include its keys, so they are discarded too
+	for (auto It = CachedKeyTables.CreateIterator(); It; ++It)
+	{
+		const UBlackboardData* CachedBlackboardData = It.Key().ResolveObjectPtr();
+
+		bool bIncludesBlackboardData = (CachedBlackboardData == nullptr);
+		for (const UBlackboardData* Data = CachedBlackboardData; Data && !bIncludesBlackboardData; Data = Data->Parent)
+		{
+			bIncludesBlackboardData = (Data == &BlackboardData);
+		}
+
+		if (bIncludesBlackboardData)
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	++Generation;
+}
+
+uint32 FAIFlowBlackboardKeyTable::GetGeneration()
+{
+	return AIFlowBlackboardKeyTable_Private::Generation.load();
+}
+
+void FAIFlowBlackboardKeyTable::StartupKeyTables()
+{
+	using namespace AIFlowBlackboardKeyTable_Private;
+
+	// A key change also affects the tables of derived blackboards (which Invalidate discards along with the blackboard's own)
+	OnUpdateKeysHandle = UBlackboardData::OnUpdateKeys.AddLambda(
+		[](UBlackboardData* BlackboardData)
+		{
+			if (BlackboardData)
+			{
+				Invalidate(*BlackboardData);
+			}
+			else
+			{
+				InvalidateAll();
+			}
+		});
+	OnObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddLambda([](const TMap<UObject*, UObject*>&) { InvalidateAll(); });
+	PostGarbageCollectHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddStatic(&RemoveStaleKeyTables);
+
+#if WITH_EDITOR
+	OnObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddLambda(
+		[](UObject* Object, FPropertyChangedEvent&)
+		{
+			if (const UBlackboardData* BlackboardData = Cast<UBlackboardData>(Object))
+			{
+				Invalidate(*BlackboardData);
+			}
+		});
+
+	OnObjectTransactedHandle = FCoreUObjectDelegates::OnObjectTransacted.AddLambda(
+		[](UObject* Object, const FTransactionObjectEvent&)
+		{
+			if (const UBlackboardData* BlackboardData = Cast<UBlackboardData>(Object))
+			{
+				Invalidate(*BlackboardData);
+			}
+		});
+
+	OnReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([](EReloadCompleteReason) { InvalidateAll(); });
+#endif // WITH_EDITOR
+}
+
+void FAIFlowBlackboardKeyTable::ShutdownKeyTables()
+{
+	using namespace AIFlowBlackboardKeyTable_Private;
+
+	UBlackboardData::OnUpdateKeys.Remove(OnUpdateKeysHandle);
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(OnObjectsReplacedHandle);
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(PostGarbageCollectHandle);
+
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectPropertyChanged.Remove(OnObjectPropertyChangedHandle);
+	FCoreUObjectDelegates::OnObjectTransacted.Remove(OnObjectTransactedHandle);
+	FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(OnReloadCompleteHandle);
+#endif // WITH_EDITOR
+
+	InvalidateAll();
+}
+
+void FAIFlowBlackboardKeyTable::Build(const UBlackboardData& BlackboardData)
+{
+	// Flatten the keys in the same order that UBlackboardData::GetKeyID() searches them
+	for (const UBlackboardData* It = &BlackboardData; It; It = It->Parent)
+	{
+		const FBlackboard::FKey FirstKeyID = It->GetFirstKeyID();
+
+		for (int32 KeyIndex = 0; KeyIndex < It->Keys.Num(); ++KeyIndex)
+		{
+			const FBlackboardEntry& BlackboardEntry = It->Keys[KeyIndex];
+
+			FAIFlowBlackboardKeyTableEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.KeyName = BlackboardEntry.EntryName;
+			Entry.KeyID = static_cast<FBlackboard::FKey>(FirstKeyID + KeyIndex);
+			Entry.KeyType = BlackboardEntry.KeyType;
+		}
+	}
+
+	const uint32 NumSlots = FMath::RoundUpToPowerOfTwo(FMath::Max(2 * Entries.Num(), 8));
+	SlotMask = NumSlots - 1;
+	Slots.Init(INDEX_NONE, NumSlots);
+
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		const FName& KeyName = Entries[EntryIndex].KeyName;
+
+		uint32 SlotIndex = GetTypeHash(KeyName) & SlotMask;
+		while (Slots[SlotIndex] != INDEX_NONE)
+		{
+			// A duplicate name is shadowed by the earlier entry (as it is in UBlackboardData::GetKeyID())
+			if (Entries[Slots[SlotIndex]].KeyName == KeyName)
+			{
+				break;
+			}
+
+			SlotIndex = (SlotIndex + 1) & SlotMask;
+		}
+
+		if (Slots[SlotIndex] == INDEX_NONE)
+		{
+			Slots[SlotIndex] = EntryIndex;
+		}
+	}
+}
+
+int32 FAIFlowBlackboardKeyTable::FindEntryIndex(const FName& KeyName) const
+{
+	if (Slots.IsEmpty() || KeyName.IsNone())
+	{
+		return INDEX_NONE;
+	}
+
+	uint32 SlotIndex = GetTypeHash(KeyName) & SlotMask;
+	while (Slots[SlotIndex] != INDEX_NONE)
+	{
+		const int32 EntryIndex = Slots[SlotIndex];
+		if (Entries[EntryIndex].KeyName == KeyName)
+		{
+			return EntryIndex;
+		}
+
+		SlotIndex = (SlotIndex + 1) & SlotMask;
+	}
+
+	return INDEX_NONE;
+}
+
+const FAIFlowBlackboardKeyTableEntry* FAIFlowBlackboardKeyTable::FindEntry(const FName& KeyName) const
+{
+	const int32 EntryIndex = FindEntryIndex(KeyName);
+	return Entries.IsValidIndex(EntryIndex) ? &Entries[EntryIndex] : nullptr;
+}
+
+FBlackboard::FKey FAIFlowBlackboardKeyTable::FindKeyID(const FName& KeyName) const
+{
+	const FAIFlowBlackboardKeyTableEntry* Entry = FindEntry(KeyName);
+	return Entry ? Entry->KeyID : FBlackboard::InvalidKey;
+}
+
+UBlackboardKeyType* FAIFlowBlackboardKeyTable::FindKeyType(const FName& KeyName) const
+{
+	const FAIFlowBlackboardKeyTableEntry* Entry = FindEntry(KeyName);
+	return Entry ? Entry->KeyType : nullptr;
+}
@@ -0,0 +1,61 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Blackboard/AIFlowColumnarBlackboardComponent.h"
+#include "Subsystems/AIFlowColumnarBlackboardSubsystem.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowColumnarBlackboardComponent)
+
+void UAIFlowColumnarBlackboardComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Components with a default blackboard asset are initialized by now (flow-created components sync after InitializeBlackboard)
+	SyncColumnarStoreRegistration();
+}
+
+void UAIFlowColumnarBlackboardComponent::OnUnregister()
+{
+	UnregisterFromColumnarStore();
+
+	Super::OnUnregister();
+}
+
+void UAIFlowColumnarBlackboardComponent::SyncColumnarStoreRegistration()
+{
+	const UBlackboardData* CurrentBlackboardAsset = GetBlackboardAsset();
+	if (IsRegisteredWithColumnarStore() && RegisteredBlackboardAsset.Get() == CurrentBlackboardAsset)
+	{
+		return;
+	}
+
+	UnregisterFromColumnarStore();
+
+	UWorld* World = GetWorld();
+	UAIFlowColumnarBlackboardSubsystem* ColumnarSubsystem = World ? World->GetSubsystem<UAIFlowColumnarBlackboardSubsystem>() : nullptr;
+	if (!IsValid(CurrentBlackboardAsset) || !IsValid(ColumnarSubsystem))
+	{
+		return;
+	}
+
+	ColumnarSubsystem->RegisterComponent(*this);
+
+	RegisteredBlackboardAsset = CurrentBlackboardAsset;
+}
+
+void UAIFlowColumnarBlackboardComponent::UnregisterFromColumnarStore()
+{
+	if (!IsRegisteredWithColumnarStore())
+	{
+		return;
+	}
+
+	RegisteredBlackboardAsset.Reset();
+
+	UWorld* World = GetWorld();
+	if (UAIFlowColumnarBlackboardSubsystem* ColumnarSubsystem = World ? World->GetSubsystem<UAIFlowColumnarBlackboardSubsystem>() : nullptr)
+	{
+		ColumnarSubsystem->UnregisterComponent(*this);
+	}
+}
@@ -0,0 +1,126 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Blackboard/AIFlowDistanceKernel.h"
+#include "AISystem.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+#include "Math/VectorRegister.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowDistanceKernel)
+
+void FAIFlowDistanceBatch::Reset(const FVector& InQueryPoint, int32 ExpectedNum)
+{
+	QueryPoint = InQueryPoint;
+
+	OffsetsX.Reset(ExpectedNum);
+	OffsetsY.Reset(ExpectedNum);
+	OffsetsZ.Reset(ExpectedNum);
+	IsValidLocation.Reset(ExpectedNum);
+}
+
+int32 FAIFlowDistanceBatch::AddLocation(const FVector& Location)
+{
+	if (!FAISystem::IsValidLocation(Location))
+	{
+		return AddInvalidLocation();
+	}
+
+	const FVector Offset = Location - QueryPoint;
+
+	OffsetsX.Add(static_cast<float>(Offset.X));
+	OffsetsY.Add(static_cast<float>(Offset.Y));
+	OffsetsZ.Add(static_cast<float>(Offset.Z));
+
+	return IsValidLocation.Add(true);
+}
+
+int32 FAIFlowDistanceBatch::AddInvalidLocation()
+{
+	OffsetsX.Add(0.0f);
+	OffsetsY.Add(0.0f);
+	OffsetsZ.Add(0.0f);
+
+	return IsValidLocation.Add(false);
+}
+
+void FAIFlowDistanceBatch::AddBlackboardVectorKeys(TConstArrayView<const UBlackboardComponent*> BlackboardComponents, FBlackboard::FKey VectorKeyID)
+{
+	for (const UBlackboardComponent* BlackboardComponent : BlackboardComponents)
+	{
+		const UBlackboardData* BlackboardData = BlackboardComponent ? BlackboardComponent->GetBlackboardAsset() : nullptr;
+		const FBlackboardEntry* BlackboardEntry = BlackboardData ? BlackboardData->GetKey(VectorKeyID) : nullptr;
+		const UBlackboardKeyType_Vector* VectorKeyType = BlackboardEntry ? Cast<UBlackboardKeyType_Vector>(BlackboardEntry->KeyType) : nullptr;
+		const uint8* RawData = VectorKeyType ? BlackboardComponent->GetKeyRawData(VectorKeyID) : nullptr;
+
+		if (RawData && VectorKeyType)
+		{
+			(void) AddLocation(UBlackboardKeyType_Vector::GetValue(VectorKeyType, RawData));
+		}
+		else
+		{
+			(void) AddInvalidLocation();
+		}
+	}
+}
+
+void FAIFlowDistanceBatch::Test(EAIFlowDistanceCompare Compare, double Radius, bool bIgnoreZ, TArray<bool>& OutResults) const
+{
+	const int32 NumLocations = Num();
+	OutResults.SetNumUninitialized(NumLocations);
+
+	const float RadiusSquared = static_cast<float>(FMath::Square(Radius));
+	const VectorRegister4Float RadiusSquaredVector = VectorSetFloat1(RadiusSquared);
+	const bool bWithin = (Compare == EAIFlowDistanceCompare::WithinRadius);
+
+	const float* X = OffsetsX.GetData();
+	const float* Y = OffsetsY.GetData();
+	const float* Z = OffsetsZ.GetData();
+
+	int32 Index = 0;
+	for (; Index + 4 <= NumLocations; Index += 4)
+	{
+		const VectorRegister4Float OffsetX = VectorLoad(X + Index);
+		const VectorRegister4Float OffsetY = VectorLoad(Y + Index);
+
+		VectorRegister4Float DistanceSquared = VectorMultiplyAdd(OffsetY, OffsetY, VectorMultiply(OffsetX, OffsetX));
+		if (!bIgnoreZ)
+		{
+			const VectorRegister4Float OffsetZ = VectorLoad(Z + Index);
+			DistanceSquared = VectorMultiplyAdd(OffsetZ, OffsetZ, DistanceSquared);
+		}
+
+		const VectorRegister4Float Mask = bWithin ? VectorCompareLE(DistanceSquared, RadiusSquaredVector) : VectorCompareGT(DistanceSquared, RadiusSquaredVector);
+		const uint32 MaskBits = static_cast<uint32>(VectorMaskBits(Mask));
+
+		for (uint32 Lane = 0; Lane < 4; ++Lane)
+		{
+			OutResults[Index + Lane] = IsValidLocation[Index + Lane] && (MaskBits & (1u << Lane)) != 0;
+		}
+	}
+
+	for (; Index < NumLocations; ++Index)
+	{
+		const float DistanceSquared = X[Index] * X[Index] + Y[Index] * Y[Index] + (bIgnoreZ ? 0.0f : Z[Index] * Z[Index]);
+		OutResults[Index] = IsValidLocation[Index] && (bWithin ? DistanceSquared <= RadiusSquared : DistanceSquared > RadiusSquared);
+	}
+}
+
+bool FAIFlowDistanceBatch::TestPair(const FVector& LocationA, const FVector& LocationB, EAIFlowDistanceCompare Compare, double Radius, bool bIgnoreZ)
+{
+	if (!FAISystem::IsValidLocation(LocationA) || !FAISystem::IsValidLocation(LocationB))
+	{
+		return false;
+	}
+
+	VectorRegister4Double Delta = VectorSubtract(VectorLoadFloat3_W0(&LocationA.X), VectorLoadFloat3_W0(&LocationB.X));
+	if (bIgnoreZ)
+	{
+		Delta = VectorMultiply(Delta, MakeVectorRegisterDouble(1.0, 1.0, 0.0, 0.0));
+	}
+
+	const double DistanceSquared = VectorGetComponent(VectorDot3(Delta, Delta), 0);
+	const double RadiusSquared = FMath::Square(Radius);
+
+	return (Compare == EAIFlowDistanceCompare::WithinRadius) ? DistanceSquared <= RadiusSquared : DistanceSquared > RadiusSquared;
+}
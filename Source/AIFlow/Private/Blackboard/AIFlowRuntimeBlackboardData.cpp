@@ -0,0 +1,176 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Blackboard/AIFlowRuntimeBlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+namespace AIFlowRuntimeBlackboardData_Private
+{
+	struct FSharedBlackboardData
+	{
+		FString ContentSignature;
+		TWeakObjectPtr<UBlackboardData> BlackboardData;
+	};
+
+	// Shared blackboard data, keyed by the hash of their content signature.
+	// Shared by all worlds in the process, since the blackboard data is content-addressed (and so is not world-specific)
+	TMultiMap<uint32, FSharedBlackboardData> SharedBlackboardDataByHash;
+
+	void RemoveStaleSharedBlackboardData()
+	{
+		for (auto It = SharedBlackboardDataByHash.CreateIterator(); It; ++It)
+		{
+			if (!It.Value().BlackboardData.IsValid())
+			{
+				It.RemoveCurrent();
+			}
+		}
+	}
+
+	void AppendRuntimeKeys(UBlackboardData& RuntimeBlackboardData, TConstArrayView<FBlackboardEntry> RuntimeKeys)
+	{
+		RuntimeBlackboardData.Keys.Reserve(RuntimeBlackboardData.Keys.Num() + RuntimeKeys.Num());
+
+		for (const FBlackboardEntry& RuntimeKey : RuntimeKeys)
+		{
+			FBlackboardEntry& NewKey = RuntimeBlackboardData.Keys.Add_GetRef(RuntimeKey);
+
+			// The key types are instanced, so the runtime data needs its own copies
+			if (RuntimeKey.KeyType)
+			{
+				NewKey.KeyType = DuplicateObject<UBlackboardKeyType>(RuntimeKey.KeyType, &RuntimeBlackboardData);
+			}
+		}
+	}
+}
+
+UBlackboardData* FAIFlowRuntimeBlackboardDataRegistry::FindOrCreateShared(UBlackboardData& BaseBlackboardData, TConstArrayView<FBlackboardEntry> RuntimeKeys)
+{
+	using namespace AIFlowRuntimeBlackboardData_Private;
+
+	// Creates UObjects and mutates the (game thread only) registry
+	check(IsInGameThread());
+
+	const FString ContentSignature = BuildContentSignature(BaseBlackboardData, RuntimeKeys);
+	const uint32 ContentHash = GetTypeHash(ContentSignature);
+
+	TArray<FSharedBlackboardData*, TInlineAllocator<2>> Candidates;
+	SharedBlackboardDataByHash.MultiFindPointer(ContentHash, Candidates);
+
+	for (const FSharedBlackboardData* Candidate : Candidates)
+	{
+		// Compare the full signature, in case of a hash collision
+		UBlackboardData* CandidateBlackboardData = Candidate->BlackboardData.Get();
+		if (IsValid(CandidateBlackboardData) && Candidate->ContentSignature == ContentSignature)
+		{
+			return CandidateBlackboardData;
+		}
+	}
+
+	RemoveStaleSharedBlackboardData();
+
+	UBlackboardData* SharedBlackboardData = CreateUnshared(*GetTransientPackage(), BaseBlackboardData, RuntimeKeys);
+
+	FSharedBlackboardData& NewShared = SharedBlackboardDataByHash.Add(ContentHash);
+	NewShared.ContentSignature = ContentSignature;
+	NewShared.BlackboardData = SharedBlackboardData;
+
+	return SharedBlackboardData;
+}
+
+UBlackboardData* FAIFlowRuntimeBlackboardDataRegistry::CreateUnshared(UObject& Outer, UBlackboardData& BaseBlackboardData, TConstArrayView<FBlackboardEntry> RuntimeKeys)
+{
+	const FName RuntimeName = MakeUniqueObjectName(&Outer, UBlackboardData::StaticClass(), *FString::Printf(TEXT("%s_Runtime"), *BaseBlackboardData.GetName()));
+	UBlackboardData* RuntimeBlackboardData = NewObject<UBlackboardData>(&Outer, RuntimeName, RF_Transient);
+
+	// Extend the base blackboard as a child, so its keys (and KeyIDs) are unchanged
+	RuntimeBlackboardData->Parent = &BaseBlackboardData;
+
+	AIFlowRuntimeBlackboardData_Private::AppendRuntimeKeys(*RuntimeBlackboardData, RuntimeKeys);
+
+	UpdateRuntimeKeys(*RuntimeBlackboardData);
+
+	return RuntimeBlackboardData;
+}
+
+UBlackboardData* FAIFlowRuntimeBlackboardDataRegistry::CloneUnshared(UObject& Outer, const UBlackboardData& SourceBlackboardData)
+{
+	UBlackboardData* ClonedBlackboardData = DuplicateObject<UBlackboardData>(&SourceBlackboardData, &Outer);
+	ClonedBlackboardData->SetFlags(RF_Transient);
+
+	UpdateRuntimeKeys(*ClonedBlackboardData);
+
+	return ClonedBlackboardData;
+}
+
+bool FAIFlowRuntimeBlackboardDataRegistry::IsShared(const UBlackboardData& BlackboardData)
+{
+	for (const TPair<uint32, AIFlowRuntimeBlackboardData_Private::FSharedBlackboardData>& Pair : AIFlowRuntimeBlackboardData_Private::SharedBlackboardDataByHash)
+	{
+		if (Pair.Value.BlackboardData.Get() == &BlackboardData)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int32 FAIFlowRuntimeBlackboardDataRegistry::GetNumShared()
+{
+	int32 NumShared = 0;
+
+	for (const TPair<uint32, AIFlowRuntimeBlackboardData_Private::FSharedBlackboardData>& Pair : AIFlowRuntimeBlackboardData_Private::SharedBlackboardDataByHash)
+	{
+		if (Pair.Value.BlackboardData.IsValid())
+		{
+			++NumShared;
+		}
+	}
+
+	return NumShared;
+}
+
+void FAIFlowRuntimeBlackboardDataRegistry::UpdateRuntimeKeys(UBlackboardData& RuntimeBlackboardData)
+{
+	// Rebuilds the ParentKeys and the KeyIDs
+	RuntimeBlackboardData.UpdateParentKeys();
+	RuntimeBlackboardData.UpdateKeyIDs();
+}
+
+FString FAIFlowRuntimeBlackboardDataRegistry::BuildContentSignature(const UBlackboardData& BaseBlackboardData, TConstArrayView<FBlackboardEntry> RuntimeKeys)
+{
+	TStringBuilder<1024> Signature;
+	Signature << BaseBlackboardData.GetPathName();
+
+	for (const FBlackboardEntry& RuntimeKey : RuntimeKeys)
+	{
+		Signature << TEXT('|') << RuntimeKey.EntryName << TEXT(':') << (RuntimeKey.bInstanceSynced ? TEXT('S') : TEXT('-'));
+
+		const UBlackboardKeyType* KeyType = RuntimeKey.KeyType;
+		if (!KeyType)
+		{
+			continue;
+		}
+
+		Signature << TEXT(':') << KeyType->GetClass()->GetPathName();
+
+		// Include the key type's configuration (eg, the BaseClass of an Object key, or the EnumType of an Enum key)
+		for (TFieldIterator<FProperty> PropertyIt(KeyType->GetClass()); PropertyIt; ++PropertyIt)
+		{
+			const FProperty* Property = *PropertyIt;
+			if (!Property->HasAnyPropertyFlags(CPF_Edit) || Property->HasAnyPropertyFlags(CPF_Transient))
+			{
+				continue;
+			}
+
+			FString ValueText;
+			Property->ExportTextItem_InContainer(ValueText, KeyType, nullptr, nullptr, PPF_None);
+
+			Signature << TEXT(',') << Property->GetFName() << TEXT('=') << ValueText;
+		}
+	}
+
+	return FString(Signature.ToView());
+}
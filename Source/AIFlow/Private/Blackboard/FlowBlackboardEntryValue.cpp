@@ -1,12 +1,11 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "Blackboard/FlowBlackboardEntryValue.h"
+#include "Blackboard/AIFlowBlackboardEntryValueRegistry.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowBlackboardEntryValue)
 
-TArray<TWeakObjectPtr<UClass>> UFlowBlackboardEntryValue::CachedBlackboardEntryValueSubclassArray;
-
 UBlackboardData* UFlowBlackboardEntryValue::GetBlackboardAsset() const
 {
 	if (IFlowBlackboardAssetProvider* OuterProvider = Cast<IFlowBlackboardAssetProvider>(GetOuter()))
@@ -17,22 +16,10 @@ UBlackboardData* UFlowBlackboardEntryValue::GetBlackboardAsset() const
 	return nullptr;
 }
 
-const TArray<TWeakObjectPtr<UClass>>& UFlowBlackboardEntryValue::EnsureBlackboardEntryValueSubclassArray()
+TArray<TWeakObjectPtr<UClass>> UFlowBlackboardEntryValue::EnsureBlackboardEntryValueSubclassArray()
 {
-	// NOTE (gtaylor) Potentially vulnerable to modules loading in subclasses after this initial caching
-
-	if (CachedBlackboardEntryValueSubclassArray.IsEmpty())
-	{
-		TArray<UClass*> Subclasses;
-		GetDerivedClasses(UFlowBlackboardEntryValue::StaticClass(), Subclasses);
-
-		for (UClass* Subclass : Subclasses)
-		{
-			CachedBlackboardEntryValueSubclassArray.Add(Subclass);
-		}
-	}
-
-	return CachedBlackboardEntryValueSubclassArray;
+	// Copied, as the snapshot may be replaced (and released) once the ref is dropped
+	return FAIFlowBlackboardEntryValueRegistry::GetSnapshot()->EntryValueSubclasses;
 }
 
 #if WITH_EDITOR
@@ -77,25 +64,11 @@ TSubclassOf<UFlowBlackboardEntryValue> UFlowBlackboardEntryValue::GetFlowBlackbo
 		return nullptr;
 	}
 
-	TArray<UClass*> Subclasses;
-	GetDerivedClasses(UFlowBlackboardEntryValue::StaticClass(), Subclasses);
+	// NOTE (gtaylor) Taking the first class found that supports the KeyTypeClass.
+	//  We could, instead, keep searching and resolve between multiple possible choices with a "best fit" algorithm of some sort.
+	//  But that's overkill at this point, since we don't have any expectation that that is a case we will need to support.
 
-	for (UClass* Subclass : Subclasses)
-	{
-		const UFlowBlackboardEntryValue* TypedSubclassCDO = Cast<UFlowBlackboardEntryValue>(Subclass->GetDefaultObject());
-
-		TSubclassOf<UBlackboardKeyType> SupportedType = TypedSubclassCDO->GetSupportedBlackboardKeyType();
-		if (SupportedType && KeyTypeClass->IsChildOf(SupportedType))
-		{
-			// NOTE (gtaylor) Taking the first class found that supports the KeyTypeClass.
-			//  We could, instead, keep searching and resolve between multiple possible choices with a "best fit" algorithm of some sort.
-			//  But that's overkill at this point, since we don't have any expectation that that is a case we will need to support.
-
-			return Subclass;
-		}
-	}
-
-	return nullptr;
+	return FAIFlowBlackboardEntryValueRegistry::FindEntryValueSubclassForKeyType(KeyTypeClass);
 }
 
 #endif // WITH_EDITOR
\ No newline at end of file
@@ -65,10 +65,15 @@ void UFlowBlackboardEntryValue_Bool::SetOnBlackboardComponent(UBlackboardCompone
 {
 	if (IsValid(BlackboardComponent))
 	{
-		BlackboardComponent->SetValueAsBool(Key.GetKeyName(), bBoolValue);
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
 	}
 }
 
+void UFlowBlackboardEntryValue_Bool::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	BlackboardComponent.SetValue<UBlackboardKeyType_Bool>(KeyID, bBoolValue);
+}
+
 EBlackboardCompare::Type UFlowBlackboardEntryValue_Bool::CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const
 {
 	if (!IsValid(BlackboardComponent))
@@ -94,3 +99,26 @@ TSubclassOf<UBlackboardKeyType> UFlowBlackboardEntryValue_Bool::GetSupportedBlac
 	return UBlackboardKeyType_Bool::StaticClass();
 }
 
+bool UFlowBlackboardEntryValue_Bool::TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const
+{
+	return TryApplyToRawKeyMemoryTemplate<UBlackboardKeyType_Bool>(KeyType, RawKeyMemory, bBoolValue);
+}
+
+EBlackboardCompare::Type UFlowBlackboardEntryValue_Bool::CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const
+{
+	bool OtherValue;
+	if (!TryGetValueFromRawKeyMemoryTemplate<UBlackboardKeyType_Bool>(KeyType, RawKeyMemory, OtherValue))
+	{
+		return EBlackboardCompare::NotEqual;
+	}
+
+	return (bBoolValue == OtherValue) ? EBlackboardCompare::Equal : EBlackboardCompare::NotEqual;
+}
+
+bool UFlowBlackboardEntryValue_Bool::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+	const UBlackboardKeyType& KeyType,
+	const uint8* RawKeyMemory,
+	TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const
+{
+	return TryProvideFlowDataPinPropertyFromRawKeyMemoryTemplate<UBlackboardKeyType_Bool, FFlowDataPinValue_Bool>(KeyType, RawKeyMemory, OutFlowDataPinProperty);
+}
@@ -151,10 +151,15 @@ void UFlowBlackboardEntryValue_Class::SetOnBlackboardComponent(UBlackboardCompon
 {
 	if (IsValid(BlackboardComponent))
 	{
-		BlackboardComponent->SetValueAsClass(Key.GetKeyName(), ClassInstance);
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
 	}
 }
 
+void UFlowBlackboardEntryValue_Class::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	BlackboardComponent.SetValue<UBlackboardKeyType_Class>(KeyID, ClassInstance);
+}
+
 EBlackboardCompare::Type UFlowBlackboardEntryValue_Class::CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const
 {
 	if (!IsValid(BlackboardComponent))
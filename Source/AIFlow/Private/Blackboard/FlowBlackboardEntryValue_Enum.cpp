@@ -1,6 +1,7 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "Blackboard/FlowBlackboardEntryValue_Enum.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "AIFlowLogChannels.h"
@@ -103,19 +104,7 @@ bool UFlowBlackboardEntryValue_Enum::TryUpdateEnumTypesFromKey()
 		return false;
 	}
 
-	const FBlackboard::FKey KeyID = BlackboardData->GetKeyID(Key.GetKeyName());
-	if (KeyID == FBlackboard::InvalidKey)
-	{
-		return false;
-	}
-
-	const FBlackboardEntry* BlackboardEntry = BlackboardData->GetKey(KeyID);
-	if (!BlackboardEntry)
-	{
-		return false;
-	}
-
-	const UBlackboardKeyType_Enum* KeyTypeEnum = Cast<UBlackboardKeyType_Enum>(BlackboardEntry->KeyType);
+	const UBlackboardKeyType_Enum* KeyTypeEnum = Cast<UBlackboardKeyType_Enum>(FAIFlowBlackboardKeyTable::Get(*BlackboardData)->FindKeyType(Key.GetKeyName()));
 	if (!IsValid(KeyTypeEnum))
 	{
 		return false;
@@ -165,6 +154,31 @@ bool UFlowBlackboardEntryValue_Enum::TryProvideFlowDataPinProperty(TInstancedStr
 	return true;
 }
 
+namespace FlowBlackboardEntryValue_Enum_Private
+{
+	bool TryProvideEnumFlowDataPinProperty(
+		const UBlackboardKeyType_Enum& TypedKeyType,
+		UBlackboardKeyType_Enum::FDataType IntValue,
+		TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty)
+	{
+		UEnum* EnumClass = TypedKeyType.EnumType;
+		if (!IsValid(EnumClass))
+		{
+			return false;
+		}
+
+		const int32 EnumValueIndex = EnumClass->GetIndexByValue(IntValue);
+		const FName EnumValueName = FName(EnumClass->GetDisplayNameTextByIndex(EnumValueIndex).ToString());
+
+		OutFlowDataPinProperty.InitializeAs<FFlowDataPinValue_Enum>(EnumClass, EnumValueName);
+
+		FFlowDataPinValue_Enum* MutableProperty = OutFlowDataPinProperty.GetMutablePtr<FFlowDataPinValue_Enum>();
+		MutableProperty->EnumClass = TypedKeyType.EnumType;
+
+		return true;
+	}
+}
+
 bool UFlowBlackboardEntryValue_Enum::TryProvideFlowDataPinPropertyFromBlackboardEntry(
 	const FName& BlackboardKeyName,
 	const UBlackboardKeyType& BlackboardKeyType,
@@ -175,29 +189,52 @@ bool UFlowBlackboardEntryValue_Enum::TryProvideFlowDataPinPropertyFromBlackboard
 	{
 		const UBlackboardKeyType_Enum* TypedKeyType = CastChecked<UBlackboardKeyType_Enum>(&BlackboardKeyType);
 
-		UEnum* EnumClass = TypedKeyType->EnumType;
-		if (!IsValid(EnumClass))
-		{
-			return false;
-		}
-
 		const UBlackboardKeyType_Enum::FDataType IntValue =
 			OptionalBlackboardComponent ?
 				OptionalBlackboardComponent->GetValue<UBlackboardKeyType_Enum>(BlackboardKeyName) :
 				UBlackboardKeyType_Enum::InvalidValue;
 
-		const int32 EnumValueIndex = EnumClass->GetIndexByValue(IntValue);
-		const FName EnumValueName = FName(EnumClass->GetDisplayNameTextByIndex(EnumValueIndex).ToString());
+		return FlowBlackboardEntryValue_Enum_Private::TryProvideEnumFlowDataPinProperty(*TypedKeyType, IntValue, OutFlowDataPinProperty);
+	}
 
-		OutFlowDataPinProperty.InitializeAs<FFlowDataPinValue_Enum>(EnumClass, EnumValueName);
+	return false;
+}
 
-		FFlowDataPinValue_Enum* MutableProperty = OutFlowDataPinProperty.GetMutablePtr<FFlowDataPinValue_Enum>();
-		MutableProperty->EnumClass = TypedKeyType->EnumType;
+bool UFlowBlackboardEntryValue_Enum::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+	const UBlackboardKeyType& KeyType,
+	const uint8* RawKeyMemory,
+	TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const
+{
+	UBlackboardKeyType_Enum::FDataType IntValue = UBlackboardKeyType_Enum::InvalidValue;
+	if (!TryGetValueFromRawKeyMemoryTemplate<UBlackboardKeyType_Enum>(KeyType, RawKeyMemory, IntValue))
+	{
+		return false;
+	}
 
-		return true;
+	return FlowBlackboardEntryValue_Enum_Private::TryProvideEnumFlowDataPinProperty(*CastChecked<UBlackboardKeyType_Enum>(&KeyType), IntValue, OutFlowDataPinProperty);
+}
+
+bool UFlowBlackboardEntryValue_Enum::TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const
+{
+	if (!EnumValue.EnumClass)
+	{
+		return false;
 	}
 
-	return false;
+	const uint64 EnumValueAsInt = EnumValue.EnumClass->GetValueByName(EnumValue.Value);
+	return TryApplyToRawKeyMemoryTemplate<UBlackboardKeyType_Enum>(KeyType, RawKeyMemory, static_cast<UBlackboardKeyType_Enum::FDataType>(EnumValueAsInt));
+}
+
+EBlackboardCompare::Type UFlowBlackboardEntryValue_Enum::CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const
+{
+	UBlackboardKeyType_Enum::FDataType OtherValueAsEnumInt = UBlackboardKeyType_Enum::InvalidValue;
+	if (!EnumValue.EnumClass || !TryGetValueFromRawKeyMemoryTemplate<UBlackboardKeyType_Enum>(KeyType, RawKeyMemory, OtherValueAsEnumInt))
+	{
+		return EBlackboardCompare::NotEqual;
+	}
+
+	const uint64 EnumValueAsInt = EnumValue.EnumClass->GetValueByName(EnumValue.Value);
+	return (EnumValueAsInt == OtherValueAsEnumInt) ? EBlackboardCompare::Equal : EBlackboardCompare::NotEqual;
 }
 
 FFlowDataPinResult_Enum UFlowBlackboardEntryValue_Enum::TryBuildDataPinResultFromBlackboardEnumEntry(const FName& KeyName, const UBlackboardComponent& BlackboardComponent)
@@ -210,17 +247,15 @@ FFlowDataPinResult_Enum UFlowBlackboardEntryValue_Enum::TryBuildDataPinResultFro
 		return FFlowDataPinResult_Enum(EFlowDataPinResolveResult::FailedWithError);
 	}
 
-	const FBlackboard::FKey BlackboardEntryKeyID = BlackboardAsset->GetKeyID(KeyName);
-	if (BlackboardEntryKeyID == FBlackboard::InvalidKey)
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(*BlackboardAsset);
+	const FAIFlowBlackboardKeyTableEntry* KeyTableEntry = KeyTable->FindEntry(KeyName);
+	if (!KeyTableEntry)
 	{
 		UE_LOG(LogAIFlow, Error, TEXT("Cannot find key %s on blackboard %s!"), *KeyName.ToString(), *BlackboardAsset->GetName());
 		return FFlowDataPinResult_Enum(EFlowDataPinResolveResult::FailedWithError);
 	}
 
-	const FBlackboardEntry* BlackboardEntry = BlackboardAsset->GetKey(BlackboardEntryKeyID);
-	check(BlackboardEntry);
-
-	const UBlackboardKeyType_Enum* BlackboardEnumKeyType = Cast<UBlackboardKeyType_Enum>(BlackboardEntry->KeyType);
+	const UBlackboardKeyType_Enum* BlackboardEnumKeyType = Cast<UBlackboardKeyType_Enum>(KeyTableEntry->KeyType);
 	if (!IsValid(BlackboardEnumKeyType))
 	{
 		UE_LOG(LogAIFlow, Error, TEXT("Key %s on blackboard %s, is not an enum type!"), *KeyName.ToString(), *BlackboardAsset->GetName());
@@ -241,9 +276,17 @@ FFlowDataPinResult_Enum UFlowBlackboardEntryValue_Enum::TryBuildDataPinResultFro
 void UFlowBlackboardEntryValue_Enum::SetOnBlackboardComponent(UBlackboardComponent* BlackboardComponent) const
 {
 	if (IsValid(BlackboardComponent))
+	{
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
+	}
+}
+
+void UFlowBlackboardEntryValue_Enum::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	if (EnumValue.EnumClass)
 	{
 		const uint64 EnumValueAsInt = EnumValue.EnumClass->GetValueByName(EnumValue.Value);
-		BlackboardComponent->SetValueAsEnum(Key.GetKeyName(), EnumValueAsInt);
+		BlackboardComponent.SetValue<UBlackboardKeyType_Enum>(KeyID, static_cast<UBlackboardKeyType_Enum::FDataType>(EnumValueAsInt));
 	}
 }
 
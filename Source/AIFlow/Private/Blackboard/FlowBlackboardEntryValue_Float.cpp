@@ -65,10 +65,15 @@ void UFlowBlackboardEntryValue_Float::SetOnBlackboardComponent(UBlackboardCompon
 {
 	if (IsValid(BlackboardComponent))
 	{
-		BlackboardComponent->SetValueAsFloat(Key.GetKeyName(), FloatValue);
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
 	}
 }
 
+void UFlowBlackboardEntryValue_Float::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	BlackboardComponent.SetValue<UBlackboardKeyType_Float>(KeyID, FloatValue);
+}
+
 EBlackboardCompare::Type UFlowBlackboardEntryValue_Float::CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const
 {
 	if (!IsValid(BlackboardComponent))
@@ -108,3 +113,27 @@ bool UFlowBlackboardEntryValue_Float::TryGetNumericalValuesForArithmeticOperatio
 
 	return true;
 }
+
+bool UFlowBlackboardEntryValue_Float::TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const
+{
+	return TryApplyToRawKeyMemoryTemplate<UBlackboardKeyType_Float>(KeyType, RawKeyMemory, FloatValue);
+}
+
+EBlackboardCompare::Type UFlowBlackboardEntryValue_Float::CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const
+{
+	float OtherValue;
+	if (!TryGetValueFromRawKeyMemoryTemplate<UBlackboardKeyType_Float>(KeyType, RawKeyMemory, OtherValue))
+	{
+		return EBlackboardCompare::NotEqual;
+	}
+
+	return (FMath::IsNearlyEqual(FloatValue, OtherValue)) ? EBlackboardCompare::Equal : EBlackboardCompare::NotEqual;
+}
+
+bool UFlowBlackboardEntryValue_Float::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+	const UBlackboardKeyType& KeyType,
+	const uint8* RawKeyMemory,
+	TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const
+{
+	return TryProvideFlowDataPinPropertyFromRawKeyMemoryTemplate<UBlackboardKeyType_Float, FFlowDataPinValue_Float>(KeyType, RawKeyMemory, OutFlowDataPinProperty);
+}
@@ -65,10 +65,15 @@ void UFlowBlackboardEntryValue_Int::SetOnBlackboardComponent(UBlackboardComponen
 {
 	if (IsValid(BlackboardComponent))
 	{
-		BlackboardComponent->SetValueAsInt(Key.GetKeyName(), IntValue);
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
 	}
 }
 
+void UFlowBlackboardEntryValue_Int::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	BlackboardComponent.SetValue<UBlackboardKeyType_Int>(KeyID, IntValue);
+}
+
 EBlackboardCompare::Type UFlowBlackboardEntryValue_Int::CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const
 {
 	if (!IsValid(BlackboardComponent))
@@ -108,3 +113,27 @@ bool UFlowBlackboardEntryValue_Int::TryGetNumericalValuesForArithmeticOperation(
 
 	return true;
 }
+
+bool UFlowBlackboardEntryValue_Int::TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const
+{
+	return TryApplyToRawKeyMemoryTemplate<UBlackboardKeyType_Int>(KeyType, RawKeyMemory, IntValue);
+}
+
+EBlackboardCompare::Type UFlowBlackboardEntryValue_Int::CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const
+{
+	int32 OtherValue;
+	if (!TryGetValueFromRawKeyMemoryTemplate<UBlackboardKeyType_Int>(KeyType, RawKeyMemory, OtherValue))
+	{
+		return EBlackboardCompare::NotEqual;
+	}
+
+	return (IntValue == OtherValue) ? EBlackboardCompare::Equal : EBlackboardCompare::NotEqual;
+}
+
+bool UFlowBlackboardEntryValue_Int::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+	const UBlackboardKeyType& KeyType,
+	const uint8* RawKeyMemory,
+	TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const
+{
+	return TryProvideFlowDataPinPropertyFromRawKeyMemoryTemplate<UBlackboardKeyType_Int, FFlowDataPinValue_Int>(KeyType, RawKeyMemory, OutFlowDataPinProperty);
+}
@@ -65,10 +65,15 @@ void UFlowBlackboardEntryValue_Name::SetOnBlackboardComponent(UBlackboardCompone
 {
 	if (IsValid(BlackboardComponent))
 	{
-		BlackboardComponent->SetValueAsName(Key.GetKeyName(), NameValue);
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
 	}
 }
 
+void UFlowBlackboardEntryValue_Name::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	BlackboardComponent.SetValue<UBlackboardKeyType_Name>(KeyID, NameValue);
+}
+
 EBlackboardCompare::Type UFlowBlackboardEntryValue_Name::CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const
 {
 	if (!IsValid(BlackboardComponent))
@@ -93,3 +98,27 @@ TSubclassOf<UBlackboardKeyType> UFlowBlackboardEntryValue_Name::GetSupportedBlac
 {
 	return UBlackboardKeyType_Name::StaticClass();
 }
+
+bool UFlowBlackboardEntryValue_Name::TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const
+{
+	return TryApplyToRawKeyMemoryTemplate<UBlackboardKeyType_Name>(KeyType, RawKeyMemory, NameValue);
+}
+
+EBlackboardCompare::Type UFlowBlackboardEntryValue_Name::CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const
+{
+	FName OtherValue;
+	if (!TryGetValueFromRawKeyMemoryTemplate<UBlackboardKeyType_Name>(KeyType, RawKeyMemory, OtherValue))
+	{
+		return EBlackboardCompare::NotEqual;
+	}
+
+	return (NameValue == OtherValue) ? EBlackboardCompare::Equal : EBlackboardCompare::NotEqual;
+}
+
+bool UFlowBlackboardEntryValue_Name::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+	const UBlackboardKeyType& KeyType,
+	const uint8* RawKeyMemory,
+	TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const
+{
+	return TryProvideFlowDataPinPropertyFromRawKeyMemoryTemplate<UBlackboardKeyType_Name, FFlowDataPinValue_Name>(KeyType, RawKeyMemory, OutFlowDataPinProperty);
+}
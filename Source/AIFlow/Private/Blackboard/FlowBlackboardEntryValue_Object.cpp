@@ -213,14 +213,19 @@ void UFlowBlackboardEntryValue_Object::SetOnBlackboardComponent(UBlackboardCompo
 {
 	if (IsValid(BlackboardComponent))
 	{
-		if (ObjectInstance)
-		{
-			BlackboardComponent->SetValueAsObject(Key.GetKeyName(), ObjectInstance);
-		}
-		else
-		{
-			BlackboardComponent->SetValueAsObject(Key.GetKeyName(), ObjectAsset);
-		}
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
+	}
+}
+
+void UFlowBlackboardEntryValue_Object::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	if (ObjectInstance)
+	{
+		BlackboardComponent.SetValue<UBlackboardKeyType_Object>(KeyID, ObjectInstance);
+	}
+	else
+	{
+		BlackboardComponent.SetValue<UBlackboardKeyType_Object>(KeyID, ObjectAsset);
 	}
 }
 
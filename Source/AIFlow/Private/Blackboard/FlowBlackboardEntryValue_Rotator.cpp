@@ -60,10 +60,15 @@ void UFlowBlackboardEntryValue_Rotator::SetOnBlackboardComponent(UBlackboardComp
 {
 	if (IsValid(BlackboardComponent))
 	{
-		BlackboardComponent->SetValueAsRotator(Key.GetKeyName(), RotatorValue);
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
 	}
 }
 
+void UFlowBlackboardEntryValue_Rotator::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	BlackboardComponent.SetValue<UBlackboardKeyType_Rotator>(KeyID, RotatorValue);
+}
+
 EBlackboardCompare::Type UFlowBlackboardEntryValue_Rotator::CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const
 {
 	if (!IsValid(BlackboardComponent))
@@ -88,3 +93,27 @@ TSubclassOf<UBlackboardKeyType> UFlowBlackboardEntryValue_Rotator::GetSupportedB
 {
 	return UBlackboardKeyType_Rotator::StaticClass();
 }
+
+bool UFlowBlackboardEntryValue_Rotator::TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const
+{
+	return TryApplyToRawKeyMemoryTemplate<UBlackboardKeyType_Rotator>(KeyType, RawKeyMemory, RotatorValue);
+}
+
+EBlackboardCompare::Type UFlowBlackboardEntryValue_Rotator::CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const
+{
+	FRotator OtherValue;
+	if (!TryGetValueFromRawKeyMemoryTemplate<UBlackboardKeyType_Rotator>(KeyType, RawKeyMemory, OtherValue))
+	{
+		return EBlackboardCompare::NotEqual;
+	}
+
+	return (RotatorValue.Equals(OtherValue)) ? EBlackboardCompare::Equal : EBlackboardCompare::NotEqual;
+}
+
+bool UFlowBlackboardEntryValue_Rotator::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+	const UBlackboardKeyType& KeyType,
+	const uint8* RawKeyMemory,
+	TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const
+{
+	return TryProvideFlowDataPinPropertyFromRawKeyMemoryTemplate<UBlackboardKeyType_Rotator, FFlowDataPinValue_Rotator>(KeyType, RawKeyMemory, OutFlowDataPinProperty);
+}
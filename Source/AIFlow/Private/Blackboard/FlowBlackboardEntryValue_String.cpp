@@ -60,10 +60,15 @@ void UFlowBlackboardEntryValue_String::SetOnBlackboardComponent(UBlackboardCompo
 {
 	if (IsValid(BlackboardComponent))
 	{
-		BlackboardComponent->SetValueAsString(Key.GetKeyName(), StringValue);
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
 	}
 }
 
+void UFlowBlackboardEntryValue_String::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	BlackboardComponent.SetValue<UBlackboardKeyType_String>(KeyID, StringValue);
+}
+
 EBlackboardCompare::Type UFlowBlackboardEntryValue_String::CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const
 {
 	if (!IsValid(BlackboardComponent))
@@ -60,10 +60,15 @@ void UFlowBlackboardEntryValue_Vector::SetOnBlackboardComponent(UBlackboardCompo
 {
 	if (IsValid(BlackboardComponent))
 	{
-		BlackboardComponent->SetValueAsVector(Key.GetKeyName(), VectorValue);
+		SetOnBlackboardComponentWithKeyID(*BlackboardComponent, BlackboardComponent->GetKeyID(Key.GetKeyName()));
 	}
 }
 
+void UFlowBlackboardEntryValue_Vector::SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const
+{
+	BlackboardComponent.SetValue<UBlackboardKeyType_Vector>(KeyID, VectorValue);
+}
+
 EBlackboardCompare::Type UFlowBlackboardEntryValue_Vector::CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const
 {
 	if (!IsValid(BlackboardComponent))
@@ -88,3 +93,27 @@ TSubclassOf<UBlackboardKeyType> UFlowBlackboardEntryValue_Vector::GetSupportedBl
 {
 	return UBlackboardKeyType_Vector::StaticClass();
 }
+
+bool UFlowBlackboardEntryValue_Vector::TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const
+{
+	return TryApplyToRawKeyMemoryTemplate<UBlackboardKeyType_Vector>(KeyType, RawKeyMemory, VectorValue);
+}
+
+EBlackboardCompare::Type UFlowBlackboardEntryValue_Vector::CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const
+{
+	FVector OtherValue;
+	if (!TryGetValueFromRawKeyMemoryTemplate<UBlackboardKeyType_Vector>(KeyType, RawKeyMemory, OtherValue))
+	{
+		return EBlackboardCompare::NotEqual;
+	}
+
+	return (VectorValue.Equals(OtherValue)) ? EBlackboardCompare::Equal : EBlackboardCompare::NotEqual;
+}
+
+bool UFlowBlackboardEntryValue_Vector::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+	const UBlackboardKeyType& KeyType,
+	const uint8* RawKeyMemory,
+	TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const
+{
+	return TryProvideFlowDataPinPropertyFromRawKeyMemoryTemplate<UBlackboardKeyType_Vector, FFlowDataPinValue_Vector>(KeyType, RawKeyMemory, OutFlowDataPinProperty);
+}
@@ -1,6 +1,7 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "Interfaces/FlowBlackboardInterface.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
 #include "BehaviorTree/BlackboardData.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType.h"
@@ -20,7 +21,13 @@ bool IFlowBlackboardInterface::IsValidBlackboardKey(const FName& KeyName) const
 
 bool IFlowBlackboardInterface::IsValidBlackboardKey(const UBlackboardComponent& BlackboardComp, const FName& KeyName)
 {
-	const FBlackboard::FKey KeyId = BlackboardComp.GetKeyID(KeyName);
+	const UBlackboardData* BlackboardAsset = BlackboardComp.GetBlackboardAsset();
+	if (!IsValid(BlackboardAsset))
+	{
+		return false;
+	}
+
+	const FBlackboard::FKey KeyId = FAIFlowBlackboardKeyTable::Get(*BlackboardAsset)->FindKeyID(KeyName);
 	const bool bIsValidKey = BlackboardComp.IsValidKey(KeyId);
 	return bIsValidKey;
 }
@@ -49,22 +56,19 @@ TArray<FName> IFlowBlackboardInterface::GatherAllBlackboardKeysOfType(const UBla
 	MatchingKeys.Reserve(BlackboardComp.GetNumKeys());
 
 	// Get matching keys from all blackboards
-	for (const UBlackboardData* It = BlackboardAsset; It; It = It->Parent)
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(*BlackboardAsset);
+	for (const FAIFlowBlackboardKeyTableEntry& Entry : KeyTable->GetEntries())
 	{
-		for (int32 KeyIndex = 0; KeyIndex < It->Keys.Num(); KeyIndex++)
+		if (!Entry.KeyType)
+		{
+			continue;
+		}
+
+		const bool bFilterPassed = !IsValid(AllowedType) || Entry.KeyType->IsAllowedByFilter(AllowedType);
+
+		if (bFilterPassed)
 		{
-			const FBlackboardEntry& EntryInfo = It->Keys[KeyIndex];
-			if (!EntryInfo.KeyType)
-			{
-				continue;
-			}
-
-			const bool bFilterPassed = !IsValid(AllowedType) || EntryInfo.KeyType->IsAllowedByFilter(AllowedType);
-
-			if (bFilterPassed)
-			{
-				MatchingKeys.Add(EntryInfo.EntryName);
-			}
+			MatchingKeys.Add(Entry.KeyName);
 		}
 	}
 
@@ -94,18 +98,8 @@ UBlackboardKeyType* IFlowBlackboardInterface::GetBlackboardKeyType(const UBlackb
 		return nullptr;
 	}
 
-	const FBlackboard::FKey KeyId = BlackboardAsset->GetKeyID(KeyName);
-
-	// Look for the key on all matching blackboards
-	for (const UBlackboardData* It = BlackboardAsset; It; It = It->Parent)
-	{
-		if (const FBlackboardEntry* BlackboardEntry = It->GetKey(KeyId))
-		{
-			return BlackboardEntry->KeyType;
-		}
-	}
-
-	return nullptr;
+	// The key table includes the keys from all of the Parent blackboards
+	return FAIFlowBlackboardKeyTable::Get(*BlackboardAsset)->FindKeyType(KeyName);
 }
 
 UBlackboardComponent* IFlowBlackboardInterface::GetBlackboardComponent() const
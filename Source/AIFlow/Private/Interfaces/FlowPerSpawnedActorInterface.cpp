@@ -2,9 +2,68 @@
 
 #include "Interfaces/FlowPerSpawnedActorInterface.h"
 #include "AddOns/FlowNodeAddOn.h"
+#include "Interfaces/FlowSpawnedActorInterface.h"
+#include "Nodes/FlowNodeBase.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowPerSpawnedActorInterface)
 
+void IFlowPerSpawnedActorInterface::FinishedSpawningActors(TArrayView<AActor* const> SpawnedActors, UFlowNodeBase* SpawningNodeOrAddOn)
+{
+	UObject* ThisObject = _getUObject();
+	check(ThisObject);
+
+	for (AActor* SpawnedActor : SpawnedActors)
+	{
+		Execute_FinishedSpawningActor(ThisObject, SpawnedActor, SpawningNodeOrAddOn);
+	}
+}
+
+void IFlowPerSpawnedActorInterface::DispatchFinishedSpawningActors(UObject* Implementer, TArrayView<AActor* const> SpawnedActors, UFlowNodeBase* SpawningNodeOrAddOn)
+{
+	if (!IsValid(Implementer) || !Implementer->Implements<UFlowPerSpawnedActorInterface>())
+	{
+		return;
+	}
+
+	// Blueprint overrides of the per-actor event take precedence over any native batching
+	static const FName FinishedSpawningActorName = GET_FUNCTION_NAME_CHECKED(IFlowPerSpawnedActorInterface, FinishedSpawningActor);
+	const bool bHasScriptOverride = Implementer->GetClass()->IsFunctionImplementedInScript(FinishedSpawningActorName);
+
+	IFlowPerSpawnedActorInterface* NativeInterface = Cast<IFlowPerSpawnedActorInterface>(Implementer);
+	if (NativeInterface && !bHasScriptOverride)
+	{
+		NativeInterface->FinishedSpawningActors(SpawnedActors, SpawningNodeOrAddOn);
+
+		return;
+	}
+
+	// Blueprint implementers can only receive the per-actor event
+	for (AActor* SpawnedActor : SpawnedActors)
+	{
+		Execute_FinishedSpawningActor(Implementer, SpawnedActor, SpawningNodeOrAddOn);
+	}
+}
+
+void IFlowPerSpawnedActorInterface::DispatchFinishedSpawningActorsToAddOnsAndActors(UFlowNodeBase& SpawningNodeOrAddOn, TArrayView<AActor* const> SpawnedActors)
+{
+	(void) SpawningNodeOrAddOn.ForEachAddOnForClass<UFlowPerSpawnedActorInterface>(
+		[&SpawningNodeOrAddOn, SpawnedActors](UFlowNodeAddOn& AddOn)
+		{
+			DispatchFinishedSpawningActors(&AddOn, SpawnedActors, &SpawningNodeOrAddOn);
+
+			return EFlowForEachAddOnFunctionReturnValue::Continue;
+		});
+
+	// The actors are informed after all of the AddOns' post-spawn setup has completed
+	for (AActor* SpawnedActor : SpawnedActors)
+	{
+		if (IsValid(SpawnedActor))
+		{
+			IFlowSpawnedActorInterface::DispatchFinishedSpawningActorFromFlowToActorAndComponents(SpawnedActor, &SpawningNodeOrAddOn);
+		}
+	}
+}
+
 bool IFlowPerSpawnedActorInterface::ImplementsInterfaceSafe(const UFlowNodeAddOn* AddOnTemplate)
 {
 	if (!IsValid(AddOnTemplate))
@@ -0,0 +1,187 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Mass/AIFlowMassBlackboardFragment.h"
+#include "AIFlowLogChannels.h"
+#include "AISystem.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Name.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Rotator.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowMassBlackboardFragment)
+
+namespace AIFlowMassBlackboardFragment_Private
+{
+	bool IsSupportedKeyType(const UBlackboardKeyType& KeyType)
+	{
+		return
+			KeyType.IsA<UBlackboardKeyType_Bool>() ||
+			KeyType.IsA<UBlackboardKeyType_Int>() ||
+			KeyType.IsA<UBlackboardKeyType_Float>() ||
+			KeyType.IsA<UBlackboardKeyType_Enum>() ||
+			KeyType.IsA<UBlackboardKeyType_NativeEnum>() ||
+			KeyType.IsA<UBlackboardKeyType_Name>() ||
+			KeyType.IsA<UBlackboardKeyType_Vector>() ||
+			KeyType.IsA<UBlackboardKeyType_Rotator>();
+	}
+}
+
+bool FAIFlowMassBlackboardFragment::InitializeFromBlackboardData(const UBlackboardData& InBlackboardData)
+{
+	using namespace AIFlowMassBlackboardFragment_Private;
+
+	BlackboardData = &InBlackboardData;
+	ValueMemory.Reset();
+	ValueOffsets.Reset();
+	ValueSizes.Reset();
+
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(InBlackboardData);
+
+	int32 NumKeyIDs = 0;
+	for (const FAIFlowBlackboardKeyTableEntry& Entry : KeyTable->GetEntries())
+	{
+		NumKeyIDs = FMath::Max(NumKeyIDs, Entry.KeyID + 1);
+	}
+
+	ValueOffsets.Init(0, NumKeyIDs);
+	ValueSizes.Init(0, NumKeyIDs);
+
+	uint32 MemorySize = 0;
+	for (const FAIFlowBlackboardKeyTableEntry& Entry : KeyTable->GetEntries())
+	{
+		if (!Entry.KeyType || !IsSupportedKeyType(*Entry.KeyType))
+		{
+			continue;
+		}
+
+		const uint16 ValueSize = Entry.KeyType->GetValueSize();
+		const uint32 Alignment = FMath::Min<uint32>(FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(ValueSize, 1)), 8);
+
+		MemorySize = Align(MemorySize, Alignment);
+
+		ValueOffsets[Entry.KeyID] = static_cast<uint16>(FMath::Min<uint32>(MemorySize, MAX_uint16));
+		ValueSizes[Entry.KeyID] = ValueSize;
+
+		MemorySize += ValueSize;
+	}
+
+	if (MemorySize > MAX_uint16)
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Blackboard %s needs %u bytes of values, which is too large for a Mass blackboard fragment."), *InBlackboardData.GetName(), MemorySize);
+
+		BlackboardData.Reset();
+		ValueOffsets.Reset();
+		ValueSizes.Reset();
+
+		return false;
+	}
+
+	ValueMemory.SetNumZeroed(MemorySize);
+
+	// Vector and Rotator keys start out invalid, as they do in a UBlackboardComponent
+	for (const FAIFlowBlackboardKeyTableEntry& Entry : KeyTable->GetEntries())
+	{
+		if (Entry.KeyType && Entry.KeyType->IsA<UBlackboardKeyType_Vector>())
+		{
+			(void) SetValue<UBlackboardKeyType_Vector>(Entry.KeyID, FAISystem::InvalidLocation);
+		}
+		else if (Entry.KeyType && Entry.KeyType->IsA<UBlackboardKeyType_Rotator>())
+		{
+			(void) SetValue<UBlackboardKeyType_Rotator>(Entry.KeyID, FAISystem::InvalidRotation);
+		}
+	}
+
+	return true;
+}
+
+FBlackboard::FKey FAIFlowMassBlackboardFragment::GetKeyID(const FName& KeyName) const
+{
+	const UBlackboardData* Data = BlackboardData.Get();
+	return Data ? FAIFlowBlackboardKeyTable::Get(*Data)->FindKeyID(KeyName) : FBlackboard::InvalidKey;
+}
+
+const UBlackboardKeyType* FAIFlowMassBlackboardFragment::GetKeyType(FBlackboard::FKey KeyID) const
+{
+	const UBlackboardData* Data = BlackboardData.Get();
+	if (!Data || KeyID == FBlackboard::InvalidKey)
+	{
+		return nullptr;
+	}
+
+	const FBlackboardEntry* BlackboardEntry = Data->GetKey(KeyID);
+	return BlackboardEntry ? BlackboardEntry->KeyType : nullptr;
+}
+
+const uint8* FAIFlowMassBlackboardFragment::GetKeyRawData(FBlackboard::FKey KeyID) const
+{
+	if (!ValueSizes.IsValidIndex(KeyID) || ValueSizes[KeyID] == 0)
+	{
+		return nullptr;
+	}
+
+	return ValueMemory.GetData() + ValueOffsets[KeyID];
+}
+
+EBlackboardCompare::Type FAIFlowMassBlackboardFragment::CompareKeyValues(FBlackboard::FKey KeyA, FBlackboard::FKey KeyB) const
+{
+	const UBlackboardKeyType* KeyTypeA = GetKeyType(KeyA);
+	const UBlackboardKeyType* KeyTypeB = GetKeyType(KeyB);
+	const uint8* RawDataA = GetKeyRawData(KeyA);
+	const uint8* RawDataB = GetKeyRawData(KeyB);
+
+	if (!KeyTypeA || !KeyTypeB || !RawDataA || !RawDataB || KeyTypeA->GetClass() != KeyTypeB->GetClass())
+	{
+		return EBlackboardCompare::NotEqual;
+	}
+
+	return FMemory::Memcmp(RawDataA, RawDataB, GetKeyValueSize(KeyA)) == 0 ? EBlackboardCompare::Equal : EBlackboardCompare::NotEqual;
+}
+
+bool FAIFlowMassBlackboardFragment::TryGetNumericalValue(FBlackboard::FKey KeyID, int32& OutIntValue, float& OutFloatValue) const
+{
+	const UBlackboardKeyType* KeyType = GetKeyType(KeyID);
+	const uint8* RawData = GetKeyRawData(KeyID);
+	if (!KeyType || !RawData)
+	{
+		return false;
+	}
+
+	if (const UBlackboardKeyType_Float* FloatKeyType = Cast<UBlackboardKeyType_Float>(KeyType))
+	{
+		OutFloatValue = UBlackboardKeyType_Float::GetValue(FloatKeyType, RawData);
+		OutIntValue = FMath::TruncToInt32(OutFloatValue);
+
+		return true;
+	}
+
+	if (const UBlackboardKeyType_Int* IntKeyType = Cast<UBlackboardKeyType_Int>(KeyType))
+	{
+		OutIntValue = UBlackboardKeyType_Int::GetValue(IntKeyType, RawData);
+		OutFloatValue = static_cast<float>(OutIntValue);
+
+		return true;
+	}
+
+	if (const UBlackboardKeyType_Enum* EnumKeyType = Cast<UBlackboardKeyType_Enum>(KeyType))
+	{
+		OutIntValue = UBlackboardKeyType_Enum::GetValue(EnumKeyType, RawData);
+		OutFloatValue = static_cast<float>(OutIntValue);
+
+		return true;
+	}
+
+	if (const UBlackboardKeyType_NativeEnum* NativeEnumKeyType = Cast<UBlackboardKeyType_NativeEnum>(KeyType))
+	{
+		OutIntValue = UBlackboardKeyType_NativeEnum::GetValue(NativeEnumKeyType, RawData);
+		OutFloatValue = static_cast<float>(OutIntValue);
+
+		return true;
+	}
+
+	return false;
+}
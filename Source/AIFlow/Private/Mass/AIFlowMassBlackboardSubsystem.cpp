@@ -0,0 +1,281 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Mass/AIFlowMassBlackboardSubsystem.h"
+#include "AIFlowLogChannels.h"
+#include "AIFlowStats.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "Blackboard/FlowBlackboardEntryValue.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType.h"
+#include "Mass/AIFlowMassBlackboardFragment.h"
+#include "MassCommandBuffer.h"
+#include "MassCommands.h"
+#include "MassEntityManager.h"
+#include "MassEntitySubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "TimerManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowMassBlackboardSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Mass Blackboard Remove Stale Entities"), STAT_AIFlow_MassBlackboardRemoveStaleEntities, STATGROUP_AIFlow);
+
+void UAIFlowMassBlackboardSubsystem::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->GetTimerManager().ClearTimer(StaleEntitySweepTimerHandle);
+	}
+
+	EntityByActor.Reset();
+	EntityBlackboardData.Reset();
+	PendingWrites.Reset();
+
+	Super::Deinitialize();
+}
+
+void UAIFlowMassBlackboardSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// Writes for entities that were destroyed before they could be applied would otherwise never be consumed
+	constexpr bool bLoop = true;
+	InWorld.GetTimerManager().SetTimer(
+		StaleEntitySweepTimerHandle,
+		FTimerDelegate::CreateUObject(this, &ThisClass::RemoveStaleEntities),
+		StaleEntitySweepInterval,
+		bLoop);
+}
+
+void UAIFlowMassBlackboardSubsystem::BindActorToEntity(const AActor& Actor, FMassEntityHandle Entity)
+{
+	if (!Entity.IsSet())
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot bind actor %s to an unset Mass entity."), *Actor.GetName());
+
+		return;
+	}
+
+	EntityByActor.Add(&Actor, Entity);
+}
+
+void UAIFlowMassBlackboardSubsystem::UnbindActor(const AActor& Actor)
+{
+	EntityByActor.Remove(&Actor);
+}
+
+FMassEntityHandle UAIFlowMassBlackboardSubsystem::FindEntityForActor(const AActor* Actor) const
+{
+	if (!IsValid(Actor))
+	{
+		return FMassEntityHandle();
+	}
+
+	const FMassEntityHandle* FoundEntity = EntityByActor.Find(Actor);
+	return FoundEntity ? *FoundEntity : FMassEntityHandle();
+}
+
+bool UAIFlowMassBlackboardSubsystem::InitializeEntityBlackboard(FMassEntityHandle Entity, const UBlackboardData& BlackboardData)
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (!EntityManager || !EntityManager->IsEntityValid(Entity))
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot initialize blackboard %s for an invalid Mass entity."), *BlackboardData.GetName());
+
+		return false;
+	}
+
+	FAIFlowMassBlackboardFragment Fragment;
+	if (!Fragment.InitializeFromBlackboardData(BlackboardData))
+	{
+		return false;
+	}
+
+	if (FAIFlowMassBlackboardFragment* ExistingFragment = EntityManager->GetFragmentDataPtr<FAIFlowMassBlackboardFragment>(Entity))
+	{
+		*ExistingFragment = MoveTemp(Fragment);
+	}
+	else
+	{
+		EntityManager->Defer().PushCommand<FMassCommandAddFragmentInstances>(Entity, MoveTemp(Fragment));
+	}
+
+	EntityBlackboardData.Add(Entity, &BlackboardData);
+
+	return true;
+}
+
+bool UAIFlowMassBlackboardSubsystem::EnsureEntityBlackboard(FMassEntityHandle Entity, const UBlackboardData& BlackboardData)
+{
+	if (EntityBlackboardData.FindRef(Entity).IsValid())
+	{
+		return true;
+	}
+
+	return InitializeEntityBlackboard(Entity, BlackboardData);
+}
+
+const FAIFlowMassBlackboardFragment* UAIFlowMassBlackboardSubsystem::FindBlackboardFragment(FMassEntityHandle Entity) const
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (!EntityManager || !Entity.IsSet() || !EntityManager->IsEntityValid(Entity))
+	{
+		return nullptr;
+	}
+
+	const FAIFlowMassBlackboardFragment* Fragment = EntityManager->GetFragmentDataPtr<FAIFlowMassBlackboardFragment>(Entity);
+	return (Fragment && Fragment->IsInitialized()) ? Fragment : nullptr;
+}
+
+const FAIFlowMassBlackboardFragment* UAIFlowMassBlackboardSubsystem::FindBlackboardFragmentForActorInWorld(const UWorld* World, const AActor* Actor, const UBlackboardData* OptionalSpecificBlackboardData)
+{
+	const UAIFlowMassBlackboardSubsystem* MassBlackboardSubsystem = IsValid(World) ? World->GetSubsystem<UAIFlowMassBlackboardSubsystem>() : nullptr;
+	if (!MassBlackboardSubsystem)
+	{
+		return nullptr;
+	}
+
+	const FAIFlowMassBlackboardFragment* MassBlackboardFragment = MassBlackboardSubsystem->FindBlackboardFragmentForActor(Actor);
+	if (!MassBlackboardFragment)
+	{
+		return nullptr;
+	}
+
+	if (IsValid(OptionalSpecificBlackboardData) && MassBlackboardFragment->GetBlackboardData() != OptionalSpecificBlackboardData)
+	{
+		return nullptr;
+	}
+
+	return MassBlackboardFragment;
+}
+
+void UAIFlowMassBlackboardSubsystem::QueueEntryWrites(FMassEntityHandle Entity, TConstArrayView<UFlowBlackboardEntryValue*> Entries)
+{
+	const UBlackboardData* BlackboardData = FindEntityBlackboardData(Entity);
+	if (!BlackboardData)
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot queue blackboard writes for Mass entity %s, which has no initialized blackboard."), *Entity.DebugGetDescription());
+
+		return;
+	}
+
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(*BlackboardData);
+	TArray<FAIFlowMassPendingBlackboardWrite>& EntityWrites = PendingWrites.FindOrAdd(Entity);
+
+	for (const UFlowBlackboardEntryValue* Entry : Entries)
+	{
+		if (!IsValid(Entry))
+		{
+			continue;
+		}
+
+		const FAIFlowBlackboardKeyTableEntry* KeyEntry = KeyTable->FindEntry(Entry->Key.GetKeyName());
+		if (!KeyEntry || !KeyEntry->KeyType)
+		{
+			UE_LOG(LogAIFlow, Warning, TEXT("Blackboard %s (for Mass entity %s) has no key %s."), *BlackboardData->GetName(), *Entity.DebugGetDescription(), *Entry->Key.GetKeyName().ToString());
+
+			continue;
+		}
+
+		// Snapshot the value now, so the write applies the value as it was when it was queued
+		FAIFlowMassPendingBlackboardWrite& Write = EntityWrites.AddDefaulted_GetRef();
+		Write.KeyID = KeyEntry->KeyID;
+		Write.Value.SetNumZeroed(KeyEntry->KeyType->GetValueSize());
+
+		if (!Entry->TryApplyToRawKeyMemory(*KeyEntry->KeyType, Write.Value.GetData()))
+		{
+			UE_LOG(LogAIFlow, Warning, TEXT("%s cannot write key %s to a Mass blackboard (only plain-old-data key types are supported)."), *Entry->GetClass()->GetName(), *KeyEntry->KeyName.ToString());
+
+			EntityWrites.Pop(EAllowShrinking::No);
+		}
+	}
+
+	if (EntityWrites.IsEmpty())
+	{
+		PendingWrites.Remove(Entity);
+	}
+}
+
+void UAIFlowMassBlackboardSubsystem::ExtractMassAgentActors(TArray<AActor*>& InOutActors, TArray<AActor*>& OutMassAgentActors) const
+{
+	if (EntityByActor.IsEmpty())
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < InOutActors.Num(); )
+	{
+		if (FindEntityForActor(InOutActors[Index]).IsSet())
+		{
+			OutMassAgentActors.Add(InOutActors[Index]);
+			InOutActors.RemoveAt(Index, EAllowShrinking::No);
+		}
+		else
+		{
+			++Index;
+		}
+	}
+}
+
+void UAIFlowMassBlackboardSubsystem::ApplyPendingWrites(FMassEntityHandle Entity, FAIFlowMassBlackboardFragment& Fragment)
+{
+	TArray<FAIFlowMassPendingBlackboardWrite> EntityWrites;
+	if (!PendingWrites.RemoveAndCopyValue(Entity, EntityWrites))
+	{
+		return;
+	}
+
+	for (const FAIFlowMassPendingBlackboardWrite& Write : EntityWrites)
+	{
+		uint8* RawData = Fragment.GetKeyRawData(Write.KeyID);
+
+		// The fragment may have been re-initialized for another blackboard since the write was queued
+		if (RawData && Fragment.GetKeyValueSize(Write.KeyID) == Write.Value.Num())
+		{
+			FMemory::Memcpy(RawData, Write.Value.GetData(), Write.Value.Num());
+		}
+	}
+}
+
+void UAIFlowMassBlackboardSubsystem::RemoveStaleEntities()
+{
+	FMassEntityManager* EntityManager = GetEntityManager();
+	if (!EntityManager)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_MassBlackboardRemoveStaleEntities);
+
+	for (auto It = PendingWrites.CreateIterator(); It; ++It)
+	{
+		if (!EntityManager->IsEntityValid(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = EntityBlackboardData.CreateIterator(); It; ++It)
+	{
+		if (!EntityManager->IsEntityValid(It.Key()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	for (auto It = EntityByActor.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().ResolveObjectPtr() || !EntityManager->IsEntityValid(It.Value()))
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+FMassEntityManager* UAIFlowMassBlackboardSubsystem::GetEntityManager() const
+{
+	UWorld* World = GetWorld();
+	UMassEntitySubsystem* EntitySubsystem = World ? World->GetSubsystem<UMassEntitySubsystem>() : nullptr;
+
+	return EntitySubsystem ? &EntitySubsystem->GetMutableEntityManager() : nullptr;
+}
@@ -0,0 +1,52 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Mass/AIFlowMassBlackboardWriteProcessor.h"
+#include "AIFlowStats.h"
+#include "Mass/AIFlowMassBlackboardFragment.h"
+#include "Mass/AIFlowMassBlackboardSubsystem.h"
+#include "MassExecutionContext.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowMassBlackboardWriteProcessor)
+
+DECLARE_CYCLE_STAT(TEXT("Mass Blackboard Apply Writes"), STAT_AIFlow_MassBlackboardApplyWrites, STATGROUP_AIFlow);
+
+UAIFlowMassBlackboardWriteProcessor::UAIFlowMassBlackboardWriteProcessor()
+	: EntityQuery(*this)
+{
+	ExecutionFlags = static_cast<int32>(EProcessorExecutionFlags::AllNetModes);
+	ProcessingPhase = EMassProcessingPhase::PrePhysics;
+	bRequiresGameThreadExecution = true;
+}
+
+void UAIFlowMassBlackboardWriteProcessor::ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager)
+{
+	EntityQuery.AddRequirement<FAIFlowMassBlackboardFragment>(EMassFragmentAccess::ReadWrite);
+}
+
+void UAIFlowMassBlackboardWriteProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	UAIFlowMassBlackboardSubsystem* MassBlackboardSubsystem = UWorld::GetSubsystem<UAIFlowMassBlackboardSubsystem>(EntityManager.GetWorld());
+	if (!MassBlackboardSubsystem || !MassBlackboardSubsystem->HasPendingWrites())
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_MassBlackboardApplyWrites);
+
+	// Writes for destroyed entities are not visited here, they are discarded by the subsystem's periodic RemoveStaleEntities sweep
+	EntityQuery.ForEachEntityChunk(Context, [MassBlackboardSubsystem](FMassExecutionContext& ChunkContext)
+		{
+			if (!MassBlackboardSubsystem->HasPendingWrites())
+			{
+				return;
+			}
+
+			const TArrayView<FAIFlowMassBlackboardFragment> BlackboardFragments = ChunkContext.GetMutableFragmentView<FAIFlowMassBlackboardFragment>();
+
+			for (int32 EntityIndex = 0; EntityIndex < ChunkContext.GetNumEntities(); ++EntityIndex)
+			{
+				MassBlackboardSubsystem->ApplyPendingWrites(ChunkContext.GetEntity(EntityIndex), BlackboardFragments[EntityIndex]);
+			}
+		});
+}
@@ -41,6 +41,12 @@ UBlackboardData* UAIFlowNode::GetBlackboardAssetForPropertyHandle(const TSharedP
 
 UBlackboardComponent* UAIFlowNode::GetBlackboardComponent() const
 {
+	// Accessing the flow instance's blackboard creates it, if its creation was deferred
+	if (UAIFlowAsset* AIFlowAsset = Cast<UAIFlowAsset>(GetFlowAsset()))
+	{
+		return AIFlowAsset->EnsureBlackboardComponent();
+	}
+
 	IFlowBlackboardInterface* FlowBlackboardInterface = Cast<IFlowBlackboardInterface>(GetFlowAsset());
 	if (FlowBlackboardInterface)
 	{
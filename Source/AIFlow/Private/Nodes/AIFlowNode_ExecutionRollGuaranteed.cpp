@@ -79,6 +79,16 @@ void UAIFlowNode_ExecutionRollGuaranteed::Cleanup()
 	bHasSuccessfullyRolled = false;
 }
 
+void UAIFlowNode_ExecutionRollGuaranteed::ResetInstanceForReuse()
+{
+	Super::ResetInstanceForReuse();
+
+	// Cleanup is not guaranteed to have run (eg, the flow was deinitialized while this node was active)
+	RollAttempts = 0;
+	bHasSuccessfullyRolled = false;
+	RandomStream.Reset();
+}
+
 #if WITH_EDITOR
 FString UAIFlowNode_ExecutionRollGuaranteed::GetNodeDescription() const
 {
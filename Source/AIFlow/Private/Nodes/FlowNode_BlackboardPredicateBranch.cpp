@@ -0,0 +1,156 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Nodes/FlowNode_BlackboardPredicateBranch.h"
+#include "AIFlowPredicateEvaluationContext.h"
+#include "Subsystems/AIFlowPredicateBatchSubsystem.h"
+#include "AddOns/FlowNodeAddOn.h"
+#include "Interfaces/FlowPredicateInterface.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_BlackboardPredicateBranch)
+
+const FName UFlowNode_BlackboardPredicateBranch::OUTPIN_True(TEXT("True"));
+const FName UFlowNode_BlackboardPredicateBranch::OUTPIN_False(TEXT("False"));
+
+UFlowNode_BlackboardPredicateBranch::UFlowNode_BlackboardPredicateBranch()
+	: Super()
+{
+#if WITH_EDITOR
+	NodeDisplayStyle = FlowNodeStyle::Condition;
+	Category = TEXT("Blackboard");
+#endif
+
+	OutputPins.Reset();
+	OutputPins.Add(FFlowPin(OUTPIN_True));
+	OutputPins.Add(FFlowPin(OUTPIN_False));
+}
+
+EFlowAddOnAcceptResult UFlowNode_BlackboardPredicateBranch::AcceptFlowNodeAddOnChild_Implementation(const UFlowNodeAddOn* AddOnTemplate, const TArray<UFlowNodeAddOn*>& AdditionalAddOnsToAssumeAreChildren) const
+{
+	if (IFlowPredicateInterface::ImplementsInterfaceSafe(AddOnTemplate))
+	{
+		return EFlowAddOnAcceptResult::TentativeAccept;
+	}
+
+	return Super::AcceptFlowNodeAddOnChild_Implementation(AddOnTemplate, AdditionalAddOnsToAssumeAreChildren);
+}
+
+void UFlowNode_BlackboardPredicateBranch::ExecuteInput(const FName& PinName)
+{
+	Super::ExecuteInput(PinName);
+
+	// Executing again while a batched evaluation is pending restarts the evaluation
+	CancelBatchedEvaluation();
+
+	if (bDeferToPredicateBatch && RequestBatchedEvaluation())
+	{
+		return;
+	}
+
+	constexpr bool bFinish = true;
+	TriggerOutput(EvaluatePredicateAddOns() ? OUTPIN_True : OUTPIN_False, bFinish);
+}
+
+void UFlowNode_BlackboardPredicateBranch::Cleanup()
+{
+	CancelBatchedEvaluation();
+
+	Super::Cleanup();
+}
+
+void UFlowNode_BlackboardPredicateBranch::ResetInstanceForReuse()
+{
+	Super::ResetInstanceForReuse();
+
+	CancelBatchedEvaluation();
+}
+
+bool UFlowNode_BlackboardPredicateBranch::EvaluatePredicateAddOns()
+{
+	// The predicates share their resolved blackboards and gathered key values
+	FAIFlowScopedPredicateEvaluationContext EvaluationScope(*this);
+
+	bool bResult = true;
+
+	(void) ForEachAddOnForClass<UFlowPredicateInterface>(
+		[&bResult](UFlowNodeAddOn& AddOn)
+		{
+			if (!IFlowPredicateInterface::Execute_EvaluatePredicate(&AddOn))
+			{
+				bResult = false;
+
+				return EFlowForEachAddOnFunctionReturnValue::BreakWithFailure;
+			}
+
+			return EFlowForEachAddOnFunctionReturnValue::Continue;
+		});
+
+	return bResult;
+}
+
+bool UFlowNode_BlackboardPredicateBranch::RequestBatchedEvaluation()
+{
+	UWorld* World = GetWorld();
+	UAIFlowPredicateBatchSubsystem* BatchSubsystem = IsValid(World) ? World->GetSubsystem<UAIFlowPredicateBatchSubsystem>() : nullptr;
+	if (!BatchSubsystem)
+	{
+		return false;
+	}
+
+	TArray<const UFlowNodeAddOn*, TInlineAllocator<4>> PredicateAddOns;
+	(void) ForEachAddOnForClass<UFlowPredicateInterface>(
+		[&PredicateAddOns](UFlowNodeAddOn& AddOn)
+		{
+			PredicateAddOns.Add(&AddOn);
+
+			return EFlowForEachAddOnFunctionReturnValue::Continue;
+		});
+
+	if (PredicateAddOns.IsEmpty())
+	{
+		return false;
+	}
+
+	++BatchedEvaluationSerial;
+	NumPendingBatchedResults = PredicateAddOns.Num();
+	bBatchedResult = true;
+
+	for (const UFlowNodeAddOn* PredicateAddOn : PredicateAddOns)
+	{
+		BatchSubsystem->RequestEvaluation(
+			*PredicateAddOn,
+			FAIFlowOnBatchedPredicateEvaluated::CreateUObject(this, &ThisClass::OnBatchedPredicateEvaluated, BatchedEvaluationSerial));
+	}
+
+	return true;
+}
+
+void UFlowNode_BlackboardPredicateBranch::OnBatchedPredicateEvaluated(bool bResult, uint32 EvaluationSerial)
+{
+	if (EvaluationSerial != BatchedEvaluationSerial || NumPendingBatchedResults <= 0)
+	{
+		return;
+	}
+
+	bBatchedResult &= bResult;
+
+	if (--NumPendingBatchedResults > 0)
+	{
+		return;
+	}
+
+	constexpr bool bFinish = true;
+	TriggerOutput(bBatchedResult ? OUTPIN_True : OUTPIN_False, bFinish);
+}
+
+void UFlowNode_BlackboardPredicateBranch::CancelBatchedEvaluation()
+{
+	if (NumPendingBatchedResults > 0)
+	{
+		// The results that are still pending are discarded when they are delivered
+		++BatchedEvaluationSerial;
+		NumPendingBatchedResults = 0;
+	}
+
+	bBatchedResult = true;
+}
@@ -4,6 +4,7 @@
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Types/FlowInjectComponentsManager.h"
 #include "AIFlowAsset.h"
+#include "AIFlowInjectComponentsManagerHelper.h"
 #include "AIFlowTags.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_EnsureActorHasBlackboard)
@@ -80,13 +81,21 @@ UBlackboardComponent* UFlowNode_EnsureActorHasBlackboard::EnsureActorHasBlackboa
 	}
 
 	// Find or inject the blackboard
-	return FAIFlowActorBlackboardHelper::FindOrAddBlackboardComponentOnActor(
-		ResolvedActor,
-		InjectComponentsManager,
-		BlackboardComponentClass,
-		SpecificBlackboardAsset,
-		BlackboardSearchRule,
-		InjectRule);
+	UBlackboardComponent* BlackboardComponent =
+		FAIFlowActorBlackboardHelper::FindOrAddBlackboardComponentOnActor(
+			ResolvedActor,
+			InjectComponentsManager,
+			BlackboardComponentClass,
+			SpecificBlackboardAsset,
+			BlackboardSearchRule,
+			InjectRule);
+
+	if (bMayInjectComponent)
+	{
+		FAIFlowInjectComponentsManagerHelper::NoteInjectedBlackboardComponentOwner(*this, InjectComponentsManager, BlackboardComponent);
+	}
+
+	return BlackboardComponent;
 }
 
 void UFlowNode_EnsureActorHasBlackboard::DeinitializeInstance()
@@ -98,26 +107,12 @@ void UFlowNode_EnsureActorHasBlackboard::DeinitializeInstance()
 
 void UFlowNode_EnsureActorHasBlackboard::EnsureInjectComponentsManager()
 {
-	if (IsValid(InjectComponentsManager))
-	{
-		return;
-	}
-
-	InjectComponentsManager = NewObject<UFlowInjectComponentsManager>(this);
-
-	InjectComponentsManager->InitializeRuntime();
-	InjectComponentsManager->BeforeActorRemovedDelegate.AddDynamic(this, &ThisClass::OnBeforeActorRemoved);
+	FAIFlowInjectComponentsManagerHelper::EnsureManager(*this, InjectComponentsManager, GET_FUNCTION_NAME_CHECKED(UFlowNode_EnsureActorHasBlackboard, OnBeforeActorRemoved));
 }
 
 void UFlowNode_EnsureActorHasBlackboard::CleanupInjectComponentsManager()
 {
-	if (IsValid(InjectComponentsManager))
-	{
-		InjectComponentsManager->ShutdownRuntime();
-		InjectComponentsManager->BeforeActorRemovedDelegate.RemoveDynamic(this, &ThisClass::OnBeforeActorRemoved);
-	}
-
-	InjectComponentsManager = nullptr;
+	FAIFlowInjectComponentsManagerHelper::CleanupManager(*this, InjectComponentsManager, GET_FUNCTION_NAME_CHECKED(UFlowNode_EnsureActorHasBlackboard, OnBeforeActorRemoved));
 }
 
 void UFlowNode_EnsureActorHasBlackboard::OnBeforeActorRemoved(AActor* RemovedActor)
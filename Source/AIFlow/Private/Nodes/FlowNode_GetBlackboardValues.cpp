@@ -1,12 +1,17 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "Nodes/FlowNode_GetBlackboardValues.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
 #include "Blackboard/FlowBlackboardEntryValue.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "AIFlowAsset.h"
 #include "AIFlowTags.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType.h"
 #include "Blackboard/FlowBlackboardEntryValue_Enum.h"
+#include "Mass/AIFlowMassBlackboardFragment.h"
+#include "Mass/AIFlowMassBlackboardSubsystem.h"
+#include "Subsystems/AIFlowBlackboardKeyAgeSubsystem.h"
+#include "Engine/World.h"
 #include "Types/FlowAutoDataPinsWorkingData.h"
 #include "Types/FlowDataPinValuesStandard.h"
 #include "StructUtils/InstancedStruct.h"
@@ -115,7 +120,9 @@ void UFlowNode_GetBlackboardValues::PostEditChangeChainProperty(FPropertyChanged
 
 	const uint32 PropertyChangedTypeFlags = (PropertyChainEvent.ChangeType & RelevantChangeTypesForReconstructionMask);
 	const bool bIsRelevantChangeTypeForReconstruction = PropertyChangedTypeFlags != 0;
-	const bool bChangedOutputProperties = Property->GetFName() == GET_MEMBER_NAME_CHECKED(ThisClass, BlackboardEntries);
+	const bool bChangedOutputProperties =
+		Property->GetFName() == GET_MEMBER_NAME_CHECKED(ThisClass, BlackboardEntries) ||
+		Property->GetFName() == GET_MEMBER_NAME_CHECKED(ThisClass, KeyAgeEntries);
 	if (bIsRelevantChangeTypeForReconstruction && bChangedOutputProperties)
 	{
 		OnReconstructionRequested.ExecuteIfBound();
@@ -202,6 +209,31 @@ void UFlowNode_GetBlackboardValues::AutoGenerateDataPins(FFlowDataPinValueOwner&
 			LogError(FString::Printf(TEXT("Could not auto-generate pins: blackboard asset could not provide a value for pin name %s."), *PinName.ToString()), EFlowOnScreenMessageType::Temporary);
 		}
 	}
+
+	for (const FFlowBlackboardEntry& KeyAgeEntry : KeyAgeEntries)
+	{
+		if (KeyAgeEntry.KeyName.IsNone())
+		{
+			continue;
+		}
+
+		const FName PinName = MakeKeyAgePinName(KeyAgeEntry.KeyName);
+
+		if (!GetBlackboardKeyTypeFromBlackboardKeyName(BlackboardAssetForEditor, KeyAgeEntry.KeyName))
+		{
+			LogError(FString::Printf(TEXT("Could not auto-generate pins: blackboard asset has no key for pin name %s."), *PinName.ToString()), EFlowOnScreenMessageType::Temporary);
+
+			continue;
+		}
+
+		const FFlowDataPinValue_Float FlowDataPinValue(0.0f);
+		if (const FFlowPinType* FlowPinType = FFlowPinType::LookupPinType(FlowDataPinValue.GetPinTypeName()))
+		{
+			FFlowPin NewFlowPin = FlowPinType->CreateFlowPinFromValueWrapper(PinName, FlowDataPinValue);
+
+			InOutWorkingData.AutoOutputDataPinsNext.Add(FFlowPinSourceData(NewFlowPin, ValueOwner));
+		}
+	}
 }
 
 #endif // WITH_EDITOR
@@ -224,17 +256,7 @@ UBlackboardKeyType* UFlowNode_GetBlackboardValues::GetBlackboardKeyTypeFromBlack
 		return nullptr;
 	}
 
-	const FBlackboard::FKey KeyID = BlackboardAsset->GetKeyID(KeyName);
-
-	if (KeyID != FBlackboard::InvalidKey)
-	{
-		if (const FBlackboardEntry* BlackboardKey = BlackboardAsset->GetKey(KeyID))
-		{
-			return BlackboardKey->KeyType;
-		}
-	}
-
-	return nullptr;
+	return FAIFlowBlackboardKeyTable::Get(*BlackboardAsset)->FindKeyType(KeyName);
 }
 
 FFlowDataPinResult UFlowNode_GetBlackboardValues::TrySupplyDataPin(FName PinName) const
@@ -244,21 +266,17 @@ FFlowDataPinResult UFlowNode_GetBlackboardValues::TrySupplyDataPin(FName PinName
 		return Super::TrySupplyDataPin(PinName);
 	}
 
+	FName KeyAgeKeyName;
+	if (TryFindKeyAgeKeyNameForPin(PinName, KeyAgeKeyName))
+	{
+		return SupplyKeyAgeDataPin(KeyAgeKeyName);
+	}
+
 	if (UBlackboardComponent* BlackboardComponent = GetBlackboardComponentToApplyTo())
 	{
 		auto GetBlackboardKeyType = [](const UBlackboardComponent& BlackboardComponent, const FName& KeyName) -> UBlackboardKeyType*
 		{
-			UBlackboardData* BlackboardAsset = BlackboardComponent.GetBlackboardAsset();
-			if (IsValid(BlackboardAsset))
-			{
-				const FBlackboard::FKey KeyID = BlackboardAsset->GetKeyID(KeyName);
-				if (KeyID != FBlackboard::InvalidKey)
-				{
-					const FBlackboardEntry* BlackboardEntry = BlackboardAsset->GetKey(KeyID);
-					return BlackboardEntry->KeyType;
-				}
-			}
-			return nullptr;
+			return GetBlackboardKeyTypeFromBlackboardKeyName(BlackboardComponent.GetBlackboardAsset(), KeyName);
 		};
 
 		const UBlackboardKeyType* BlackboardKeyType = GetBlackboardKeyType(*BlackboardComponent, PinName);
@@ -279,5 +297,82 @@ FFlowDataPinResult UFlowNode_GetBlackboardValues::TrySupplyDataPin(FName PinName
 		return SuppliedResult;
 	}
 
+	if (const FAIFlowMassBlackboardFragment* MassBlackboardFragment = FindMassBlackboardFragmentToReadFrom())
+	{
+		const FBlackboard::FKey KeyID = MassBlackboardFragment->GetKeyID(PinName);
+		const UBlackboardKeyType* BlackboardKeyType = MassBlackboardFragment->GetKeyType(KeyID);
+		if (BlackboardKeyType == nullptr)
+		{
+			LogWarning(FString::Printf(TEXT("Asked for BlackboardEntry for key (%s), which could not be found in the Mass agent's blackboard %s."), *PinName.ToString(), *GetNameSafe(MassBlackboardFragment->GetBlackboardData())));
+
+			return Super::TrySupplyDataPin(PinName);
+		}
+
+		FFlowDataPinResult SuppliedResult;
+
+		SuppliedResult.Result =
+			FAIFlowActorBlackboardHelper::TryProvideFlowDataPinPropertyFromRawKeyMemory(
+				*BlackboardKeyType,
+				MassBlackboardFragment->GetKeyRawData(KeyID),
+				SuppliedResult.ResultValue);
+
+		return SuppliedResult;
+	}
+
 	return Super::TrySupplyDataPin(PinName);
 }
+
+FName UFlowNode_GetBlackboardValues::MakeKeyAgePinName(const FName& KeyName)
+{
+	return FName(*FString::Printf(TEXT("%s Age"), *KeyName.ToString()));
+}
+
+bool UFlowNode_GetBlackboardValues::TryFindKeyAgeKeyNameForPin(const FName& PinName, FName& OutKeyName) const
+{
+	for (const FFlowBlackboardEntry& KeyAgeEntry : KeyAgeEntries)
+	{
+		if (!KeyAgeEntry.KeyName.IsNone() && MakeKeyAgePinName(KeyAgeEntry.KeyName) == PinName)
+		{
+			OutKeyName = KeyAgeEntry.KeyName;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+FFlowDataPinResult UFlowNode_GetBlackboardValues::SupplyKeyAgeDataPin(const FName& KeyName) const
+{
+	FFlowDataPinResult SuppliedResult;
+
+	UBlackboardComponent* BlackboardComponent = GetBlackboardComponentToApplyTo();
+	UWorld* World = GetWorld();
+	UAIFlowBlackboardKeyAgeSubsystem* KeyAgeSubsystem = IsValid(World) ? World->GetSubsystem<UAIFlowBlackboardKeyAgeSubsystem>() : nullptr;
+	if (!BlackboardComponent || !KeyAgeSubsystem)
+	{
+		// Mass agents' blackboard fragments are written in bulk, so their key write times are not tracked
+		LogWarning(FString::Printf(TEXT("Asked for the age of key (%s), without a blackboard component to track it on."), *KeyName.ToString()));
+
+		SuppliedResult.Result = EFlowDataPinResolveResult::FailedWithError;
+
+		return SuppliedResult;
+	}
+
+	float AgeSeconds = -1.0f;
+	if (!KeyAgeSubsystem->TryGetKeyAge(*BlackboardComponent, KeyName, AgeSeconds))
+	{
+		AgeSeconds = -1.0f;
+	}
+
+	SuppliedResult.Result = EFlowDataPinResolveResult::Success;
+	SuppliedResult.ResultValue.InitializeAs<FFlowDataPinValue_Float>(AgeSeconds);
+
+	return SuppliedResult;
+}
+
+const FAIFlowMassBlackboardFragment* UFlowNode_GetBlackboardValues::FindMassBlackboardFragmentToReadFrom() const
+{
+	// Restricted to the SpecificBlackboardAsset, as GetBlackboardComponentToApplyTo() does
+	return UAIFlowMassBlackboardSubsystem::FindBlackboardFragmentForActorInWorld(GetWorld(), TryResolveActorForBlackboard(), SpecificBlackboardAsset);
+}
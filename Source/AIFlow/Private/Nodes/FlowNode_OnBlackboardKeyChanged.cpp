@@ -0,0 +1,240 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Nodes/FlowNode_OnBlackboardKeyChanged.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "Blackboard/FlowBlackboardEntryValue.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_OnBlackboardKeyChanged)
+
+const FName UFlowNode_OnBlackboardKeyChanged::INPIN_Stop(TEXT("Stop"));
+const FName UFlowNode_OnBlackboardKeyChanged::OUTPIN_Changed(TEXT("Changed"));
+const FName UFlowNode_OnBlackboardKeyChanged::OUTPIN_Stopped(TEXT("Stopped"));
+const FName UFlowNode_OnBlackboardKeyChanged::OUTPIN_Failed(TEXT("Failed"));
+
+UFlowNode_OnBlackboardKeyChanged::UFlowNode_OnBlackboardKeyChanged()
+	: Super()
+{
+#if WITH_EDITOR
+	NodeDisplayStyle = FlowNodeStyle::Blackboard;
+	Category = TEXT("Blackboard");
+#endif
+
+	InputPins.Add(FFlowPin(INPIN_Stop));
+
+	OutputPins.Reset();
+	OutputPins.Add(FFlowPin(OUTPIN_Changed));
+	OutputPins.Add(FFlowPin(OUTPIN_Stopped));
+	OutputPins.Add(FFlowPin(OUTPIN_Failed));
+}
+
+void UFlowNode_OnBlackboardKeyChanged::ExecuteInput(const FName& PinName)
+{
+	Super::ExecuteInput(PinName);
+
+	if (PinName == INPIN_Stop)
+	{
+		constexpr bool bFinish = true;
+		TriggerOutput(OUTPIN_Stopped, bFinish);
+
+		return;
+	}
+
+	if (!StartObserving())
+	{
+		constexpr bool bFinish = true;
+		TriggerOutput(OUTPIN_Failed, bFinish);
+	}
+}
+
+void UFlowNode_OnBlackboardKeyChanged::DeinitializeInstance()
+{
+	StopObserving();
+
+	Super::DeinitializeInstance();
+}
+
+void UFlowNode_OnBlackboardKeyChanged::Cleanup()
+{
+	StopObserving();
+
+	Super::Cleanup();
+}
+
+void UFlowNode_OnBlackboardKeyChanged::ResetInstanceForReuse()
+{
+	Super::ResetInstanceForReuse();
+
+	StopObserving();
+}
+
+#if WITH_EDITOR
+UBlackboardData* UFlowNode_OnBlackboardKeyChanged::GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const
+{
+	if (IsValid(SpecificBlackboardAsset))
+	{
+		return SpecificBlackboardAsset;
+	}
+
+	return Super::GetBlackboardAssetForPropertyHandle(PropertyHandle);
+}
+#endif // WITH_EDITOR
+
+bool UFlowNode_OnBlackboardKeyChanged::StartObserving()
+{
+	// Restarting re-resolves the blackboard (and discards any pending coalesced or debounced trigger)
+	StopObserving();
+
+	const FAIFlowCachedBlackboardReference CachedBlackboard(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+	if (!CachedBlackboard.IsValid())
+	{
+		LogError(TEXT("Cannot observe blackboard keys without a Blackboard Component or Asset"));
+
+		return false;
+	}
+
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(*CachedBlackboard.BlackboardData);
+
+	TArray<FBlackboard::FKey, TInlineAllocator<8>> ObservedKeyIDs;
+	for (const FFlowBlackboardEntry& Key : KeysToObserve)
+	{
+		const FBlackboard::FKey KeyID = KeyTable->FindKeyID(Key.GetKeyName());
+		if (KeyID == FBlackboard::InvalidKey)
+		{
+			LogError(FString::Printf(TEXT("Blackboard %s has no key %s to observe"), *CachedBlackboard.BlackboardData->GetName(), *Key.GetKeyName().ToString()));
+
+			continue;
+		}
+
+		ObservedKeyIDs.AddUnique(KeyID);
+	}
+
+	if (ObservedKeyIDs.IsEmpty())
+	{
+		LogError(TEXT("Cannot observe blackboard keys without any valid Keys To Observe"));
+
+		return false;
+	}
+
+	BuildValueFilters(*CachedBlackboard.BlackboardData);
+
+	UBlackboardComponent& BlackboardComponent = *CachedBlackboard.BlackboardComponent;
+	for (const FBlackboard::FKey KeyID : ObservedKeyIDs)
+	{
+		BlackboardComponent.RegisterObserver(KeyID, this, FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnObservedKeyChanged));
+	}
+
+	ObservedBlackboardComponent = &BlackboardComponent;
+
+	return true;
+}
+
+void UFlowNode_OnBlackboardKeyChanged::StopObserving()
+{
+	if (UBlackboardComponent* BlackboardComponent = ObservedBlackboardComponent.Get())
+	{
+		BlackboardComponent->UnregisterObserversFrom(this);
+	}
+
+	ObservedBlackboardComponent.Reset();
+	FiltersByKeyID.Reset();
+
+	if (DeferredTriggerTimerHandle.IsValid())
+	{
+		if (UWorld* World = GetWorld())
+		{
+			World->GetTimerManager().ClearTimer(DeferredTriggerTimerHandle);
+		}
+
+		DeferredTriggerTimerHandle.Invalidate();
+	}
+}
+
+void UFlowNode_OnBlackboardKeyChanged::BuildValueFilters(const UBlackboardData& BlackboardData)
+{
+	FiltersByKeyID.Reset();
+
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(BlackboardData);
+
+	for (const UFlowBlackboardEntryValue* Filter : ChangeToValueFilters)
+	{
+		if (!IsValid(Filter))
+		{
+			continue;
+		}
+
+		const FBlackboard::FKey KeyID = KeyTable->FindKeyID(Filter->Key.GetKeyName());
+		if (KeyID == FBlackboard::InvalidKey)
+		{
+			LogError(FString::Printf(TEXT("Blackboard %s has no key %s to filter by"), *BlackboardData.GetName(), *Filter->Key.GetKeyName().ToString()));
+
+			continue;
+		}
+
+		FiltersByKeyID.FindOrAdd(KeyID).Add(Filter);
+	}
+}
+
+bool UFlowNode_OnBlackboardKeyChanged::PassesValueFilters(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey ChangedKeyID) const
+{
+	const TArray<const UFlowBlackboardEntryValue*, TInlineAllocator<2>>* Filters = FiltersByKeyID.Find(ChangedKeyID);
+	if (!Filters)
+	{
+		return true;
+	}
+
+	for (const UFlowBlackboardEntryValue* Filter : *Filters)
+	{
+		if (Filter->CompareKeyValues(&BlackboardComponent, Filter->Key.GetKeyName()) == EBlackboardCompare::Equal)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+EBlackboardNotificationResult UFlowNode_OnBlackboardKeyChanged::OnObservedKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey ChangedKeyID)
+{
+	if (ObservedBlackboardComponent.Get() != &BlackboardComponent)
+	{
+		return EBlackboardNotificationResult::RemoveObserver;
+	}
+
+	if (!PassesValueFilters(BlackboardComponent, ChangedKeyID))
+	{
+		return EBlackboardNotificationResult::ContinueObserving;
+	}
+
+	UWorld* World = GetWorld();
+
+	if (DebounceSeconds > 0.0f && World)
+	{
+		// Each change restarts the debounce interval
+		World->GetTimerManager().SetTimer(DeferredTriggerTimerHandle, FTimerDelegate::CreateUObject(this, &ThisClass::OnDeferredTrigger), DebounceSeconds, false);
+	}
+	else if (bCoalescePerFrame && World)
+	{
+		// The rest of this frame's changes are folded into the pending trigger
+		if (!DeferredTriggerTimerHandle.IsValid())
+		{
+			DeferredTriggerTimerHandle = World->GetTimerManager().SetTimerForNextTick(FTimerDelegate::CreateUObject(this, &ThisClass::OnDeferredTrigger));
+		}
+	}
+	else
+	{
+		TriggerOutput(OUTPIN_Changed);
+	}
+
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
+void UFlowNode_OnBlackboardKeyChanged::OnDeferredTrigger()
+{
+	DeferredTriggerTimerHandle.Invalidate();
+
+	TriggerOutput(OUTPIN_Changed);
+}
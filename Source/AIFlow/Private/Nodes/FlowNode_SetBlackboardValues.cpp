@@ -7,10 +7,13 @@
 #include "Types/FlowInjectComponentsManager.h"
 #include "Types/FlowDataPinValue.h"
 #include "AIFlowAsset.h"
+#include "AIFlowInjectComponentsManagerHelper.h"
 #include "AIFlowTags.h"
 
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_SetBlackboardValues)
 
+const FName UFlowNode_SetBlackboardValues::OUTPIN_Completed(TEXT("Completed"));
+
 UFlowNode_SetBlackboardValues::UFlowNode_SetBlackboardValues()
 	: Super()
 {
@@ -19,12 +22,17 @@ UFlowNode_SetBlackboardValues::UFlowNode_SetBlackboardValues()
 	Category = TEXT("Deprecated");
 	bNodeDeprecated = true;
 #endif
+
+	OutputPins.Add(FFlowPin(OUTPIN_Completed));
 }
 
 void UFlowNode_SetBlackboardValues::ExecuteInput(const FName& PinName)
 {
 	Super::ExecuteInput(PinName);
 
+	// Cancel the time-sliced application from a previous execution (if it is still in progress)
+	CancelTimeSlicedApplication();
+
 	// Refresh EntriesForEveryActor from data pin input values
 	for (UFlowBlackboardEntryValue* BlackboardEntry : EntriesForEveryActor.Entries)
 	{
@@ -52,8 +60,31 @@ void UFlowNode_SetBlackboardValues::ExecuteInput(const FName& PinName)
 	(void) TryGetPerActorOptions(PerActorOptions, PerActorOptionsAssignmentMethod);
 
 	// Apply the values to the blackboards
+	ActorBlackboardHelper.SetAssignmentSeed(GetRandomSeed());
+
 	const TArray<UBlackboardComponent*> BlackboardComponents = GetBlackboardComponentsToApplyTo();
-	if (!BlackboardComponents.IsEmpty())
+	if (bTimeSliceApplication && !BlackboardComponents.IsEmpty())
+	{
+		ActorBlackboardHelper.BeginTimeSlicedApplication(BlackboardComponents, PerActorOptionsAssignmentMethod, PerActorOptions);
+
+		// Apply the first slice (and schedule the next) before "Out" is triggered,
+		// so that "Out"'s branch can finish or re-execute this node without a slice still to come
+		const bool bIsComplete = ApplyNextTimeSlice();
+		const uint32 ApplicationSerial = ActorBlackboardHelper.GetTimeSlicedApplicationSerial();
+
+		// "Out" is triggered when the application begins, "Completed" once it has been applied to every blackboard
+		TriggerFirstOutput(false);
+
+		// Unless "Out"'s branch has already finished, deinitialized or re-executed this node
+		if (bIsComplete && ActorBlackboardHelper.GetTimeSlicedApplicationSerial() == ApplicationSerial)
+		{
+			constexpr bool bIsFinished = true;
+			TriggerOutput(OUTPIN_Completed, bIsFinished);
+		}
+
+		return;
+	}
+	else if (!BlackboardComponents.IsEmpty())
 	{
 		for (UBlackboardComponent* BlackboardComponent : BlackboardComponents)
 		{
@@ -78,33 +109,64 @@ void UFlowNode_SetBlackboardValues::ExecuteInput(const FName& PinName)
 
 void UFlowNode_SetBlackboardValues::DeinitializeInstance()
 {
+	CancelTimeSlicedApplication();
 	CleanupInjectComponentsManager();
 
 	Super::DeinitializeInstance();
 }
 
-void UFlowNode_SetBlackboardValues::EnsureInjectComponentsManager()
+void UFlowNode_SetBlackboardValues::Cleanup()
 {
-	if (IsValid(InjectComponentsManager))
-	{
-		return;
-	}
+	CancelTimeSlicedApplication();
 
-	InjectComponentsManager = NewObject<UFlowInjectComponentsManager>(this);
+	Super::Cleanup();
+}
 
-	InjectComponentsManager->InitializeRuntime();
-	InjectComponentsManager->BeforeActorRemovedDelegate.AddDynamic(this, &ThisClass::OnBeforeActorRemoved);
+bool UFlowNode_SetBlackboardValues::ApplyNextTimeSlice()
+{
+	// The Per-Actor Options are re-fetched each slice, because subclasses may own them
+	const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions = nullptr;
+	EPerActorOptionsAssignmentMethod PerActorOptionsAssignmentMethod = EPerActorOptionsAssignmentMethod::Invalid;
+	(void) TryGetPerActorOptions(PerActorOptions, PerActorOptionsAssignmentMethod);
+
+	return ActorBlackboardHelper.ApplyNextTimeSliceAndScheduleNext(
+		GetWorld(),
+		EntriesForEveryActor,
+		PerActorOptions,
+		MaxBlackboardsPerFrame,
+		MaxMicrosecondsPerFrame,
+		FTimerDelegate::CreateUObject(this, &ThisClass::OnNextTimeSlice));
 }
 
-void UFlowNode_SetBlackboardValues::CleanupInjectComponentsManager()
+void UFlowNode_SetBlackboardValues::OnNextTimeSlice()
 {
-	if (IsValid(InjectComponentsManager))
+	if (ApplyNextTimeSlice())
 	{
-		InjectComponentsManager->ShutdownRuntime();
-		InjectComponentsManager->BeforeActorRemovedDelegate.RemoveDynamic(this, &ThisClass::OnBeforeActorRemoved);
+		constexpr bool bIsFinished = true;
+		TriggerOutput(OUTPIN_Completed, bIsFinished);
 	}
+}
+
+void UFlowNode_SetBlackboardValues::CancelTimeSlicedApplication()
+{
+	ActorBlackboardHelper.CancelTimeSlicedApplication();
+}
+
+void UFlowNode_SetBlackboardValues::ResetInstanceForReuse()
+{
+	Super::ResetInstanceForReuse();
+
+	ActorBlackboardHelper.ResetOptionAssignmentState();
+}
+
+void UFlowNode_SetBlackboardValues::EnsureInjectComponentsManager()
+{
+	FAIFlowInjectComponentsManagerHelper::EnsureManager(*this, InjectComponentsManager, GET_FUNCTION_NAME_CHECKED(UFlowNode_SetBlackboardValues, OnBeforeActorRemoved));
+}
 
-	InjectComponentsManager = nullptr;
+void UFlowNode_SetBlackboardValues::CleanupInjectComponentsManager()
+{
+	FAIFlowInjectComponentsManagerHelper::CleanupManager(*this, InjectComponentsManager, GET_FUNCTION_NAME_CHECKED(UFlowNode_SetBlackboardValues, OnBeforeActorRemoved));
 }
 
 void UFlowNode_SetBlackboardValues::OnBeforeActorRemoved(AActor* RemovedActor)
@@ -161,6 +223,11 @@ TArray<UBlackboardComponent*> UFlowNode_SetBlackboardValues::GetBlackboardCompon
 			SpecificBlackboardSearchRule,
 			InjectRule);
 
+	for (const UBlackboardComponent* BlackboardComponent : BlackboardComponents)
+	{
+		FAIFlowInjectComponentsManagerHelper::NoteInjectedBlackboardComponentOwner(*this, InjectComponentsManager, BlackboardComponent);
+	}
+
 	return BlackboardComponents;
 }
 
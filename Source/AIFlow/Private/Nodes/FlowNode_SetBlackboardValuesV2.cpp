@@ -4,10 +4,12 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "AIFlowAsset.h"
+#include "AIFlowInjectComponentsManagerHelper.h"
 #include "AIFlowTags.h"
 #include "Types/FlowAutoDataPinsWorkingData.h"
 #include "Types/FlowDataPinValue.h"
 #include "Blackboard/FlowBlackboardEntryValue.h"
+#include "Engine/World.h"
 
 #if WITH_EDITOR
 #include "PropertyHandle.h"
@@ -16,6 +18,7 @@
 #include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_SetBlackboardValuesV2)
 
 FName UFlowNode_SetBlackboardValuesV2::INPIN_SpecificActors;
+const FName UFlowNode_SetBlackboardValuesV2::OUTPIN_Completed(TEXT("Completed"));
 
 UFlowNode_SetBlackboardValuesV2::UFlowNode_SetBlackboardValuesV2()
 {
@@ -25,12 +28,17 @@ UFlowNode_SetBlackboardValuesV2::UFlowNode_SetBlackboardValuesV2()
 #endif
 
 	INPIN_SpecificActors = GET_MEMBER_NAME_CHECKED(ThisClass, SpecificActors);
+
+	OutputPins.Add(FFlowPin(OUTPIN_Completed));
 }
 
 void UFlowNode_SetBlackboardValuesV2::ExecuteInput(const FName& PinName)
 {
 	UAIFlowNode::ExecuteInput(PinName);
 
+	// Cancel the time-sliced application from a previous execution (if it is still in progress)
+	CancelTimeSlicedApplication();
+
 	// Refresh EntriesForEveryActor from data pin input values
 	for (UFlowBlackboardEntryValue* BlackboardEntry : EntriesForEveryActor.Entries)
 	{
@@ -51,22 +59,48 @@ void UFlowNode_SetBlackboardValuesV2::ExecuteInput(const FName& PinName)
 	}
 
 	// Apply the values to the blackboards
-	const TArray<UBlackboardComponent*> BlackboardComponents = GetBlackboardComponentsToApplyTo();
-	if (!BlackboardComponents.IsEmpty())
+	ActorBlackboardHelper.SetAssignmentSeed(GetRandomSeed());
+
+	TArray<AActor*> ResolvedActors = TryResolveActorsForBlackboard();
+
+	// Actors that represent Mass agents have their writes queued for their blackboard fragments, instead
+	UWorld* World = GetWorld();
+	const int32 NumMassAgents =
+		IsValid(World) ?
+			ActorBlackboardHelper.ExtractAndQueueBlackboardOptionsForMassAgents(*World, ResolvedActors, PerActorOptionsAssignmentMethod, EntriesForEveryActor, &PerActorOptions) :
+			0;
+
+	const TArray<UBlackboardComponent*> BlackboardComponents = GetBlackboardComponentsToApplyTo(ResolvedActors);
+	if (bTimeSliceApplication && !BlackboardComponents.IsEmpty())
 	{
-		for (UBlackboardComponent* BlackboardComponent : BlackboardComponents)
+		ActorBlackboardHelper.BeginTimeSlicedApplication(BlackboardComponents, PerActorOptionsAssignmentMethod, &PerActorOptions);
+
+		// Apply the first slice (and schedule the next) before "Out" is triggered,
+		// so that "Out"'s branch can finish or re-execute this node without a slice still to come
+		const bool bIsComplete = ApplyNextTimeSlice();
+		const uint32 ApplicationSerial = ActorBlackboardHelper.GetTimeSlicedApplicationSerial();
+
+		// "Out" is triggered when the application begins, "Completed" once it has been applied to every blackboard
+		TriggerFirstOutput(false);
+
+		// Unless "Out"'s branch has already finished, deinitialized or re-executed this node
+		if (bIsComplete && ActorBlackboardHelper.GetTimeSlicedApplicationSerial() == ApplicationSerial)
 		{
-			if (IsValid(BlackboardComponent))
-			{
-				ActorBlackboardHelper.ApplyBlackboardOptionsToBlackboardComponent(
-					*BlackboardComponent,
-					PerActorOptionsAssignmentMethod,
-					EntriesForEveryActor,
-					&PerActorOptions);
-			}
+			constexpr bool bIsFinished = true;
+			TriggerOutput(OUTPIN_Completed, bIsFinished);
 		}
+
+		return;
 	}
-	else
+	else if (!BlackboardComponents.IsEmpty())
+	{
+		ActorBlackboardHelper.ApplyBlackboardOptionsToBlackboardComponents(
+			BlackboardComponents,
+			PerActorOptionsAssignmentMethod,
+			EntriesForEveryActor,
+			&PerActorOptions);
+	}
+	else if (NumMassAgents == 0)
 	{
 		LogError(TEXT("Cannot SetBlackboardValues without a Blackboard"));
 	}
@@ -77,6 +111,7 @@ void UFlowNode_SetBlackboardValuesV2::ExecuteInput(const FName& PinName)
 
 void UFlowNode_SetBlackboardValuesV2::DeinitializeInstance()
 {
+	CancelTimeSlicedApplication();
 	CleanupInjectComponentsManager();
 
 	UAIFlowNode::DeinitializeInstance();
@@ -130,7 +165,7 @@ bool UFlowNode_SetBlackboardValuesV2::TryAddSpecificActors(TArray<AActor*>& InOu
 	return false;
 }
 
-TArray<UBlackboardComponent*> UFlowNode_SetBlackboardValuesV2::GetBlackboardComponentsToApplyTo() const
+TArray<UBlackboardComponent*> UFlowNode_SetBlackboardValuesV2::GetBlackboardComponentsToApplyTo(const TArray<AActor*>& ResolvedActors) const
 {
 	// TODO (gtaylor) Consider consolidating with UFlowNode_GetBlackboardValues::GetBlackboardComponentToApplyTo()
 	UBlackboardData* DesiredBlackboardAsset = SpecificBlackboardAsset;
@@ -152,14 +187,21 @@ TArray<UBlackboardComponent*> UFlowNode_SetBlackboardValuesV2::GetBlackboardComp
 		BlackboardComponentClass = UBlackboardComponent::StaticClass();
 	}
 
-	const TArray<AActor*> ResolvedActors = TryResolveActorsForBlackboard();
-	return FAIFlowActorBlackboardHelper::FindOrAddBlackboardComponentOnActors(
-		ResolvedActors,
-		InjectComponentsManager,
-		BlackboardComponentClass,
-		DesiredBlackboardAsset,
-		SpecificBlackboardSearchRule,
-		InjectRule);
+	TArray<UBlackboardComponent*> BlackboardComponents =
+		FAIFlowActorBlackboardHelper::FindOrAddBlackboardComponentOnActors(
+			ResolvedActors,
+			InjectComponentsManager,
+			BlackboardComponentClass,
+			DesiredBlackboardAsset,
+			SpecificBlackboardSearchRule,
+			InjectRule);
+
+	for (const UBlackboardComponent* BlackboardComponent : BlackboardComponents)
+	{
+		FAIFlowInjectComponentsManagerHelper::NoteInjectedBlackboardComponentOwner(*this, InjectComponentsManager, BlackboardComponent);
+	}
+
+	return BlackboardComponents;
 }
 
 bool UFlowNode_SetBlackboardValuesV2::TryFindPropertyByPinName(const FName& PinName, const FProperty*& OutFoundProperty, TInstancedStruct<FFlowDataPinValue>& OutFoundInstancedStruct) const
@@ -189,26 +231,53 @@ bool UFlowNode_SetBlackboardValuesV2::TryFindPropertyByPinName(const FName& PinN
 	return UAIFlowNode::TryFindPropertyByPinName(PinName, OutFoundProperty, OutFoundInstancedStruct);
 }
 
-void UFlowNode_SetBlackboardValuesV2::EnsureInjectComponentsManager()
+void UFlowNode_SetBlackboardValuesV2::ResetInstanceForReuse()
 {
-	if (IsValid(InjectComponentsManager))
+	Super::ResetInstanceForReuse();
+
+	ActorBlackboardHelper.ResetOptionAssignmentState();
+}
+
+void UFlowNode_SetBlackboardValuesV2::Cleanup()
+{
+	CancelTimeSlicedApplication();
+
+	UAIFlowNode::Cleanup();
+}
+
+bool UFlowNode_SetBlackboardValuesV2::ApplyNextTimeSlice()
+{
+	return ActorBlackboardHelper.ApplyNextTimeSliceAndScheduleNext(
+		GetWorld(),
+		EntriesForEveryActor,
+		&PerActorOptions,
+		MaxBlackboardsPerFrame,
+		MaxMicrosecondsPerFrame,
+		FTimerDelegate::CreateUObject(this, &ThisClass::OnNextTimeSlice));
+}
+
+void UFlowNode_SetBlackboardValuesV2::OnNextTimeSlice()
+{
+	if (ApplyNextTimeSlice())
 	{
-		return;
+		constexpr bool bIsFinished = true;
+		TriggerOutput(OUTPIN_Completed, bIsFinished);
 	}
+}
 
-	InjectComponentsManager = NewObject<UFlowInjectComponentsManager>(this);
-	InjectComponentsManager->InitializeRuntime();
-	InjectComponentsManager->BeforeActorRemovedDelegate.AddDynamic(this, &ThisClass::OnBeforeActorRemoved);
+void UFlowNode_SetBlackboardValuesV2::CancelTimeSlicedApplication()
+{
+	ActorBlackboardHelper.CancelTimeSlicedApplication();
+}
+
+void UFlowNode_SetBlackboardValuesV2::EnsureInjectComponentsManager()
+{
+	FAIFlowInjectComponentsManagerHelper::EnsureManager(*this, InjectComponentsManager, GET_FUNCTION_NAME_CHECKED(UFlowNode_SetBlackboardValuesV2, OnBeforeActorRemoved));
 }
 
 void UFlowNode_SetBlackboardValuesV2::CleanupInjectComponentsManager()
 {
-	if (IsValid(InjectComponentsManager))
-	{
-		InjectComponentsManager->ShutdownRuntime();
-		InjectComponentsManager->BeforeActorRemovedDelegate.RemoveDynamic(this, &ThisClass::OnBeforeActorRemoved);
-	}
-	InjectComponentsManager = nullptr;
+	FAIFlowInjectComponentsManagerHelper::CleanupManager(*this, InjectComponentsManager, GET_FUNCTION_NAME_CHECKED(UFlowNode_SetBlackboardValuesV2, OnBeforeActorRemoved));
 }
 
 void UFlowNode_SetBlackboardValuesV2::OnBeforeActorRemoved(AActor* RemovedActor)
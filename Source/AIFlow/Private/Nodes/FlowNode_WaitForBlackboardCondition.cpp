@@ -0,0 +1,208 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Nodes/FlowNode_WaitForBlackboardCondition.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Engine/World.h"
+#include "TimerManager.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(FlowNode_WaitForBlackboardCondition)
+
+const FName UFlowNode_WaitForBlackboardCondition::OUTPIN_ConditionMet(TEXT("Condition Met"));
+const FName UFlowNode_WaitForBlackboardCondition::OUTPIN_TimedOut(TEXT("Timed Out"));
+const FName UFlowNode_WaitForBlackboardCondition::OUTPIN_Failed(TEXT("Failed"));
+
+UFlowNode_WaitForBlackboardCondition::UFlowNode_WaitForBlackboardCondition()
+	: Super()
+{
+#if WITH_EDITOR
+	NodeDisplayStyle = FlowNodeStyle::Blackboard;
+	Category = TEXT("Blackboard");
+#endif
+
+	OutputPins.Reset();
+	OutputPins.Add(FFlowPin(OUTPIN_ConditionMet));
+	OutputPins.Add(FFlowPin(OUTPIN_TimedOut));
+	OutputPins.Add(FFlowPin(OUTPIN_Failed));
+}
+
+void UFlowNode_WaitForBlackboardCondition::ExecuteInput(const FName& PinName)
+{
+	Super::ExecuteInput(PinName);
+
+	// Restart the wait if the node is executed again while waiting
+	StopWaiting();
+
+	constexpr bool bFinish = true;
+
+	const FAIFlowCachedBlackboardReference CachedBlackboard(*this, SpecificBlackboardAsset, SpecificBlackboardSearchRule);
+	if (!CachedBlackboard.IsValid())
+	{
+		LogError(TEXT("Cannot wait for a blackboard condition without a Blackboard Component or Asset"));
+
+		TriggerOutput(OUTPIN_Failed, bFinish);
+
+		return;
+	}
+
+	if (!EnsureProgramCompiled(*CachedBlackboard.BlackboardData))
+	{
+		TriggerOutput(OUTPIN_Failed, bFinish);
+
+		return;
+	}
+
+	if (Program.Execute(*CachedBlackboard.BlackboardComponent))
+	{
+		TriggerOutput(OUTPIN_ConditionMet, bFinish);
+
+		return;
+	}
+
+	StartObservingKeys(*CachedBlackboard.BlackboardComponent);
+
+	if (TimeoutSeconds > 0.0f)
+	{
+		if (UWorld* World = GetWorld())
+		{
+			World->GetTimerManager().SetTimer(TimeoutTimerHandle, FTimerDelegate::CreateUObject(this, &ThisClass::OnTimeout), TimeoutSeconds, false);
+		}
+	}
+}
+
+void UFlowNode_WaitForBlackboardCondition::Cleanup()
+{
+	StopWaiting();
+
+	Super::Cleanup();
+}
+
+void UFlowNode_WaitForBlackboardCondition::ResetInstanceForReuse()
+{
+	Super::ResetInstanceForReuse();
+
+	StopWaiting();
+	Program.Reset();
+}
+
+void UFlowNode_WaitForBlackboardCondition::UpdateNodeConfigText_Implementation()
+{
+#if WITH_EDITOR
+	if (TimeoutSeconds > 0.0f)
+	{
+		SetNodeConfigText(FText::Format(NSLOCTEXT("FlowNode_WaitForBlackboardCondition", "TimeoutConfigText", "Timeout: {0}s"), FText::AsNumber(TimeoutSeconds)));
+	}
+	else
+	{
+		SetNodeConfigText(FText::GetEmpty());
+	}
+#endif // WITH_EDITOR
+}
+
+#if WITH_EDITOR
+
+void UFlowNode_WaitForBlackboardCondition::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	Program.Reset();
+}
+
+UBlackboardData* UFlowNode_WaitForBlackboardCondition::GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const
+{
+	if (IsValid(SpecificBlackboardAsset))
+	{
+		return SpecificBlackboardAsset;
+	}
+
+	return Super::GetBlackboardAssetForPropertyHandle(PropertyHandle);
+}
+
+#endif // WITH_EDITOR
+
+bool UFlowNode_WaitForBlackboardCondition::EnsureProgramCompiled(const UBlackboardData& BlackboardData)
+{
+	if (Program.IsCompiledFor(BlackboardData))
+	{
+		return true;
+	}
+
+	FString CompileError;
+	if (!Program.Compile(BlackboardData, Conditions, CompileError))
+	{
+		LogError(FString::Printf(TEXT("Could not compile blackboard condition: %s"), *CompileError));
+
+		return false;
+	}
+
+	return true;
+}
+
+void UFlowNode_WaitForBlackboardCondition::StartObservingKeys(UBlackboardComponent& BlackboardComponent)
+{
+	TArray<FBlackboard::FKey, TInlineAllocator<8>> ObservedKeyIDs;
+
+	for (const FAIFlowBlackboardExpressionInstruction& Instruction : Program.GetInstructions())
+	{
+		ObservedKeyIDs.AddUnique(Instruction.LeftKeyID);
+
+		if (Instruction.RightKeyID != FBlackboard::InvalidKey)
+		{
+			ObservedKeyIDs.AddUnique(Instruction.RightKeyID);
+		}
+	}
+
+	for (const FBlackboard::FKey KeyID : ObservedKeyIDs)
+	{
+		BlackboardComponent.RegisterObserver(KeyID, this, FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnObservedKeyChanged));
+	}
+
+	ObservedBlackboardComponent = &BlackboardComponent;
+}
+
+void UFlowNode_WaitForBlackboardCondition::StopWaiting()
+{
+	if (UBlackboardComponent* BlackboardComponent = ObservedBlackboardComponent.Get())
+	{
+		BlackboardComponent->UnregisterObserversFrom(this);
+	}
+
+	ObservedBlackboardComponent.Reset();
+
+	if (TimeoutTimerHandle.IsValid())
+	{
+		if (UWorld* World = GetWorld())
+		{
+			World->GetTimerManager().ClearTimer(TimeoutTimerHandle);
+		}
+
+		TimeoutTimerHandle.Invalidate();
+	}
+}
+
+EBlackboardNotificationResult UFlowNode_WaitForBlackboardCondition::OnObservedKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey ChangedKeyID)
+{
+	if (ObservedBlackboardComponent.Get() != &BlackboardComponent)
+	{
+		return EBlackboardNotificationResult::RemoveObserver;
+	}
+
+	if (!Program.Execute(BlackboardComponent))
+	{
+		return EBlackboardNotificationResult::ContinueObserving;
+	}
+
+	// Finishing the node removes the observers (the blackboard component supports this during its notifications)
+	constexpr bool bFinish = true;
+	TriggerOutput(OUTPIN_ConditionMet, bFinish);
+
+	return EBlackboardNotificationResult::RemoveObserver;
+}
+
+void UFlowNode_WaitForBlackboardCondition::OnTimeout()
+{
+	TimeoutTimerHandle.Invalidate();
+
+	constexpr bool bFinish = true;
+	TriggerOutput(OUTPIN_TimedOut, bFinish);
+}
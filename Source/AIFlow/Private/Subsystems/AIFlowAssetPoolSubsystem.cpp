@@ -0,0 +1,149 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Subsystems/AIFlowAssetPoolSubsystem.h"
+#include "AIFlowAsset.h"
+#include "AIFlowLogChannels.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowAssetPoolSubsystem)
+
+void UAIFlowAssetPoolSubsystem::Deinitialize()
+{
+	EmptyPools();
+
+	Super::Deinitialize();
+}
+
+UAIFlowAsset* UAIFlowAssetPoolSubsystem::AcquireOrCreateInstance(UAIFlowAsset& TemplateAsset, UObject& Outer, const TWeakObjectPtr<UObject> InOwner)
+{
+	UAIFlowAsset* Instance = AcquireOrCreateUninitializedInstance(TemplateAsset, Outer);
+
+	Instance->InitializeInstance(InOwner, TemplateAsset);
+
+	return Instance;
+}
+
+void UAIFlowAssetPoolSubsystem::AcquireOrCreateInstances(UAIFlowAsset& TemplateAsset, UObject& Outer, TArrayView<const TWeakObjectPtr<UObject>> Owners, TArray<UAIFlowAsset*>& OutInstances)
+{
+	OutInstances.Reset(Owners.Num());
+
+	for (int32 Index = 0; Index < Owners.Num(); ++Index)
+	{
+		OutInstances.Add(AcquireOrCreateUninitializedInstance(TemplateAsset, Outer));
+	}
+
+	UAIFlowAsset::InitializeInstances(TemplateAsset, OutInstances, Owners);
+}
+
+UAIFlowAsset* UAIFlowAssetPoolSubsystem::AcquireOrCreateUninitializedInstance(UAIFlowAsset& TemplateAsset, UObject& Outer)
+{
+	UAIFlowAsset* Instance = TryAcquireInstance(TemplateAsset);
+	if (IsValid(Instance) && Instance->GetOuter() != &Outer)
+	{
+		// Move the pooled instance into the caller's Outer, as if it had been created there
+		const FName InstanceName = MakeUniqueObjectName(&Outer, TemplateAsset.GetClass(), TemplateAsset.GetFName());
+		Instance->Rename(*InstanceName.ToString(), &Outer, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+	}
+	else if (!IsValid(Instance))
+	{
+		// Created as the flow subsystem does, as a transient object with the template as its archetype
+		const FName InstanceName = MakeUniqueObjectName(&Outer, TemplateAsset.GetClass(), TemplateAsset.GetFName());
+		Instance = NewObject<UAIFlowAsset>(&Outer, TemplateAsset.GetClass(), InstanceName, RF_Transient, &TemplateAsset);
+	}
+
+	TemplateAsset.AddInstance(Instance);
+
+	return Instance;
+}
+
+void UAIFlowAssetPoolSubsystem::ReleaseInstance(UAIFlowAsset& Instance)
+{
+	Instance.DeinitializeInstance();
+
+	// An instance that cannot be pooled is left for garbage collection
+	(void) ReturnInstance(Instance);
+}
+
+UAIFlowAsset* UAIFlowAssetPoolSubsystem::TryAcquireInstance(const UFlowAsset& TemplateAsset)
+{
+	FAIFlowAssetInstancePool* Pool = InstancePools.Find(const_cast<UFlowAsset*>(&TemplateAsset));
+
+	while (Pool && !Pool->Instances.IsEmpty())
+	{
+		UAIFlowAsset* PooledInstance = Pool->Instances.Pop(EAllowShrinking::No);
+		--Stats.PooledInstances;
+
+		if (IsValid(PooledInstance))
+		{
+			++Stats.Hits;
+
+			return PooledInstance;
+		}
+	}
+
+	++Stats.Misses;
+
+	return nullptr;
+}
+
+bool UAIFlowAssetPoolSubsystem::ReturnInstance(UAIFlowAsset& DeinitializedInstance)
+{
+	UFlowAsset* TemplateAsset = DeinitializedInstance.GetTemplateAsset();
+	if (!IsValid(TemplateAsset) || TemplateAsset == &DeinitializedInstance)
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot pool %s, it is not an instance of a template flow asset."), *DeinitializedInstance.GetName());
+
+		return false;
+	}
+
+	FAIFlowAssetInstancePool* Pool = InstancePools.Find(TemplateAsset);
+	if (!Pool)
+	{
+		// Only pay for the prune when a new pool is added
+		PruneStalePools();
+
+		Pool = &InstancePools.Add(TemplateAsset);
+	}
+
+	if (Pool->Instances.Num() >= MaxPooledInstancesPerTemplate || !DeinitializedInstance.ResetInstanceForReuse())
+	{
+		++Stats.Discarded;
+
+		return false;
+	}
+
+	Pool->Instances.Add(&DeinitializedInstance);
+
+	++Stats.Returned;
+	++Stats.PooledInstances;
+
+	return true;
+}
+
+void UAIFlowAssetPoolSubsystem::PruneStalePools()
+{
+	for (auto It = InstancePools.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			Stats.PooledInstances -= It->Value.Instances.Num();
+
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void UAIFlowAssetPoolSubsystem::EmptyPool(const UFlowAsset& TemplateAsset)
+{
+	FAIFlowAssetInstancePool RemovedPool;
+	if (InstancePools.RemoveAndCopyValue(const_cast<UFlowAsset*>(&TemplateAsset), RemovedPool))
+	{
+		Stats.PooledInstances -= RemovedPool.Instances.Num();
+	}
+}
+
+void UAIFlowAssetPoolSubsystem::EmptyPools()
+{
+	InstancePools.Reset();
+
+	Stats.PooledInstances = 0;
+}
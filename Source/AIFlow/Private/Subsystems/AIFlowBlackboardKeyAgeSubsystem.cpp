@@ -0,0 +1,200 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Subsystems/AIFlowBlackboardKeyAgeSubsystem.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Engine/World.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowBlackboardKeyAgeSubsystem)
+
+namespace AIFlowBlackboardKeyAgeSubsystem_Private
+{
+	// Prune the entries of destroyed components after this many entries have been added
+	constexpr int32 NumEntriesAddedPerPrune = 64;
+
+	constexpr double NeverWrittenTime = -1.0;
+}
+
+void UAIFlowBlackboardKeyAgeSubsystem::Deinitialize()
+{
+	for (const TPair<TObjectKey<UBlackboardComponent>, FComponentKeyWriteTimes>& EntryPair : EntriesByComponent)
+	{
+		UBlackboardComponent* BlackboardComponent = EntryPair.Value.BlackboardComponent.Get();
+		if (EntryPair.Value.ObservedKeys.Contains(true) && IsValid(BlackboardComponent))
+		{
+			BlackboardComponent->UnregisterObserversFrom(this);
+		}
+	}
+
+	EntriesByComponent.Reset();
+
+	Super::Deinitialize();
+}
+
+UAIFlowBlackboardKeyAgeSubsystem::FComponentKeyWriteTimes& UAIFlowBlackboardKeyAgeSubsystem::FindOrAddEntry(const UBlackboardComponent& BlackboardComponent)
+{
+	using namespace AIFlowBlackboardKeyAgeSubsystem_Private;
+
+	if (FComponentKeyWriteTimes* ExistingEntry = EntriesByComponent.Find(&BlackboardComponent))
+	{
+		return *ExistingEntry;
+	}
+
+	if (++NumEntriesAddedSincePrune >= NumEntriesAddedPerPrune)
+	{
+		PruneStaleEntries();
+	}
+
+	FComponentKeyWriteTimes& Entry = EntriesByComponent.Add(&BlackboardComponent);
+	Entry.BlackboardComponent = const_cast<UBlackboardComponent*>(&BlackboardComponent);
+	Entry.WriteTimes.Init(NeverWrittenTime, BlackboardComponent.GetNumKeys());
+	Entry.ObservedKeys.Init(false, BlackboardComponent.GetNumKeys());
+
+	return Entry;
+}
+
+void UAIFlowBlackboardKeyAgeSubsystem::PruneStaleEntries()
+{
+	for (auto It = EntriesByComponent.CreateIterator(); It; ++It)
+	{
+		if (!It->Value.BlackboardComponent.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+
+	NumEntriesAddedSincePrune = 0;
+}
+
+FBlackboard::FKey UAIFlowBlackboardKeyAgeSubsystem::FindKeyID(const UBlackboardComponent& BlackboardComponent, const FName& KeyName)
+{
+	const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+
+	return IsValid(BlackboardData) ? FAIFlowBlackboardKeyTable::Get(*BlackboardData)->FindKeyID(KeyName) : FBlackboard::InvalidKey;
+}
+
+void UAIFlowBlackboardKeyAgeSubsystem::RecordKeyWrite(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID)
+{
+	using namespace AIFlowBlackboardKeyAgeSubsystem_Private;
+
+	const UWorld* World = GetWorld();
+	if (KeyID == FBlackboard::InvalidKey || !IsValid(World))
+	{
+		return;
+	}
+
+	FComponentKeyWriteTimes& Entry = FindOrAddEntry(BlackboardComponent);
+
+	// The component may have been (re)initialized with a larger blackboard since the entry was added
+	if (!Entry.WriteTimes.IsValidIndex(KeyID))
+	{
+		const int32 NumKeys = FMath::Max<int32>(BlackboardComponent.GetNumKeys(), KeyID + 1);
+		Entry.WriteTimes.Reserve(NumKeys);
+
+		while (Entry.WriteTimes.Num() < NumKeys)
+		{
+			Entry.WriteTimes.Add(NeverWrittenTime);
+		}
+	}
+
+	Entry.WriteTimes[KeyID] = World->GetTimeSeconds();
+}
+
+void UAIFlowBlackboardKeyAgeSubsystem::RecordKeyWrite(const UBlackboardComponent& BlackboardComponent, const FName& KeyName)
+{
+	RecordKeyWrite(BlackboardComponent, FindKeyID(BlackboardComponent, KeyName));
+}
+
+void UAIFlowBlackboardKeyAgeSubsystem::WriteAndRecordKey(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, TFunctionRef<void()> WriteKey)
+{
+	{
+		// (Restored afterwards, in case the write's notifications lead to other AIFlow writes)
+		TGuardValue<TObjectKey<UBlackboardComponent>> DirectWriteComponentGuard(DirectWriteComponent, &BlackboardComponent);
+		TGuardValue<FBlackboard::FKey> DirectWriteKeyIDGuard(DirectWriteKeyID, KeyID);
+
+		WriteKey();
+	}
+
+	RecordKeyWrite(BlackboardComponent, KeyID);
+}
+
+void UAIFlowBlackboardKeyAgeSubsystem::StartObservingKey(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID)
+{
+	if (KeyID == FBlackboard::InvalidKey)
+	{
+		return;
+	}
+
+	FComponentKeyWriteTimes& Entry = FindOrAddEntry(BlackboardComponent);
+	if (Entry.ObservedKeys.IsValidIndex(KeyID) && Entry.ObservedKeys[KeyID])
+	{
+		return;
+	}
+
+	if (!Entry.ObservedKeys.IsValidIndex(KeyID))
+	{
+		Entry.ObservedKeys.Add(false, KeyID + 1 - Entry.ObservedKeys.Num());
+	}
+
+	BlackboardComponent.RegisterObserver(
+		KeyID,
+		this,
+		FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnObservedKeyChanged));
+
+	Entry.ObservedKeys[KeyID] = true;
+}
+
+void UAIFlowBlackboardKeyAgeSubsystem::StartObservingEngineWrites(UBlackboardComponent& BlackboardComponent)
+{
+	const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+	if (!IsValid(BlackboardData))
+	{
+		return;
+	}
+
+	// Observe every key (including the Parent blackboards' keys)
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(*BlackboardData);
+	for (const FAIFlowBlackboardKeyTableEntry& KeyEntry : KeyTable->GetEntries())
+	{
+		StartObservingKey(BlackboardComponent, KeyEntry.KeyID);
+	}
+}
+
+EBlackboardNotificationResult UAIFlowBlackboardKeyAgeSubsystem::OnObservedKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID)
+{
+	// Writes made by WriteAndRecordKey are recorded there
+	if (KeyID != DirectWriteKeyID || DirectWriteComponent != TObjectKey<UBlackboardComponent>(&BlackboardComponent))
+	{
+		RecordKeyWrite(BlackboardComponent, KeyID);
+	}
+
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
+bool UAIFlowBlackboardKeyAgeSubsystem::TryGetKeyAge(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, float& OutAgeSeconds)
+{
+	const UWorld* World = GetWorld();
+	if (KeyID == FBlackboard::InvalidKey || !IsValid(World))
+	{
+		return false;
+	}
+
+	// Only the keys whose ages are asked for are observed
+	StartObservingKey(BlackboardComponent, KeyID);
+
+	const FComponentKeyWriteTimes* Entry = EntriesByComponent.Find(&BlackboardComponent);
+	if (!Entry || !Entry->WriteTimes.IsValidIndex(KeyID) || Entry->WriteTimes[KeyID] < 0.0)
+	{
+		return false;
+	}
+
+	// The age is small, so it is returned as a float, but it is computed from the double world times
+	OutAgeSeconds = static_cast<float>(FMath::Max(0.0, World->GetTimeSeconds() - Entry->WriteTimes[KeyID]));
+
+	return true;
+}
+
+bool UAIFlowBlackboardKeyAgeSubsystem::TryGetKeyAge(UBlackboardComponent& BlackboardComponent, const FName& KeyName, float& OutAgeSeconds)
+{
+	return TryGetKeyAge(BlackboardComponent, FindKeyID(BlackboardComponent, KeyName), OutAgeSeconds);
+}
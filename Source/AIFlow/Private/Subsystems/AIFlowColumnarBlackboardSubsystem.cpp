@@ -0,0 +1,563 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Subsystems/AIFlowColumnarBlackboardSubsystem.h"
+#include "AIFlowLogChannels.h"
+#include "AIFlowStats.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
+#include "Blackboard/AIFlowColumnarBlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Bool.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Float.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Int.h"
+#include "Math/VectorRegister.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowColumnarBlackboardSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Columnar Blackboard Bulk Operation"), STAT_AIFlow_ColumnarBulkOperation, STATGROUP_AIFlow);
+DECLARE_CYCLE_STAT(TEXT("Columnar Blackboard Write Back"), STAT_AIFlow_ColumnarWriteBack, STATGROUP_AIFlow);
+
+const FAIFlowBlackboardColumn* FAIFlowColumnarBlackboardStore::FindColumn(const FName& KeyName) const
+{
+	for (const FAIFlowBlackboardColumn& Column : Columns)
+	{
+		if (Column.KeyName == KeyName)
+		{
+			return &Column;
+		}
+	}
+
+	return nullptr;
+}
+
+void UAIFlowColumnarBlackboardSubsystem::Deinitialize()
+{
+	for (const TPair<TObjectKey<UBlackboardData>, TUniquePtr<FAIFlowColumnarBlackboardStore>>& StorePair : Stores)
+	{
+		for (const TObjectKey<UBlackboardComponent>& RowComponent : StorePair.Value->Rows)
+		{
+			if (UBlackboardComponent* BlackboardComponent = RowComponent.ResolveObjectPtr())
+			{
+				BlackboardComponent->UnregisterObserversFrom(this);
+			}
+		}
+	}
+
+	Stores.Reset();
+	PendingUnregistrations.Reset();
+
+	Super::Deinitialize();
+}
+
+FAIFlowColumnarBlackboardStore& UAIFlowColumnarBlackboardSubsystem::FindOrAddStore(const UBlackboardData& BlackboardData)
+{
+	TUniquePtr<FAIFlowColumnarBlackboardStore>& Store = Stores.FindOrAdd(&BlackboardData);
+	if (Store.IsValid())
+	{
+		return *Store;
+	}
+
+	Store = MakeUnique<FAIFlowColumnarBlackboardStore>();
+
+	// One column for each of the Float, Int and Bool keys (including the Parent blackboards' keys)
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(BlackboardData);
+	for (const FAIFlowBlackboardKeyTableEntry& Entry : KeyTable->GetEntries())
+	{
+		if (!Entry.KeyType || Store->ColumnIndexByKeyID.Contains(Entry.KeyID))
+		{
+			continue;
+		}
+
+		EAIFlowBlackboardColumnType ColumnType;
+		if (Entry.KeyType->IsA<UBlackboardKeyType_Float>())
+		{
+			ColumnType = EAIFlowBlackboardColumnType::Float;
+		}
+		else if (Entry.KeyType->IsA<UBlackboardKeyType_Int>())
+		{
+			ColumnType = EAIFlowBlackboardColumnType::Int;
+		}
+		else if (Entry.KeyType->IsA<UBlackboardKeyType_Bool>())
+		{
+			ColumnType = EAIFlowBlackboardColumnType::Bool;
+		}
+		else
+		{
+			continue;
+		}
+
+		Store->ColumnIndexByKeyID.Add(Entry.KeyID, Store->Columns.Num());
+
+		FAIFlowBlackboardColumn& Column = Store->Columns.AddDefaulted_GetRef();
+		Column.KeyName = Entry.KeyName;
+		Column.KeyID = Entry.KeyID;
+		Column.Type = ColumnType;
+	}
+
+	return *Store;
+}
+
+const FAIFlowColumnarBlackboardStore* UAIFlowColumnarBlackboardSubsystem::FindStore(const UBlackboardData& BlackboardData) const
+{
+	const TUniquePtr<FAIFlowColumnarBlackboardStore>* Store = Stores.Find(&BlackboardData);
+	return Store ? Store->Get() : nullptr;
+}
+
+FAIFlowColumnarBlackboardStore* UAIFlowColumnarBlackboardSubsystem::FindStore(const UBlackboardData& BlackboardData)
+{
+	TUniquePtr<FAIFlowColumnarBlackboardStore>* Store = Stores.Find(&BlackboardData);
+	return Store ? Store->Get() : nullptr;
+}
+
+void UAIFlowColumnarBlackboardSubsystem::RegisterComponent(UBlackboardComponent& BlackboardComponent)
+{
+	const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+	if (!IsValid(BlackboardData))
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot register %s with the columnar blackboard store before its blackboard is initialized."), *BlackboardComponent.GetName());
+
+		return;
+	}
+
+	// Re-registering during a write-back replaces the deferred unregistration (which may be for the previous blackboard asset)
+	if (PendingUnregistrations.Remove(&BlackboardComponent) > 0)
+	{
+		RemoveComponentRow(&BlackboardComponent);
+	}
+
+	FAIFlowColumnarBlackboardStore& Store = FindOrAddStore(*BlackboardData);
+	if (Store.RowByComponent.Contains(&BlackboardComponent))
+	{
+		return;
+	}
+
+	const int32 Row = Store.Rows.Add(&BlackboardComponent);
+	Store.RowByComponent.Add(&BlackboardComponent, Row);
+
+	for (FAIFlowBlackboardColumn& Column : Store.Columns)
+	{
+		if (Column.Type == EAIFlowBlackboardColumnType::Float)
+		{
+			Column.Floats.AddZeroed();
+		}
+		else
+		{
+			Column.Ints.AddZeroed();
+		}
+
+		BlackboardComponent.RegisterObserver(
+			Column.KeyID,
+			this,
+			FOnBlackboardChangeNotification::CreateUObject(this, &ThisClass::OnColumnKeyChanged));
+	}
+
+	ReadRowFromComponent(Store, Row, BlackboardComponent);
+}
+
+void UAIFlowColumnarBlackboardSubsystem::UnregisterComponent(UBlackboardComponent& BlackboardComponent)
+{
+	if (bWritingBackRows)
+	{
+		// Keep the rows (and stores) stable until the write-back has finished
+		PendingUnregistrations.AddUnique(&BlackboardComponent);
+
+		return;
+	}
+
+	BlackboardComponent.UnregisterObserversFrom(this);
+
+	RemoveComponentRow(&BlackboardComponent);
+}
+
+void UAIFlowColumnarBlackboardSubsystem::SyncComponentRegistration(UBlackboardComponent& BlackboardComponent)
+{
+	if (UAIFlowColumnarBlackboardComponent* ColumnarBlackboardComponent = Cast<UAIFlowColumnarBlackboardComponent>(&BlackboardComponent))
+	{
+		ColumnarBlackboardComponent->SyncColumnarStoreRegistration();
+	}
+}
+
+void UAIFlowColumnarBlackboardSubsystem::RemoveComponentRow(const TObjectKey<UBlackboardComponent>& ComponentKey)
+{
+	// The component may have been re-initialized with a different blackboard, so check every store
+	for (auto It = Stores.CreateIterator(); It; ++It)
+	{
+		FAIFlowColumnarBlackboardStore& Store = *It.Value();
+
+		if (const int32* Row = Store.RowByComponent.Find(ComponentKey))
+		{
+			RemoveRow(Store, *Row);
+
+			if (Store.Rows.IsEmpty())
+			{
+				It.RemoveCurrent();
+			}
+
+			return;
+		}
+	}
+}
+
+void UAIFlowColumnarBlackboardSubsystem::FlushPendingUnregistrations()
+{
+	check(!bWritingBackRows);
+
+	TArray<TObjectKey<UBlackboardComponent>> ComponentsToUnregister = MoveTemp(PendingUnregistrations);
+	PendingUnregistrations.Reset();
+
+	for (const TObjectKey<UBlackboardComponent>& ComponentKey : ComponentsToUnregister)
+	{
+		if (UBlackboardComponent* BlackboardComponent = ComponentKey.ResolveObjectPtr())
+		{
+			BlackboardComponent->UnregisterObserversFrom(this);
+		}
+
+		RemoveComponentRow(ComponentKey);
+	}
+}
+
+void UAIFlowColumnarBlackboardSubsystem::ReadRowFromComponent(FAIFlowColumnarBlackboardStore& Store, int32 Row, const UBlackboardComponent& BlackboardComponent) const
+{
+	for (FAIFlowBlackboardColumn& Column : Store.Columns)
+	{
+		switch (Column.Type)
+		{
+		case EAIFlowBlackboardColumnType::Float:
+			Column.Floats[Row] = BlackboardComponent.GetValue<UBlackboardKeyType_Float>(Column.KeyID);
+			break;
+
+		case EAIFlowBlackboardColumnType::Int:
+			Column.Ints[Row] = BlackboardComponent.GetValue<UBlackboardKeyType_Int>(Column.KeyID);
+			break;
+
+		case EAIFlowBlackboardColumnType::Bool:
+			Column.Ints[Row] = BlackboardComponent.GetValue<UBlackboardKeyType_Bool>(Column.KeyID) ? 1 : 0;
+			break;
+		}
+	}
+}
+
+void UAIFlowColumnarBlackboardSubsystem::RemoveRow(FAIFlowColumnarBlackboardStore& Store, int32 Row)
+{
+	const int32 LastRow = Store.Rows.Num() - 1;
+
+	Store.RowByComponent.Remove(Store.Rows[Row]);
+
+	if (Row != LastRow)
+	{
+		// Keep the rows dense, by moving the last row into the removed row
+		Store.RowByComponent.Add(Store.Rows[LastRow], Row);
+	}
+
+	Store.Rows.RemoveAtSwap(Row, EAllowShrinking::No);
+
+	for (FAIFlowBlackboardColumn& Column : Store.Columns)
+	{
+		if (Column.Type == EAIFlowBlackboardColumnType::Float)
+		{
+			Column.Floats.RemoveAtSwap(Row, EAllowShrinking::No);
+		}
+		else
+		{
+			Column.Ints.RemoveAtSwap(Row, EAllowShrinking::No);
+		}
+	}
+}
+
+EBlackboardNotificationResult UAIFlowColumnarBlackboardSubsystem::OnColumnKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID)
+{
+	// Skip the notification for the value being written back (it is already in the column), but only once,
+	// so that an observer re-setting the same key is still mirrored
+	if (KeyID == WritingBackKeyID && WritingBackComponent == TObjectKey<UBlackboardComponent>(&BlackboardComponent))
+	{
+		WritingBackKeyID = FBlackboard::InvalidKey;
+
+		return EBlackboardNotificationResult::ContinueObserving;
+	}
+
+	const UBlackboardData* BlackboardData = BlackboardComponent.GetBlackboardAsset();
+	const TUniquePtr<FAIFlowColumnarBlackboardStore>* StorePtr = IsValid(BlackboardData) ? Stores.Find(BlackboardData) : nullptr;
+	if (!StorePtr)
+	{
+		return EBlackboardNotificationResult::RemoveObserver;
+	}
+
+	FAIFlowColumnarBlackboardStore& Store = **StorePtr;
+
+	const int32* Row = Store.RowByComponent.Find(&BlackboardComponent);
+	const int32* ColumnIndex = Store.ColumnIndexByKeyID.Find(KeyID);
+	if (!Row || !ColumnIndex)
+	{
+		return EBlackboardNotificationResult::RemoveObserver;
+	}
+
+	FAIFlowBlackboardColumn& Column = Store.Columns[*ColumnIndex];
+	switch (Column.Type)
+	{
+	case EAIFlowBlackboardColumnType::Float:
+		Column.Floats[*Row] = BlackboardComponent.GetValue<UBlackboardKeyType_Float>(KeyID);
+		break;
+
+	case EAIFlowBlackboardColumnType::Int:
+		Column.Ints[*Row] = BlackboardComponent.GetValue<UBlackboardKeyType_Int>(KeyID);
+		break;
+
+	case EAIFlowBlackboardColumnType::Bool:
+		Column.Ints[*Row] = BlackboardComponent.GetValue<UBlackboardKeyType_Bool>(KeyID) ? 1 : 0;
+		break;
+	}
+
+	return EBlackboardNotificationResult::ContinueObserving;
+}
+
+int32 UAIFlowColumnarBlackboardSubsystem::WriteBackRows(const FAIFlowColumnarBlackboardStore& Store, const FAIFlowBlackboardColumn& Column, TConstArrayView<int32> ChangedRows)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_ColumnarWriteBack);
+
+	struct FRowWrite
+	{
+		TWeakObjectPtr<UBlackboardComponent> BlackboardComponent;
+		float FloatValue = 0.0f;
+		int32 IntValue = 0;
+	};
+
+	// Snapshot the writes, since the observers notified by SetValue can change the Store (and Column) while we write
+	const FBlackboard::FKey KeyID = Column.KeyID;
+	const EAIFlowBlackboardColumnType ColumnType = Column.Type;
+
+	TArray<FRowWrite> RowWrites;
+	RowWrites.Reserve(ChangedRows.Num());
+
+	for (const int32 Row : ChangedRows)
+	{
+		FRowWrite& RowWrite = RowWrites.AddDefaulted_GetRef();
+		RowWrite.BlackboardComponent = Store.Rows[Row].ResolveObjectPtr();
+
+		if (ColumnType == EAIFlowBlackboardColumnType::Float)
+		{
+			RowWrite.FloatValue = Column.Floats[Row];
+		}
+		else
+		{
+			RowWrite.IntValue = Column.Ints[Row];
+		}
+	}
+
+	int32 NumWritten = 0;
+
+	{
+		TGuardValue<bool> WritingBackGuard(bWritingBackRows, true);
+
+		for (const FRowWrite& RowWrite : RowWrites)
+		{
+			UBlackboardComponent* BlackboardComponent = RowWrite.BlackboardComponent.Get();
+			if (!IsValid(BlackboardComponent))
+			{
+				continue;
+			}
+
+			TGuardValue<TObjectKey<UBlackboardComponent>> WritingBackComponentGuard(WritingBackComponent, BlackboardComponent);
+			TGuardValue<FBlackboard::FKey> WritingBackKeyIDGuard(WritingBackKeyID, KeyID);
+
+			switch (ColumnType)
+			{
+			case EAIFlowBlackboardColumnType::Float:
+				BlackboardComponent->SetValue<UBlackboardKeyType_Float>(KeyID, RowWrite.FloatValue);
+				break;
+
+			case EAIFlowBlackboardColumnType::Int:
+				BlackboardComponent->SetValue<UBlackboardKeyType_Int>(KeyID, RowWrite.IntValue);
+				break;
+
+			case EAIFlowBlackboardColumnType::Bool:
+				BlackboardComponent->SetValue<UBlackboardKeyType_Bool>(KeyID, RowWrite.IntValue != 0);
+				break;
+			}
+
+			++NumWritten;
+		}
+	}
+
+	// Only the outermost write-back (of any nested in observers) unregisters the deferred components
+	if (!bWritingBackRows)
+	{
+		FlushPendingUnregistrations();
+	}
+
+	return NumWritten;
+}
+
+namespace AIFlowColumnarBlackboardSubsystem_Private
+{
+	FAIFlowBlackboardColumn* FindTypedColumn(FAIFlowColumnarBlackboardStore* Store, const FName& KeyName, EAIFlowBlackboardColumnType ColumnType)
+	{
+		FAIFlowBlackboardColumn* Column = Store ? Store->FindColumn(KeyName) : nullptr;
+		if (Column && Column->Type != ColumnType)
+		{
+			UE_LOG(LogAIFlow, Error, TEXT("Blackboard key %s is not the column type required by the columnar bulk operation."), *KeyName.ToString());
+
+			return nullptr;
+		}
+
+		return Column;
+	}
+}
+
+int32 UAIFlowColumnarBlackboardSubsystem::BulkMultiplyAddFloat(const UBlackboardData& BlackboardData, const FName& KeyName, float Scale, float Offset, float ClampMin, float ClampMax)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_ColumnarBulkOperation);
+
+	FAIFlowColumnarBlackboardStore* Store = FindStore(BlackboardData);
+	FAIFlowBlackboardColumn* Column = AIFlowColumnarBlackboardSubsystem_Private::FindTypedColumn(Store, KeyName, EAIFlowBlackboardColumnType::Float);
+	if (!Column)
+	{
+		return 0;
+	}
+
+	float* Values = Column->Floats.GetData();
+	const int32 NumRows = Column->Floats.Num();
+
+	TArray<int32> ChangedRows;
+
+	const VectorRegister4Float ScaleVector = VectorSetFloat1(Scale);
+	const VectorRegister4Float OffsetVector = VectorSetFloat1(Offset);
+	const VectorRegister4Float MinVector = VectorSetFloat1(ClampMin);
+	const VectorRegister4Float MaxVector = VectorSetFloat1(ClampMax);
+
+	int32 Row = 0;
+	for (; Row + 4 <= NumRows; Row += 4)
+	{
+		const VectorRegister4Float OldValues = VectorLoad(Values + Row);
+		const VectorRegister4Float NewValues = VectorMin(VectorMax(VectorMultiplyAdd(OldValues, ScaleVector, OffsetVector), MinVector), MaxVector);
+
+		VectorStore(NewValues, Values + Row);
+
+		// Only the changed lanes need writing back to their components
+		const uint32 ChangedMask = static_cast<uint32>(VectorMaskBits(VectorCompareNE(OldValues, NewValues)));
+		for (uint32 Lane = 0; Lane < 4; ++Lane)
+		{
+			if (ChangedMask & (1u << Lane))
+			{
+				ChangedRows.Add(Row + Lane);
+			}
+		}
+	}
+
+	for (; Row < NumRows; ++Row)
+	{
+		const float NewValue = FMath::Clamp(Values[Row] * Scale + Offset, ClampMin, ClampMax);
+		if (NewValue != Values[Row])
+		{
+			Values[Row] = NewValue;
+			ChangedRows.Add(Row);
+		}
+	}
+
+	return WriteBackRows(*Store, *Column, ChangedRows);
+}
+
+int32 UAIFlowColumnarBlackboardSubsystem::BulkSetFloat(const UBlackboardData& BlackboardData, const FName& KeyName, float Value)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_ColumnarBulkOperation);
+
+	FAIFlowColumnarBlackboardStore* Store = FindStore(BlackboardData);
+	FAIFlowBlackboardColumn* Column = AIFlowColumnarBlackboardSubsystem_Private::FindTypedColumn(Store, KeyName, EAIFlowBlackboardColumnType::Float);
+	if (!Column)
+	{
+		return 0;
+	}
+
+	TArray<int32> ChangedRows;
+
+	for (int32 Row = 0; Row < Column->Floats.Num(); ++Row)
+	{
+		if (Column->Floats[Row] != Value)
+		{
+			Column->Floats[Row] = Value;
+			ChangedRows.Add(Row);
+		}
+	}
+
+	return WriteBackRows(*Store, *Column, ChangedRows);
+}
+
+int32 UAIFlowColumnarBlackboardSubsystem::BulkAddInt(const UBlackboardData& BlackboardData, const FName& KeyName, int32 Delta, int32 ClampMin, int32 ClampMax)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_ColumnarBulkOperation);
+
+	FAIFlowColumnarBlackboardStore* Store = FindStore(BlackboardData);
+	FAIFlowBlackboardColumn* Column = AIFlowColumnarBlackboardSubsystem_Private::FindTypedColumn(Store, KeyName, EAIFlowBlackboardColumnType::Int);
+	if (!Column)
+	{
+		return 0;
+	}
+
+	TArray<int32> ChangedRows;
+
+	for (int32 Row = 0; Row < Column->Ints.Num(); ++Row)
+	{
+		// Widen to avoid overflowing before the clamp
+		const int32 NewValue = static_cast<int32>(FMath::Clamp<int64>(static_cast<int64>(Column->Ints[Row]) + Delta, ClampMin, ClampMax));
+		if (Column->Ints[Row] != NewValue)
+		{
+			Column->Ints[Row] = NewValue;
+			ChangedRows.Add(Row);
+		}
+	}
+
+	return WriteBackRows(*Store, *Column, ChangedRows);
+}
+
+int32 UAIFlowColumnarBlackboardSubsystem::BulkSetBool(const UBlackboardData& BlackboardData, const FName& KeyName, bool bValue)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_ColumnarBulkOperation);
+
+	FAIFlowColumnarBlackboardStore* Store = FindStore(BlackboardData);
+	FAIFlowBlackboardColumn* Column = AIFlowColumnarBlackboardSubsystem_Private::FindTypedColumn(Store, KeyName, EAIFlowBlackboardColumnType::Bool);
+	if (!Column)
+	{
+		return 0;
+	}
+
+	const int32 Value = bValue ? 1 : 0;
+
+	TArray<int32> ChangedRows;
+
+	for (int32 Row = 0; Row < Column->Ints.Num(); ++Row)
+	{
+		if (Column->Ints[Row] != Value)
+		{
+			Column->Ints[Row] = Value;
+			ChangedRows.Add(Row);
+		}
+	}
+
+	return WriteBackRows(*Store, *Column, ChangedRows);
+}
+
+int32 UAIFlowColumnarBlackboardSubsystem::GatherComponentsWithFloatInRange(const UBlackboardData& BlackboardData, const FName& KeyName, float RangeMin, float RangeMax, TArray<UBlackboardComponent*>& OutComponents) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_ColumnarBulkOperation);
+
+	const FAIFlowColumnarBlackboardStore* Store = FindStore(BlackboardData);
+	const FAIFlowBlackboardColumn* Column = Store ? Store->FindColumn(KeyName) : nullptr;
+	if (!Column || Column->Type != EAIFlowBlackboardColumnType::Float)
+	{
+		return 0;
+	}
+
+	const int32 NumBefore = OutComponents.Num();
+
+	for (int32 Row = 0; Row < Column->Floats.Num(); ++Row)
+	{
+		const float Value = Column->Floats[Row];
+		if (Value >= RangeMin && Value <= RangeMax)
+		{
+			if (UBlackboardComponent* BlackboardComponent = Store->Rows[Row].ResolveObjectPtr())
+			{
+				OutComponents.Add(BlackboardComponent);
+			}
+		}
+	}
+
+	return OutComponents.Num() - NumBefore;
+}
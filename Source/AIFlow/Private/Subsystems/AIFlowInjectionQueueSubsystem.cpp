@@ -0,0 +1,264 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Subsystems/AIFlowInjectionQueueSubsystem.h"
+#include "AddOns/FlowNodeAddOn_InjectComponents.h"
+#include "AIFlowStats.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/PlatformTime.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowInjectionQueueSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Injection Queue Tick"), STAT_AIFlow_InjectionQueueTick, STATGROUP_AIFlow);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Injection Queue Depth"), STAT_AIFlow_InjectionQueueDepth, STATGROUP_AIFlow);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Injections Serviced"), STAT_AIFlow_InjectionsServiced, STATGROUP_AIFlow);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Injection Max Latency (ms)"), STAT_AIFlow_InjectionMaxLatencyMs, STATGROUP_AIFlow);
+
+namespace AIFlowInjectionQueueSubsystem_Private
+{
+	// The stats are shared by every world's queue, so the max latency is gathered across the worlds for each frame
+	uint64 MaxLatencyFrame = MAX_uint64;
+	float MaxLatencyMsThisFrame = 0.0f;
+}
+
+void UAIFlowInjectionQueueSubsystem::Deinitialize()
+{
+	// The world is going away, so there is no point servicing the outstanding requests
+	QueuedInjections.Reset();
+	PendingCountByActor.Reset();
+	NumCancelledInjections = 0;
+
+	Stats.QueueDepth = 0;
+	Stats.LastTickMaxLatencySeconds = 0.0f;
+	PublishStats();
+
+	Super::Deinitialize();
+}
+
+bool UAIFlowInjectionQueueSubsystem::IsTickable() const
+{
+	return !QueuedInjections.IsEmpty();
+}
+
+TStatId UAIFlowInjectionQueueSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAIFlowInjectionQueueSubsystem, STATGROUP_Tickables);
+}
+
+void UAIFlowInjectionQueueSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_InjectionQueueTick);
+
+	Super::Tick(DeltaTime);
+
+	// (a FlushQueue since the last tick is reported with this tick's latency, rather than being hidden)
+	Stats.LastTickMaxLatencySeconds = 0.0f;
+
+	ServiceQueue(true);
+}
+
+void UAIFlowInjectionQueueSubsystem::FlushQueue()
+{
+	ServiceQueue(false);
+}
+
+void UAIFlowInjectionQueueSubsystem::EnqueueInjection(AActor& Actor, UFlowNodeAddOn_InjectComponents& Requester, UFlowNodeBase* SpawningFlowNodeBase)
+{
+	FQueuedInjection Request;
+	Request.Actor = &Actor;
+	Request.ActorKey = &Actor;
+	Request.Requester = &Requester;
+	Request.SpawningFlowNodeBase = SpawningFlowNodeBase;
+	Request.EnqueueTimeSeconds = FPlatformTime::Seconds();
+	Request.PrioritySortKey = ComputePrioritySortKey(Actor);
+	Request.Sequence = NextSequence++;
+
+	QueuedInjections.HeapPush(MoveTemp(Request), FQueuedInjectionPriorityPredicate());
+
+	++PendingCountByActor.FindOrAdd(&Actor);
+
+	Stats.QueueDepth = QueuedInjections.Num() - NumCancelledInjections;
+	Stats.PeakQueueDepth = FMath::Max(Stats.PeakQueueDepth, Stats.QueueDepth);
+}
+
+void UAIFlowInjectionQueueSubsystem::CancelRequestsFrom(const UFlowNodeAddOn_InjectComponents& Requester)
+{
+	// Requests are only flagged here (and discarded when they reach the top of the heap),
+	// because this can be called re-entrantly while the queue is being serviced
+	for (FQueuedInjection& Request : QueuedInjections)
+	{
+		if (!Request.bCancelled && Request.Requester.Get() == &Requester)
+		{
+			Request.bCancelled = true;
+			++NumCancelledInjections;
+
+			RemovePendingActor(Request.ActorKey);
+		}
+	}
+
+	Stats.QueueDepth = QueuedInjections.Num() - NumCancelledInjections;
+}
+
+bool UAIFlowInjectionQueueSubsystem::IsActorPendingInjection(const AActor* Actor) const
+{
+	return IsValid(Actor) && PendingCountByActor.Contains(Actor);
+}
+
+void UAIFlowInjectionQueueSubsystem::ServiceQueue(bool bRespectFrameBudget)
+{
+	const double StartSeconds = FPlatformTime::Seconds();
+	const double BudgetSeconds = FrameBudgetMilliseconds * 0.001;
+
+	// NOTE - servicing a request may queue additional requests (pushed onto the heap),
+	// so the request is popped (copied) before it is serviced.
+	// Cancelled and stale requests are discarded without counting against the budget.
+	int32 NumServiced = 0;
+	while (!QueuedInjections.IsEmpty())
+	{
+		const double NowSeconds = FPlatformTime::Seconds();
+		if (bRespectFrameBudget && NumServiced >= MinRequestsPerFrame && NowSeconds - StartSeconds >= BudgetSeconds)
+		{
+			break;
+		}
+
+		FQueuedInjection Request;
+		QueuedInjections.HeapPop(Request, FQueuedInjectionPriorityPredicate(), EAllowShrinking::No);
+
+		if (ServiceRequest(Request, NowSeconds))
+		{
+			++NumServiced;
+		}
+	}
+
+	INC_DWORD_STAT_BY(STAT_AIFlow_InjectionsServiced, NumServiced);
+
+	PublishStats();
+}
+
+double UAIFlowInjectionQueueSubsystem::ComputePrioritySortKey(const AActor& Actor)
+{
+	if (PriorityOrder != EAIFlowInjectionQueuePriority::NearestToPlayerFirst)
+	{
+		// Equal keys, so the requests are serviced in Sequence (first-in, first-out) order
+		return 0.0;
+	}
+
+	const TArray<FVector, TInlineAllocator<4>>& ViewLocations = GetLocalPlayerViewLocations();
+	if (ViewLocations.IsEmpty())
+	{
+		// Without a viewpoint, remain in first-in, first-out order
+		return 0.0;
+	}
+
+	const FVector ActorLocation = Actor.GetActorLocation();
+
+	double ClosestDistSquared = TNumericLimits<double>::Max();
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		ClosestDistSquared = FMath::Min(ClosestDistSquared, FVector::DistSquared(ActorLocation, ViewLocation));
+	}
+
+	return ClosestDistSquared;
+}
+
+const TArray<FVector, TInlineAllocator<4>>& UAIFlowInjectionQueueSubsystem::GetLocalPlayerViewLocations()
+{
+	if (CachedViewLocationsFrame == GFrameCounter)
+	{
+		return CachedViewLocations;
+	}
+
+	CachedViewLocationsFrame = GFrameCounter;
+	CachedViewLocations.Reset();
+
+	const UWorld* World = GetWorld();
+	if (!IsValid(World))
+	{
+		return CachedViewLocations;
+	}
+
+	for (FConstPlayerControllerIterator Iterator = World->GetPlayerControllerIterator(); Iterator; ++Iterator)
+	{
+		const APlayerController* PlayerController = Iterator->Get();
+		if (IsValid(PlayerController) && PlayerController->IsLocalController())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+
+			CachedViewLocations.Add(ViewLocation);
+		}
+	}
+
+	return CachedViewLocations;
+}
+
+bool UAIFlowInjectionQueueSubsystem::ServiceRequest(const FQueuedInjection& Request, double NowSeconds)
+{
+	if (Request.bCancelled)
+	{
+		--NumCancelledInjections;
+
+		return false;
+	}
+
+	RemovePendingActor(Request.ActorKey);
+
+	AActor* Actor = Request.Actor.Get();
+	UFlowNodeAddOn_InjectComponents* Requester = Request.Requester.Get();
+	if (!IsValid(Actor) || !IsValid(Requester))
+	{
+		return false;
+	}
+
+	const float LatencySeconds = static_cast<float>(NowSeconds - Request.EnqueueTimeSeconds);
+	Stats.LastTickMaxLatencySeconds = FMath::Max(Stats.LastTickMaxLatencySeconds, LatencySeconds);
+	Stats.PeakLatencySeconds = FMath::Max(Stats.PeakLatencySeconds, LatencySeconds);
+	++Stats.TotalCompleted;
+
+	// Injects the components, then notifies of the spawned actor (in the same order as an immediate injection)
+	Requester->FinishQueuedInjection(*Actor, Request.SpawningFlowNodeBase.Get());
+
+	OnInjectionCompleted.Broadcast(Actor, Requester);
+
+	return true;
+}
+
+void UAIFlowInjectionQueueSubsystem::RemovePendingActor(const TObjectKey<AActor>& ActorKey)
+{
+	int32* PendingCount = PendingCountByActor.Find(ActorKey);
+	if (PendingCount && --(*PendingCount) <= 0)
+	{
+		PendingCountByActor.Remove(ActorKey);
+	}
+}
+
+void UAIFlowInjectionQueueSubsystem::PublishStats()
+{
+	using namespace AIFlowInjectionQueueSubsystem_Private;
+
+	Stats.QueueDepth = QueuedInjections.Num() - NumCancelledInjections;
+
+	// The depth stat is the sum of every world's queue, so only this queue's change is applied to it
+	const int32 DepthDelta = Stats.QueueDepth - PublishedQueueDepth;
+	if (DepthDelta > 0)
+	{
+		INC_DWORD_STAT_BY(STAT_AIFlow_InjectionQueueDepth, DepthDelta);
+	}
+	else if (DepthDelta < 0)
+	{
+		DEC_DWORD_STAT_BY(STAT_AIFlow_InjectionQueueDepth, -DepthDelta);
+	}
+
+	PublishedQueueDepth = Stats.QueueDepth;
+
+	if (MaxLatencyFrame != GFrameCounter)
+	{
+		MaxLatencyFrame = GFrameCounter;
+		MaxLatencyMsThisFrame = 0.0f;
+	}
+
+	MaxLatencyMsThisFrame = FMath::Max(MaxLatencyMsThisFrame, Stats.LastTickMaxLatencySeconds * 1000.0f);
+
+	SET_FLOAT_STAT(STAT_AIFlow_InjectionMaxLatencyMs, MaxLatencyMsThisFrame);
+}
@@ -0,0 +1,464 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#include "Subsystems/AIFlowPredicateBatchSubsystem.h"
+#include "AddOns/FlowNodeAddOn_PredicateBlackboardDistance.h"
+#include "AddOns/FlowNodeAddOn_PredicateCompareBlackboardValue.h"
+#include "AIFlowActorBlackboardHelper.h"
+#include "AIFlowPredicateEvaluationContext.h"
+#include "AIFlowLogChannels.h"
+#include "AIFlowStats.h"
+#include "Interfaces/FlowPredicateInterface.h"
+#include "Nodes/FlowNode.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "Math/VectorRegister.h"
+
+#include UE_INLINE_GENERATED_CPP_BY_NAME(AIFlowPredicateBatchSubsystem)
+
+DECLARE_CYCLE_STAT(TEXT("Predicate Batch Flush"), STAT_AIFlow_PredicateBatchFlush, STATGROUP_AIFlow);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Batched Predicate Evaluations"), STAT_AIFlow_BatchedPredicateEvaluations, STATGROUP_AIFlow);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Individual Predicate Evaluations"), STAT_AIFlow_IndividualPredicateEvaluations, STATGROUP_AIFlow);
+
+namespace AIFlowPredicateBatchSubsystem_Private
+{
+	template <typename TValue>
+	FORCEINLINE TValue ReadValue(const uint8* Memory)
+	{
+		TValue Value;
+		FMemory::Memcpy(&Value, Memory, sizeof(TValue));
+		return Value;
+	}
+
+	FORCEINLINE void ScatterMaskBits(uint32 MaskBits, bool* OutResults)
+	{
+		for (uint32 Lane = 0; Lane < 4; ++Lane)
+		{
+			OutResults[Lane] = (MaskBits & (1u << Lane)) != 0;
+		}
+	}
+
+	// Tolerance for Float equality, as UBlackboardKeyType_Float::CompareValues (used by the unbatched compare predicate)
+	constexpr float FloatEqualityTolerance = UE_KINDA_SMALL_NUMBER;
+
+	FORCEINLINE bool AreFloatsEqual(float LeftValue, float RightValue)
+	{
+		return FMath::Abs(LeftValue - RightValue) < FloatEqualityTolerance;
+	}
+
+	template <typename TValue>
+	bool CompareScalar(TValue LeftValue, TValue RightValue, EPredicateCompareOperatorType OperatorType)
+	{
+		static_assert(static_cast<__underlying_type(EPredicateCompareOperatorType)>(EPredicateCompareOperatorType::Max) == 6, "This code may need updating if the enum values change");
+		switch (OperatorType)
+		{
+		case EPredicateCompareOperatorType::Equal:
+			if constexpr (std::is_floating_point_v<TValue>) { return AreFloatsEqual(LeftValue, RightValue); }
+			else { return LeftValue == RightValue; }
+		case EPredicateCompareOperatorType::NotEqual:
+			if constexpr (std::is_floating_point_v<TValue>) { return !AreFloatsEqual(LeftValue, RightValue); }
+			else { return LeftValue != RightValue; }
+		case EPredicateCompareOperatorType::Less: return LeftValue < RightValue;
+		case EPredicateCompareOperatorType::LessOrEqual: return LeftValue <= RightValue;
+		case EPredicateCompareOperatorType::Greater: return LeftValue > RightValue;
+		case EPredicateCompareOperatorType::GreaterOrEqual: return LeftValue >= RightValue;
+		default: return false;
+		}
+	}
+}
+
+void UAIFlowPredicateBatchSubsystem::Deinitialize()
+{
+	// The requesters are going away with the world, so the pending results are not delivered
+	BatchGroups.Reset();
+	IndividualEvaluations.Reset();
+	NumPendingEvaluations = 0;
+
+	Super::Deinitialize();
+}
+
+bool UAIFlowPredicateBatchSubsystem::IsTickable() const
+{
+	return NumPendingEvaluations > 0;
+}
+
+TStatId UAIFlowPredicateBatchSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UAIFlowPredicateBatchSubsystem, STATGROUP_Tickables);
+}
+
+void UAIFlowPredicateBatchSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	FlushPendingEvaluations();
+}
+
+void UAIFlowPredicateBatchSubsystem::RequestEvaluation(const UFlowNodeAddOn& PredicateAddOn, FAIFlowOnBatchedPredicateEvaluated OnEvaluated)
+{
+	if (!PredicateAddOn.Implements<UFlowPredicateInterface>())
+	{
+		UE_LOG(LogAIFlow, Error, TEXT("Cannot batch the evaluation of %s, which is not a predicate."), *PredicateAddOn.GetName());
+
+		return;
+	}
+
+	FPendingEvaluation Evaluation;
+	Evaluation.PredicateAddOn = &PredicateAddOn;
+	Evaluation.OnEvaluated = MoveTemp(OnEvaluated);
+
+	// Compare and distance predicates with a resolvable blackboard component are batched with the other instances of their template.
+	// (Caching compare predicates are not, as they are cheaper to evaluate from their cached result,
+	// nor are compare predicates with hysteresis or a hold time, as their result depends on their previous results.)
+	FAIFlowCachedBlackboardReference CachedBlackboard;
+	if (const UFlowNodeAddOn_PredicateCompareBlackboardValue* ComparePredicate = Cast<UFlowNodeAddOn_PredicateCompareBlackboardValue>(&PredicateAddOn))
+	{
+		if (!ComparePredicate->IsCachingResultWithObservers() && !ComparePredicate->HasStatefulResult())
+		{
+			CachedBlackboard = ComparePredicate->ResolveBlackboardForEvaluation();
+		}
+	}
+	else if (const UFlowNodeAddOn_PredicateBlackboardDistance* DistancePredicate = Cast<UFlowNodeAddOn_PredicateBlackboardDistance>(&PredicateAddOn))
+	{
+		if (DistancePredicate->CanEvaluateAsBatch())
+		{
+			CachedBlackboard = DistancePredicate->ResolveBlackboardForEvaluation();
+		}
+	}
+
+	if (CachedBlackboard.IsValid())
+	{
+		// Instances are created from the template predicate, which is their archetype
+		const UObject* GroupObject = PredicateAddOn.GetArchetype();
+		if (!GroupObject || GroupObject->HasAnyFlags(RF_ClassDefaultObject))
+		{
+			GroupObject = &PredicateAddOn;
+		}
+
+		const FBatchGroupKey GroupKey(GroupObject, CachedBlackboard.BlackboardData.Get());
+
+		FBatchGroup& BatchGroup = BatchGroups.FindOrAdd(GroupKey);
+		BatchGroup.BlackboardData = CachedBlackboard.BlackboardData;
+
+		Evaluation.BlackboardComponent = CachedBlackboard.BlackboardComponent;
+		BatchGroup.PendingEvaluations.Add(MoveTemp(Evaluation));
+
+		++NumPendingEvaluations;
+
+		return;
+	}
+
+	IndividualEvaluations.Add(MoveTemp(Evaluation));
+
+	++NumPendingEvaluations;
+}
+
+void UAIFlowPredicateBatchSubsystem::FlushPendingEvaluations()
+{
+	SCOPE_CYCLE_COUNTER(STAT_AIFlow_PredicateBatchFlush);
+
+	if (NumPendingEvaluations == 0)
+	{
+		return;
+	}
+
+	// Evaluate everything before delivering any results, because the callbacks can request (or flush) more evaluations
+	TArray<FPendingEvaluation> EvaluatedEvaluations;
+	EvaluatedEvaluations.Reserve(NumPendingEvaluations);
+
+	// The groups are evicted once they are evaluated, so that groups for predicates (and blackboards) that are no longer
+	// evaluated do not accumulate; a group is recreated (and its predicate recompiled) by its next request
+	TMap<FBatchGroupKey, FBatchGroup> EvaluatedBatchGroups = MoveTemp(BatchGroups);
+	BatchGroups.Reset();
+
+	for (TPair<FBatchGroupKey, FBatchGroup>& GroupPair : EvaluatedBatchGroups)
+	{
+		FBatchGroup& BatchGroup = GroupPair.Value;
+
+		TArray<FPendingEvaluation> GroupEvaluations = MoveTemp(BatchGroup.PendingEvaluations);
+		EvaluateBatchGroup(BatchGroup, GroupEvaluations);
+
+		INC_DWORD_STAT_BY(STAT_AIFlow_BatchedPredicateEvaluations, GroupEvaluations.Num());
+
+		EvaluatedEvaluations.Append(MoveTemp(GroupEvaluations));
+	}
+
+	EvaluatedBatchGroups.Reset();
+
+	TArray<FPendingEvaluation> PendingIndividualEvaluations = MoveTemp(IndividualEvaluations);
+
+	// Consecutive evaluations of the same node's predicates share an evaluation context
+	// (no results are delivered, so no blackboards are written, until everything has been evaluated)
+	TOptional<FAIFlowScopedPredicateEvaluationContext> EvaluationScope;
+	for (FPendingEvaluation& Evaluation : PendingIndividualEvaluations)
+	{
+		const UFlowNodeAddOn* PredicateAddOn = Evaluation.PredicateAddOn.Get();
+		const UFlowNode* FlowNode = PredicateAddOn ? PredicateAddOn->GetTypedOuter<UFlowNode>() : nullptr;
+
+		if (FlowNode && (!EvaluationScope.IsSet() || EvaluationScope->GetContext().GetFlowNode() != FlowNode))
+		{
+			EvaluationScope.Reset();
+			EvaluationScope.Emplace(*FlowNode);
+		}
+
+		EvaluateIndividually(Evaluation);
+	}
+
+	EvaluationScope.Reset();
+
+	INC_DWORD_STAT_BY(STAT_AIFlow_IndividualPredicateEvaluations, PendingIndividualEvaluations.Num());
+
+	EvaluatedEvaluations.Append(MoveTemp(PendingIndividualEvaluations));
+
+	NumPendingEvaluations = 0;
+
+	for (FPendingEvaluation& Evaluation : EvaluatedEvaluations)
+	{
+		// Results for predicates that have gone away (eg, their flow asset instance was finished) are discarded
+		if (Evaluation.PredicateAddOn.IsValid())
+		{
+			(void) Evaluation.OnEvaluated.ExecuteIfBound(Evaluation.bResult);
+		}
+	}
+}
+
+void UAIFlowPredicateBatchSubsystem::EvaluateIndividually(FPendingEvaluation& Evaluation)
+{
+	const UFlowNodeAddOn* PredicateAddOn = Evaluation.PredicateAddOn.Get();
+	Evaluation.bResult = IsValid(PredicateAddOn) && IFlowPredicateInterface::Execute_EvaluatePredicate(PredicateAddOn);
+}
+
+void UAIFlowPredicateBatchSubsystem::EvaluateBatchGroup(FBatchGroup& BatchGroup, TArray<FPendingEvaluation>& InOutEvaluations) const
+{
+	using namespace AIFlowPredicateBatchSubsystem_Private;
+
+	const UBlackboardData* BlackboardData = BatchGroup.BlackboardData.Get();
+
+	// A group's predicates share a template, so share a class
+	const UFlowNodeAddOn* FirstPredicateAddOn = InOutEvaluations.IsEmpty() ? nullptr : InOutEvaluations[0].PredicateAddOn.Get();
+	if (BlackboardData && IsValid(FirstPredicateAddOn) && FirstPredicateAddOn->IsA<UFlowNodeAddOn_PredicateBlackboardDistance>())
+	{
+		EvaluateDistanceBatchGroup(*BlackboardData, InOutEvaluations);
+
+		return;
+	}
+
+	// Compile the predicate for the group's blackboard on first use (any instance will do, they share a template)
+	if (BlackboardData && !BatchGroup.Program.IsCompiledFor(*BlackboardData))
+	{
+		for (const FPendingEvaluation& Evaluation : InOutEvaluations)
+		{
+			if (const UFlowNodeAddOn_PredicateCompareBlackboardValue* ComparePredicate = Cast<UFlowNodeAddOn_PredicateCompareBlackboardValue>(Evaluation.PredicateAddOn.Get()))
+			{
+				const FAIFlowBlackboardExpressionClause Clause = ComparePredicate->MakeExpressionClause();
+
+				FString CompileError;
+				(void) BatchGroup.Program.Compile(*BlackboardData, MakeArrayView(&Clause, 1), CompileError);
+
+				break;
+			}
+		}
+	}
+
+	// Predicates that do not compile are evaluated individually, so that they report their errors as usual
+	if (!BlackboardData || !BatchGroup.Program.IsCompiledFor(*BlackboardData) || BatchGroup.Program.GetNumInstructions() != 1)
+	{
+		for (FPendingEvaluation& Evaluation : InOutEvaluations)
+		{
+			EvaluateIndividually(Evaluation);
+		}
+
+		return;
+	}
+
+	const FAIFlowBlackboardExpressionInstruction& Instruction = BatchGroup.Program.GetInstructions()[0];
+	const bool bHasRightKey = Instruction.RightKeyID != FBlackboard::InvalidKey;
+	const uint8* RightConstantMemory = bHasRightKey ? nullptr : BatchGroup.Program.GetConstantMemory(Instruction.RightConstantOffset);
+
+	const int32 NumEvaluations = InOutEvaluations.Num();
+
+	const bool bIsFloat = Instruction.ValueKind == EAIFlowBlackboardExpressionValueKind::Float;
+	const bool bIsInteger =
+		Instruction.ValueKind == EAIFlowBlackboardExpressionValueKind::Int ||
+		Instruction.ValueKind == EAIFlowBlackboardExpressionValueKind::Enum;
+
+	if (!bIsFloat && !bIsInteger)
+	{
+		// Vectors, rotators and bitwise compares run the compiled program per component
+		for (FPendingEvaluation& Evaluation : InOutEvaluations)
+		{
+			const UBlackboardComponent* BlackboardComponent = Evaluation.BlackboardComponent.Get();
+			Evaluation.bResult = BlackboardComponent && BatchGroup.Program.Execute(*BlackboardComponent);
+		}
+
+		return;
+	}
+
+	// Gather the operands into contiguous arrays (invalid lanes are compared, then overwritten with false)
+	TArray<uint8, TInlineAllocator<64>> LaneIsValid;
+	LaneIsValid.SetNumZeroed(NumEvaluations);
+
+	TArray<bool, TInlineAllocator<64>> Results;
+	Results.SetNumZeroed(NumEvaluations);
+
+	const auto GatherOperands = [&](auto& LeftValues, auto& RightValues, auto ReadOperand)
+		{
+			LeftValues.SetNumZeroed(NumEvaluations);
+			if (bHasRightKey)
+			{
+				RightValues.SetNumZeroed(NumEvaluations);
+			}
+
+			for (int32 Index = 0; Index < NumEvaluations; ++Index)
+			{
+				const UBlackboardComponent* BlackboardComponent = InOutEvaluations[Index].BlackboardComponent.Get();
+				const uint8* LeftMemory = BlackboardComponent ? BlackboardComponent->GetKeyRawData(Instruction.LeftKeyID) : nullptr;
+				const uint8* RightMemory = (BlackboardComponent && bHasRightKey) ? BlackboardComponent->GetKeyRawData(Instruction.RightKeyID) : nullptr;
+
+				if (!LeftMemory || (bHasRightKey && !RightMemory))
+				{
+					continue;
+				}
+
+				LaneIsValid[Index] = 1;
+				LeftValues[Index] = ReadOperand(LeftMemory);
+
+				if (bHasRightKey)
+				{
+					RightValues[Index] = ReadOperand(RightMemory);
+				}
+			}
+		};
+
+	if (bIsFloat)
+	{
+		TArray<float, TInlineAllocator<64>> LeftValues;
+		TArray<float, TInlineAllocator<64>> RightValues;
+		GatherOperands(LeftValues, RightValues, [](const uint8* Memory) { return ReadValue<float>(Memory); });
+
+		const float RightConstant = RightConstantMemory ? ReadValue<float>(RightConstantMemory) : 0.0f;
+		CompareFloats(LeftValues.GetData(), bHasRightKey ? RightValues.GetData() : nullptr, RightConstant, NumEvaluations, Instruction.OperatorType, Results.GetData());
+	}
+	else
+	{
+		const bool bIsEnum = Instruction.ValueKind == EAIFlowBlackboardExpressionValueKind::Enum;
+		const auto ReadInteger = [bIsEnum](const uint8* Memory) -> int32
+			{
+				return bIsEnum ? static_cast<int32>(ReadValue<uint8>(Memory)) : ReadValue<int32>(Memory);
+			};
+
+		TArray<int32, TInlineAllocator<64>> LeftValues;
+		TArray<int32, TInlineAllocator<64>> RightValues;
+		GatherOperands(LeftValues, RightValues, ReadInteger);
+
+		const int32 RightConstant = RightConstantMemory ? ReadInteger(RightConstantMemory) : 0;
+		CompareInts(LeftValues.GetData(), bHasRightKey ? RightValues.GetData() : nullptr, RightConstant, NumEvaluations, Instruction.OperatorType, Results.GetData());
+	}
+
+	// Scatter the results back to the requests
+	for (int32 Index = 0; Index < NumEvaluations; ++Index)
+	{
+		InOutEvaluations[Index].bResult = LaneIsValid[Index] && (Results[Index] != Instruction.bNot);
+	}
+}
+
+void UAIFlowPredicateBatchSubsystem::EvaluateDistanceBatchGroup(const UBlackboardData& BlackboardData, TArray<FPendingEvaluation>& InOutEvaluations)
+{
+	// Any instance will do, they share a template (and so the query point)
+	const UFlowNodeAddOn_PredicateBlackboardDistance* DistancePredicate = nullptr;
+
+	TArray<const UBlackboardComponent*, TInlineAllocator<64>> BlackboardComponents;
+	BlackboardComponents.Reserve(InOutEvaluations.Num());
+
+	for (const FPendingEvaluation& Evaluation : InOutEvaluations)
+	{
+		if (!DistancePredicate)
+		{
+			DistancePredicate = Cast<UFlowNodeAddOn_PredicateBlackboardDistance>(Evaluation.PredicateAddOn.Get());
+		}
+
+		BlackboardComponents.Add(Evaluation.BlackboardComponent.Get());
+	}
+
+	TArray<bool> Results;
+	if (!DistancePredicate || !DistancePredicate->TryEvaluateBatch(BlackboardData, BlackboardComponents, Results))
+	{
+		for (FPendingEvaluation& Evaluation : InOutEvaluations)
+		{
+			EvaluateIndividually(Evaluation);
+		}
+
+		return;
+	}
+
+	for (int32 Index = 0; Index < InOutEvaluations.Num(); ++Index)
+	{
+		InOutEvaluations[Index].bResult = Results[Index];
+	}
+}
+
+void UAIFlowPredicateBatchSubsystem::CompareFloats(const float* LeftValues, const float* RightValues, float RightConstant, int32 Count, EPredicateCompareOperatorType OperatorType, bool* OutResults)
+{
+	using namespace AIFlowPredicateBatchSubsystem_Private;
+
+	const VectorRegister4Float RightConstantVector = VectorSetFloat1(RightConstant);
+	const VectorRegister4Float ToleranceVector = VectorSetFloat1(FloatEqualityTolerance);
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		const VectorRegister4Float Left = VectorLoad(LeftValues + Index);
+		const VectorRegister4Float Right = RightValues ? VectorLoad(RightValues + Index) : RightConstantVector;
+
+		VectorRegister4Float Mask;
+		switch (OperatorType)
+		{
+		case EPredicateCompareOperatorType::Equal: Mask = VectorCompareLT(VectorAbs(VectorSubtract(Left, Right)), ToleranceVector); break;
+		case EPredicateCompareOperatorType::NotEqual: Mask = VectorCompareGE(VectorAbs(VectorSubtract(Left, Right)), ToleranceVector); break;
+		case EPredicateCompareOperatorType::Less: Mask = VectorCompareLT(Left, Right); break;
+		case EPredicateCompareOperatorType::LessOrEqual: Mask = VectorCompareLE(Left, Right); break;
+		case EPredicateCompareOperatorType::Greater: Mask = VectorCompareGT(Left, Right); break;
+		case EPredicateCompareOperatorType::GreaterOrEqual: Mask = VectorCompareGE(Left, Right); break;
+		default: Mask = VectorZeroFloat(); break;
+		}
+
+		ScatterMaskBits(static_cast<uint32>(VectorMaskBits(Mask)), OutResults + Index);
+	}
+
+	for (; Index < Count; ++Index)
+	{
+		OutResults[Index] = CompareScalar(LeftValues[Index], RightValues ? RightValues[Index] : RightConstant, OperatorType);
+	}
+}
+
+void UAIFlowPredicateBatchSubsystem::CompareInts(const int32* LeftValues, const int32* RightValues, int32 RightConstant, int32 Count, EPredicateCompareOperatorType OperatorType, bool* OutResults)
+{
+	using namespace AIFlowPredicateBatchSubsystem_Private;
+
+	const VectorRegister4Int RightConstantVector = VectorIntSet1(RightConstant);
+
+	int32 Index = 0;
+	for (; Index + 4 <= Count; Index += 4)
+	{
+		const VectorRegister4Int Left = VectorIntLoad(LeftValues + Index);
+		const VectorRegister4Int Right = RightValues ? VectorIntLoad(RightValues + Index) : RightConstantVector;
+
+		VectorRegister4Int Mask;
+		switch (OperatorType)
+		{
+		case EPredicateCompareOperatorType::Equal: Mask = VectorIntCompareEQ(Left, Right); break;
+		case EPredicateCompareOperatorType::NotEqual: Mask = VectorIntCompareNEQ(Left, Right); break;
+		case EPredicateCompareOperatorType::Less: Mask = VectorIntCompareLT(Left, Right); break;
+		case EPredicateCompareOperatorType::LessOrEqual: Mask = VectorIntCompareLE(Left, Right); break;
+		case EPredicateCompareOperatorType::Greater: Mask = VectorIntCompareGT(Left, Right); break;
+		case EPredicateCompareOperatorType::GreaterOrEqual: Mask = VectorIntCompareGE(Left, Right); break;
+		default: Mask = GlobalVectorConstants::IntZero; break;
+		}
+
+		ScatterMaskBits(static_cast<uint32>(VectorMaskBits(VectorCastIntToFloat(Mask))), OutResults + Index);
+	}
+
+	for (; Index < Count; ++Index)
+	{
+		OutResults[Index] = CompareScalar(LeftValues[Index], RightValues ? RightValues[Index] : RightConstant, OperatorType);
+	}
+}
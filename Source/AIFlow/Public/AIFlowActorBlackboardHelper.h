@@ -2,6 +2,8 @@
 
 #pragma once
 
+#include "Engine/EngineTypes.h"
+#include "Engine/TimerHandle.h"
 #include "Templates/SubclassOf.h"
 #include "Types/FlowDataPinValue.h"
 #include "Types/FlowEnumUtils.h"
@@ -17,9 +19,11 @@ class UBlackboardComponent;
 class UBlackboardData;
 class UFlowBlackboardEntryValue;
 class UFlowNodeBase;
+class UAIFlowBlackboardKeyAgeSubsystem;
 class UFlowInjectComponentsManager;
 struct FFlowBlackboardEntry;
 class UBlackboardKeyType;
+class UWorld;
 
 // Rule enum for injecting missing blackboards on Actors
 UENUM()
@@ -91,12 +95,31 @@ enum class EPerActorOptionsAssignmentMethod : uint8
 	// reshuffling if the PerActorOptions are insufficient for the number of actors
 	ShuffledWithReshuffling,
 
+	// Each actor's option is chosen from a hash of the actor's identity and the flow instance's random seed,
+	// so the assignment is repeatable between runs (and, for placed actors, on every machine).
+	// Placed actors are identified by their path in the level, spawned actors by their name (fixed when they are spawned),
+	// so an actor's option does not depend on the order the actors are applied in.
+	HashedByActorIdentity UMETA(DisplayName = "Hashed By Actor Identity"),
+
+	// As HashedByActorIdentity, but the actors applied together are ranked by their hash and dealt the options in turn,
+	// so the options are evenly distributed across each batch (a batch of one actor matches HashedByActorIdentity)
+	HashedBalanced UMETA(DisplayName = "Hashed (Balanced)"),
+
 	Max UMETA(Hidden),
 	Invalid UMETA(Hidden),
 	Min = 0 UMETA(Hidden),
+
+	StatelessFirst = HashedByActorIdentity UMETA(Hidden),
+	StatelessLast = HashedBalanced UMETA(Hidden),
 };
 FLOW_ENUM_RANGE_VALUES(EPerActorOptionsAssignmentMethod);
 
+namespace EPerActorOptionsAssignmentMethod_Classifiers
+{
+	// Stateless methods choose from the actor's identity and the assignment seed only (see FAIFlowActorBlackboardHelper::SetAssignmentSeed)
+	FORCEINLINE bool IsStateless(EPerActorOptionsAssignmentMethod Method) { return FLOW_IS_ENUM_IN_SUBRANGE(Method, EPerActorOptionsAssignmentMethod::Stateless); }
+}
+
 // A bundle of Blackboard Entries to set on an actor(s)
 USTRUCT(BlueprintType)
 struct FAIFlowConfigureBlackboardOption
@@ -127,6 +150,105 @@ public:
 		const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
 		const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions);
 
+	// Batched version of ApplyBlackboardOptionsToBlackboardComponent().
+	// Chooses the PerActorOptions for the whole batch up-front, then applies the entries to each component in order
+	// (resolving the entries' KeyIDs once per blackboard asset, rather than once per component).
+	// Invalid entries in BlackboardComponents are skipped and do not consume an option.
+	void ApplyBlackboardOptionsToBlackboardComponents(
+		TArrayView<UBlackboardComponent* const> BlackboardComponents,
+		EPerActorOptionsAssignmentMethod AssignmentMethod,
+		const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
+		const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions);
+
+	// Queue the options for the actors in InOutActors that are bound to Mass entities (see UAIFlowMassBlackboardSubsystem),
+	// removing them from InOutActors, so that the remaining actors can be applied to through their blackboard components.
+	// If OptionalBlackboardData is specified, entities without a blackboard are given one for it.
+	// Returns the number of Mass agents that the writes were queued for.
+	int32 ExtractAndQueueBlackboardOptionsForMassAgents(
+		UWorld& World,
+		TArray<AActor*>& InOutActors,
+		EPerActorOptionsAssignmentMethod AssignmentMethod,
+		const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
+		const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions,
+		const UBlackboardData* OptionalBlackboardData = nullptr);
+
+	// Chooses the next NumActors PerActorOptions indices (INDEX_NONE if there are no options) into OutOptionIndices.
+	// Produces the same sequence as calling ChooseNextBlackboardOptionIndex() NumActors times.
+	// The stateless methods need the actors' identities, so they are chosen in-order here.
+	void ChooseBlackboardOptionIndices(
+		EPerActorOptionsAssignmentMethod AssignmentMethod,
+		const TArray<FAIFlowConfigureBlackboardOption>& PerActorOptions,
+		int32 NumActors,
+		TArray<int32>& OutOptionIndices);
+
+	// Chooses the PerActorOptions indices for a batch of (valid) BlackboardComponents into OutOptionIndices,
+	// using the components' actor identities for the stateless methods
+	void ChooseBlackboardOptionIndicesForComponents(
+		EPerActorOptionsAssignmentMethod AssignmentMethod,
+		const TArray<FAIFlowConfigureBlackboardOption>& PerActorOptions,
+		TArrayView<UBlackboardComponent* const> BlackboardComponents,
+		TArray<int32>& OutOptionIndices);
+
+	// Seed for the stateless assignment methods (typically the owning node's GetRandomSeed())
+	void SetAssignmentSeed(int32 InAssignmentSeed) { AssignmentSeed = InAssignmentSeed; }
+
+	// Stable hash of the actor that BlackboardComponent is for (its owner, or the owner's pawn if owned by a controller).
+	// Actors loaded with their level hash their path within the level, which is the same between runs and on every machine.
+	// Spawned actors hash their name, which is fixed at spawn, so the hash does not depend on the order actors are configured in.
+	static uint32 GetActorIdentityHash(const UBlackboardComponent& BlackboardComponent);
+	static uint32 GetActorIdentityHash(const AActor& Actor);
+
+	// Stateless option choice for HashedByActorIdentity (thread-safe)
+	static int32 ChooseHashedBlackboardOptionIndex(uint32 ActorIdentityHash, int32 AssignmentSeed, int32 NumOptions);
+
+	// Stateless option choice for a batch of actors with a stateless AssignmentMethod (thread-safe).
+	// The result for each actor depends only on the set of identities in the batch, not their order.
+	static void ChooseHashedBlackboardOptionIndices(
+		EPerActorOptionsAssignmentMethod AssignmentMethod,
+		TArrayView<const uint32> ActorIdentityHashes,
+		int32 AssignmentSeed,
+		int32 NumOptions,
+		TArray<int32>& OutOptionIndices);
+
+	// Reset the PerActorOptions assignment state (eg, when the owning node instance is reused)
+	void ResetOptionAssignmentState();
+
+	// Begin applying the options to BlackboardComponents over multiple slices (cancelling any application in progress).
+	// The PerActorOptions are chosen up-front, so the assignment matches the non-time-sliced version.
+	void BeginTimeSlicedApplication(
+		TArrayView<UBlackboardComponent* const> BlackboardComponents,
+		EPerActorOptionsAssignmentMethod AssignmentMethod,
+		const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions);
+
+	// Apply the next slice of a time-sliced application: at least one blackboard,
+	// then more until either budget is reached (0 for no limit).
+	// Blackboards that were destroyed since the application began are skipped.
+	// Returns true when every blackboard has been applied.
+	bool ApplyNextTimeSlice(
+		const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
+		const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions,
+		int32 MaxBlackboardsPerSlice,
+		int32 MaxMicrosecondsPerSlice);
+
+	// ApplyNextTimeSlice, then (if blackboards remain) schedule OnNextSlice for World's next tick.
+	// Without a World, the remaining blackboards are all applied now.
+	// Returns true when every blackboard has been applied.
+	bool ApplyNextTimeSliceAndScheduleNext(
+		UWorld* World,
+		const FAIFlowConfigureBlackboardOption& EntriesForEveryActor,
+		const TArray<FAIFlowConfigureBlackboardOption>* PerActorOptions,
+		int32 MaxBlackboardsPerSlice,
+		int32 MaxMicrosecondsPerSlice,
+		const FTimerDelegate& OnNextSlice);
+
+	// Cancel the application in progress (and its scheduled slice, if any)
+	void CancelTimeSlicedApplication();
+	bool IsTimeSlicedApplicationInProgress() const { return TimeSlicedNextIndex != INDEX_NONE; }
+
+	// Changes whenever an application is begun or cancelled, so that callers can detect that their application
+	// was restarted or cancelled re-entrantly (eg, by the node being finished or re-executed from an output pin's branch)
+	uint32 GetTimeSlicedApplicationSerial() const { return TimeSlicedApplicationSerial; }
+
 	// Find or add (if the InjectRule allows) the desired BlackboardComponent on Actors.
 	// If no OptionalBlackboardData is specified, it uses the first blackboard component that can be found,
 	// otherwise, it restricts the result to a blackboard component that uses the blackboard data specified.
@@ -158,6 +280,12 @@ public:
 		UBlackboardComponent* OptionalBlackboardComponent,
 		TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty);
 
+	// Version of TryProvideFlowDataPinPropertyFromBlackboardEntry for a value in raw key memory (eg, a Mass blackboard fragment)
+	AIFLOW_API static EFlowDataPinResolveResult TryProvideFlowDataPinPropertyFromRawKeyMemory(
+		const UBlackboardKeyType& BlackboardKeyType,
+		const uint8* RawKeyMemory,
+		TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty);
+
 #if WITH_EDITOR
 	// Helper function to append text for Flow Node/AddOn Configuration display
 	AIFLOW_API static void AppendBlackboardOptions(
@@ -167,8 +295,8 @@ public:
 
 protected:
 
-	// Apply the Blackboard Entries's value changes to the specified blackboard
-	static void ApplyBlackboardEntries(UBlackboardComponent& BlackboardComponent, const TArray<UFlowBlackboardEntryValue*>& EntriesToApply);
+	// Apply the Blackboard Entries's value changes to the specified blackboard (recording the writes on KeyAgeSubsystem, if given)
+	static void ApplyBlackboardEntries(UBlackboardComponent& BlackboardComponent, const TArray<UFlowBlackboardEntryValue*>& EntriesToApply, UAIFlowBlackboardKeyAgeSubsystem* KeyAgeSubsystem);
 
 	// Helper function to setup and maintain the OrderedOptionIndices and OrderedOptionIndex according to the AssignmentMethod.
 	int32 ChooseNextBlackboardOptionIndex(
@@ -188,6 +316,27 @@ protected:
 	// May be in-order, or shuffled, based on the AssignmentMethod used to generate the array.
 	UPROPERTY(Transient)
 	TArray<int32> OrderedOptionIndices;
+
+	// Seed for the stateless assignment methods
+	UPROPERTY(Transient)
+	int32 AssignmentSeed = 0;
+
+	// Blackboards (and their chosen PerActorOptions indices) for the time-sliced application in progress
+	UPROPERTY(Transient)
+	TArray<TWeakObjectPtr<UBlackboardComponent>> TimeSlicedBlackboardComponents;
+
+	UPROPERTY(Transient)
+	TArray<int32> TimeSlicedOptionIndices;
+
+	// Next index into TimeSlicedBlackboardComponents to apply (INDEX_NONE if no application is in progress)
+	UPROPERTY(Transient)
+	int32 TimeSlicedNextIndex = INDEX_NONE;
+
+	uint32 TimeSlicedApplicationSerial = 0;
+
+	// Timer (and its world) for the next slice of the time-sliced application in progress
+	FTimerHandle TimeSliceTimerHandle;
+	TWeakObjectPtr<UWorld> TimeSliceTimerWorld;
 };
 
 // Helper struct to cache the blackboard component and runtime data reference
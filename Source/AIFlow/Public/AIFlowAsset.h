@@ -5,6 +5,11 @@
 #include "FlowAsset.h"
 #include "Interfaces/FlowBlackboardAssetProvider.h"
 #include "Interfaces/FlowBlackboardInterface.h"
+#include "Engine/StreamableManager.h"
+#include "Templates/Function.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/SoftObjectPath.h"
+#include "UObject/WeakInterfacePtr.h"
 
 #include "AIFlowAsset.generated.h"
 
@@ -12,6 +17,9 @@
 class UBlackboardData;
 class UBlackboardComponent;
 class UFlowInjectComponentsManager;
+struct FBlackboardEntry;
+
+DECLARE_DELEGATE_OneParam(FAIFlowOnBeforeInjectedActorRemoved, AActor* /* RemovedActor */);
 
 /**
  * Flow Asset subclass to add AI utility (specifically blackboard) capabilities
@@ -29,12 +37,34 @@ public:
 	// UFlowAsset
 	virtual void InitializeInstance(const TWeakObjectPtr<UObject> InOwner, UFlowAsset& InTemplateAsset) override;
 	virtual void DeinitializeInstance() override;
+	virtual void StartFlow(IFlowDataPinValueSupplierInterface* DataPinValueSupplier = nullptr) override;
+	// --
+
+	// UObject
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
 	// --
 
+	// Initialize many instances of the same TemplateAsset in one call (eg, for level start or a wave of spawns).
+	// Instances[Index] is initialized for Owners[Index] (with InitializeInstance, so subclass overrides still run).
+	// The work that is shared by the batch (the random seed stream, the PreloadManifest request and the injected
+	// blackboard component's base name) is done once.  Each blackboard component is still created in its instance's
+	// InitializeInstance, so that subclass overrides find it set up after calling Super.
+	// Returns the number of instances that were initialized.
+	// See also UAIFlowAssetPoolSubsystem::AcquireOrCreateInstances.
+	static int32 InitializeInstances(
+		UFlowAsset& TemplateAsset,
+		TArrayView<UAIFlowAsset* const> Instances,
+		TArrayView<const TWeakObjectPtr<UObject>> Owners);
+
 	// IFlowBlackboardInterface
 	virtual UBlackboardComponent* GetBlackboardComponent() const override;
 	// --
 
+	// Get the blackboard component, creating it first if its creation was deferred (see bDeferBlackboardComponentCreation).
+	// GetBlackboardComponent returns nullptr until it has been created.
+	UFUNCTION(BlueprintCallable, Category = "AI Flow")
+	UBlackboardComponent* EnsureBlackboardComponent();
+
 	// IBlackboardAssetProvider
 	virtual UBlackboardData* GetBlackboardAsset() const override;
 	// --
@@ -52,15 +82,77 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = "AI Flow")
 	int32 GetRandomSeed() const { return RandomSeed; }
 
+	// Acquire the InjectComponentsManager that is shared by every node and addon in this flow instance.
+	// OnBeforeActorRemoved is called for the actors the User registered (see RegisterInjectedActorUser)
+	// when the manager removes their injected components, or for all of them when the User's last acquire is released.
+	// Each Acquire must be paired with a ReleaseInjectComponentsManager.
+	// (FAIFlowInjectComponentsManagerHelper wraps this for nodes and addons)
+	UFlowInjectComponentsManager* AcquireInjectComponentsManager(const UObject& User, const FAIFlowOnBeforeInjectedActorRemoved& OnBeforeActorRemoved);
+	void ReleaseInjectComponentsManager(const UObject& User);
+
+	// Record that User injected components onto Actor with the shared manager,
+	// so that (only) User is notified when they are removed
+	void RegisterInjectedActorUser(const UObject& User, AActor& Actor);
+
+	// Reset a deinitialized instance (and its AI nodes and addons) so that it can be re-initialized from an instance pool.
+	// The node instances are then discarded (and restored from the template), so InitializeInstance creates fresh ones.
+	// Returns false if the instance is not in a state that can be reused (it should not be pooled).
+	// See UAIFlowAssetPoolSubsystem.
+	virtual bool ResetInstanceForReuse();
+
+	// Modify this instance's runtime blackboard data, cloning it first if it is shared with other instances.
+	// The blackboard component (if created by this asset) is re-initialized with the modified data,
+	// keeping the values of its keys that are unchanged by the modification (except for instanced key types, other than String).
+	UBlackboardData* DivergeRuntimeBlackboardData(TFunctionRef<void(UBlackboardData&)> ModifyBlackboardData);
+
+	// Request an async load of the TemplateAsset's PreloadManifest (eg, before creating its flow instances).
+	// Returns null (without calling OnLoaded) if everything in the manifest is already loaded.
+	static TSharedPtr<FStreamableHandle> RequestPreloadManifest(const UAIFlowAsset& TemplateAsset, FStreamableDelegate OnLoaded = FStreamableDelegate());
+
+	const TArray<FSoftObjectPath>& GetPreloadManifest() const { return PreloadManifest; }
+
+	// Is this instance still waiting for its PreloadManifest to load?
+	bool IsPreloadManifestLoading() const { return PreloadHandle.IsValid() && PreloadHandle->IsLoadingInProgress(); }
+
 protected:
 
+	UFlowInjectComponentsManager* EnsureInjectComponentsManager();
+	void ShutdownInjectComponentsManager();
+
+	UFUNCTION()
+	void OnBeforeInjectedActorRemoved(AActor* RemovedActor);
+
+	void InitializeInstanceBlackboard();
+	void NotifyOwnerPostInitializeInstance();
+
 	virtual void CreateAndRegisterBlackboardComponent();
+	void CreateDeferredBlackboardComponent();
 	virtual void DestroyAndUnregisterBlackboardComponent();
 	virtual void SetKeySelfOnBlackboardComponent(UBlackboardComponent* BlackboardComp) const;
 
+	// Base name for the blackboard component injected for BlackboardData
+	static FName MakeBlackboardComponentBaseName(const UBlackboardData& BlackboardData);
+
 	// Return the BlackboardData to use at runtime
 	// (subclasses may want to instance this class For Reasons)
-	virtual UBlackboardData* EnsureRuntimeBlackboardData() const { return BlackboardAsset; }
+	virtual UBlackboardData* EnsureRuntimeBlackboardData() const;
+
+	// Build (and cache) the runtime blackboard data from the GatherRuntimeBlackboardKeys, if it has not been built already
+	void BuildRuntimeBlackboardData();
+
+	// Keys to add to the BlackboardAsset at runtime (eg, procedurally generated keys).
+	// If any are gathered, BuildRuntimeBlackboardData extends the BlackboardAsset with them
+	// (shared between instances with identical keys, if bShareRuntimeBlackboardData).
+	virtual void GatherRuntimeBlackboardKeys(TArray<FBlackboardEntry>& OutRuntimeKeys) const { }
+
+	void OnPreloadManifestLoaded();
+
+#if WITH_EDITOR
+	// Gather the soft-referenced assets (and classes) that this flow's instances may need,
+	// from the properties of its nodes and addons (including their instanced subobjects).
+	// Hard references are not gathered, since they are loaded along with the flow asset.
+	virtual void GatherPreloadManifest(TArray<FSoftObjectPath>& OutPreloadManifest) const;
+#endif // WITH_EDITOR
 
 protected:
 
@@ -68,14 +160,78 @@ protected:
 	UPROPERTY(EditAnywhere, Category = "AI Flow")
 	TObjectPtr<UBlackboardData> BlackboardAsset = nullptr;
 
+	// Defer creating (or finding) the blackboard component until EnsureBlackboardComponent is first called
+	// (by the flow's nodes and addons, when they first access the blackboard),
+	// rather than in InitializeInstance.  Useful for flows that rarely (or never) use their blackboard.
+	UPROPERTY(EditAnywhere, Category = "AI Flow", AdvancedDisplay)
+	bool bDeferBlackboardComponentCreation = false;
+
+	// Set in InitializeInstance when the blackboard component creation has been deferred
+	bool bPendingDeferredBlackboardCreation = false;
+
+	// Share the runtime blackboard data (see GatherRuntimeBlackboardKeys) between instances whose runtime keys are identical,
+	// rather than creating a blackboard data object per instance.  Instances clone the shared data only if they diverge.
+	UPROPERTY(EditAnywhere, Category = "AI Flow", AdvancedDisplay)
+	bool bShareRuntimeBlackboardData = true;
+
+	// Request an async load of the PreloadManifest (this flow's soft references) when an instance is initialized
+	UPROPERTY(EditAnywhere, Category = "AI Flow", AdvancedDisplay)
+	bool bPreloadManifestOnInitialize = false;
+
+	// Defer StartFlow until the PreloadManifest has loaded, rather than loading any missing assets synchronously when first used
+	UPROPERTY(EditAnywhere, Category = "AI Flow", AdvancedDisplay, meta = (EditCondition = "bPreloadManifestOnInitialize"))
+	bool bDeferStartFlowUntilPreloaded = false;
+
+	// Soft-referenced assets that this flow's instances may need (rebuilt when the asset is saved, see GatherPreloadManifest)
+	UPROPERTY(VisibleAnywhere, Category = "AI Flow", AdvancedDisplay)
+	TArray<FSoftObjectPath> PreloadManifest;
+
+	// Handle for this instance's PreloadManifest request (keeps the manifest's assets loaded while the instance is initialized)
+	TSharedPtr<FStreamableHandle> PreloadHandle;
+
+	// The PreloadHandle is shared by the instances of an InitializeInstances batch (so is not cancelled by any one of them)
+	bool bIsPreloadHandleShared = false;
+
+	// StartFlow call deferred until the PreloadManifest has loaded
+	bool bPendingPreloadedStartFlow = false;
+	TWeakInterfacePtr<IFlowDataPinValueSupplierInterface> PendingStartFlowDataPinValueSupplier;
+
+	// Runtime-extended blackboard data for this instance (null if there are no runtime keys), may be shared
+	UPROPERTY(Transient)
+	TObjectPtr<UBlackboardData> RuntimeBlackboardData = nullptr;
+
 	// Cached blackboard component (on the owning actor)
 	UPROPERTY(Transient)
 	TWeakObjectPtr<UBlackboardComponent> BlackboardComponent = nullptr;
 
-	// Manager object to inject and remove blackboard components from the Flow owning Actor
+	// Manager object to inject and remove components from Actors,
+	// shared by this asset (for the Flow owning Actor's blackboard) and its nodes and addons
 	UPROPERTY(Transient)
 	TObjectPtr<UFlowInjectComponentsManager> InjectComponentsManager = nullptr;
 
+	struct FInjectComponentsManagerUser
+	{
+		FAIFlowOnBeforeInjectedActorRemoved OnBeforeActorRemoved;
+		int32 RefCount = 0;
+	};
+
+	// Users of the shared InjectComponentsManager, and the delegate they are notified by
+	TMap<TObjectKey<UObject>, FInjectComponentsManagerUser> InjectComponentsManagerUsers;
+
+	// The users that injected components onto each actor (usually only one)
+	TMap<TObjectKey<AActor>, TArray<TObjectKey<UObject>, TInlineAllocator<1>>> InjectedActorUsers;
+
+	// Actors registered since InjectedActorUsers was last pruned of destroyed actors
+	int32 NumInjectedActorsRegisteredSincePrune = 0;
+
+	// Set while InitializeInstances is running InitializeInstance,
+	// which has already assigned the RandomSeed and requested the PreloadManifest for the batch
+	bool bIsBulkInitializing = false;
+
+	// Base name for an injected blackboard component, built once per InitializeInstances batch
+	// (NAME_None outside of a batch, when it is built from the BlackboardAsset)
+	FName BulkBlackboardComponentBaseName = NAME_None;
+
 	// Subclass-configurable Blackboard component class to use
 	UPROPERTY(Transient)
 	TSubclassOf<UBlackboardComponent> BlackboardComponentClass;
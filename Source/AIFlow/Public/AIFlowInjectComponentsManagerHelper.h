@@ -0,0 +1,33 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "UObject/ObjectPtr.h"
+
+// Forward Declarations
+class AActor;
+class UBlackboardComponent;
+class UFlowInjectComponentsManager;
+class UFlowNodeBase;
+
+/**
+ * Shared implementation for the nodes and addons that use an InjectComponentsManager.
+ *
+ * Users in a UAIFlowAsset share the flow instance's manager (see UAIFlowAsset::AcquireInjectComponentsManager),
+ * other users own their manager.  Either way, OnBeforeActorRemovedFunctionName (a UFUNCTION on the user,
+ * taking an AActor*) is only called for the actors that the user injected components onto.
+ */
+struct AIFLOW_API FAIFlowInjectComponentsManagerHelper
+{
+	// Acquire (or create) User's InjectComponentsManager, if InOutManager is not already set
+	static void EnsureManager(UFlowNodeBase& User, TObjectPtr<UFlowInjectComponentsManager>& InOutManager, const FName& OnBeforeActorRemovedFunctionName);
+
+	// Release (or shut down, if User created it) the manager from EnsureManager, and clear InOutManager
+	static void CleanupManager(UFlowNodeBase& User, TObjectPtr<UFlowInjectComponentsManager>& InOutManager, const FName& OnBeforeActorRemovedFunctionName);
+
+	// Record that User injected components onto Actor, so that User is notified when they are removed from it
+	static void NoteInjectedActor(const UFlowNodeBase& User, const UFlowInjectComponentsManager* Manager, AActor& Actor);
+
+	// As NoteInjectedActor, for the Actor that owns a found (or injected) blackboard component
+	static void NoteInjectedBlackboardComponentOwner(const UFlowNodeBase& User, const UFlowInjectComponentsManager* Manager, const UBlackboardComponent* BlackboardComponent);
+};
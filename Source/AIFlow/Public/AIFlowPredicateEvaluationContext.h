@@ -0,0 +1,104 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "AIFlowActorBlackboardHelper.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "UObject/ObjectKey.h"
+
+// Forward Declarations
+class UBlackboardComponent;
+class UBlackboardData;
+class UFlowNode;
+class UFlowNodeBase;
+
+/**
+ * Shared state for one pass of predicate evaluations on a flow node (eg, the several predicate add-ons of a branch).
+ *
+ * The predicates of the node resolve their blackboards, and gather their keys' values, through the context
+ * (when one is active for their node), so each distinct blackboard is resolved once, and each distinct key read once,
+ * per pass rather than once per predicate.  The blackboards must not be written during the pass.
+ *
+ * Contexts are opened with FAIFlowScopedPredicateEvaluationContext, around the code that evaluates the node's predicates.
+ * Nodes that evaluate their predicates without one (eg, the Flow plugin's branch and gate nodes) share the resolved blackboards
+ * through an implicit context for the node instead, opened by ResolveBlackboardForPredicate.  An implicit context is renewed
+ * when one of the node's predicates resolves again (the start of the next pass) and every frame, and it only shares
+ * the resolved blackboards (key values are only shared within an explicitly scoped pass).
+ */
+struct AIFLOW_API FAIFlowPredicateEvaluationContext
+{
+public:
+
+	explicit FAIFlowPredicateEvaluationContext(const UFlowNode& InFlowNode) : FlowNode(&InFlowNode) { }
+
+	const UFlowNode* GetFlowNode() const { return FlowNode; }
+
+	// Blackboard for FlowNodeBase (a predicate on the context's node), resolved once per distinct asset and search rule
+	FAIFlowCachedBlackboardReference ResolveBlackboard(const UFlowNodeBase& FlowNodeBase, UBlackboardData* OptionalSpecificBlackboardData, EActorBlackboardSearchRule SpecificBlackboardSearchRule);
+
+	// Numerical value of a Float, Int or Enum key (floats are floored for OutIntValue), gathered once per distinct key
+	bool TryGetNumericalValue(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, int32& OutIntValue, float& OutFloatValue);
+
+	// Dedup counters for this pass (requests that were served from the context, vs. resolved or gathered)
+	int32 GetNumSharedBlackboardResolves() const { return NumSharedBlackboardResolves; }
+	int32 GetNumSharedKeyValues() const { return NumSharedKeyValues; }
+	int32 GetNumResolvedBlackboards() const { return ResolvedBlackboards.Num(); }
+	int32 GetNumGatheredKeyValues() const { return GatheredKeyValues.Num(); }
+
+	// Innermost active context for FlowNodeBase's node (FlowNodeBase may be the node, or one of its add-ons)
+	static FAIFlowPredicateEvaluationContext* FindActiveContext(const UFlowNodeBase& FlowNodeBase);
+
+	// Blackboard for FlowNodeBase, shared through the active context for its node (if there is one),
+	// otherwise through the node's implicit context (on the game thread), otherwise resolved directly
+	static FAIFlowCachedBlackboardReference ResolveBlackboardForPredicate(const UFlowNodeBase& FlowNodeBase, UBlackboardData* OptionalSpecificBlackboardData, EActorBlackboardSearchRule SpecificBlackboardSearchRule);
+
+protected:
+
+	friend struct FAIFlowScopedPredicateEvaluationContext;
+
+	static TArray<FAIFlowPredicateEvaluationContext*>& GetActiveContexts();
+
+	// Implicit context for the node that FlowNodeBase belongs to, renewed if FlowNodeBase has already resolved in it
+	static FAIFlowPredicateEvaluationContext* FindOrRenewImplicitContext(const UFlowNodeBase& FlowNodeBase);
+
+	static const UFlowNode* GetOwningFlowNode(const UFlowNodeBase& FlowNodeBase);
+
+	struct FResolvedBlackboard
+	{
+		TObjectKey<UBlackboardData> SpecificBlackboardData;
+		EActorBlackboardSearchRule SpecificBlackboardSearchRule = EActorBlackboardSearchRule::ActorAndControllerAndGameState;
+		FAIFlowCachedBlackboardReference CachedBlackboard;
+	};
+
+	struct FGatheredKeyValue
+	{
+		TObjectKey<UBlackboardComponent> BlackboardComponent;
+		FBlackboard::FKey KeyID = FBlackboard::InvalidKey;
+		int32 IntValue = 0;
+		float FloatValue = 0.0f;
+		bool bIsValid = false;
+	};
+
+	const UFlowNode* FlowNode = nullptr;
+
+	TArray<FResolvedBlackboard, TInlineAllocator<2>> ResolvedBlackboards;
+	TArray<FGatheredKeyValue, TInlineAllocator<8>> GatheredKeyValues;
+
+	int32 NumSharedBlackboardResolves = 0;
+	int32 NumSharedKeyValues = 0;
+};
+
+// Opens an FAIFlowPredicateEvaluationContext for FlowNode's predicate evaluations, for the lifetime of the scope (game thread only)
+struct AIFLOW_API FAIFlowScopedPredicateEvaluationContext : public FNoncopyable
+{
+public:
+
+	explicit FAIFlowScopedPredicateEvaluationContext(const UFlowNode& FlowNode);
+	~FAIFlowScopedPredicateEvaluationContext();
+
+	FAIFlowPredicateEvaluationContext& GetContext() { return Context; }
+
+protected:
+
+	FAIFlowPredicateEvaluationContext Context;
+};
@@ -0,0 +1,8 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Stats/Stats.h"
+
+// Stats group for AIFlow runtime systems (use "stat AIFlow" to display)
+DECLARE_STATS_GROUP(TEXT("AIFlow"), STATGROUP_AIFlow, STATCAT_Advanced);
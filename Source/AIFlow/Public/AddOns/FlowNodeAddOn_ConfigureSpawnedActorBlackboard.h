@@ -24,12 +24,17 @@ public:
 
 	// IFlowPerSpawnedActorInterface
 	virtual void FinishedSpawningActor_Implementation(AActor* SpawnedActor, UFlowNodeBase* SpawningNodeOrAddOn) override;
+	virtual void FinishedSpawningActors(TArrayView<AActor* const> SpawnedActors, UFlowNodeBase* SpawningNodeOrAddOn) override;
 	// --
 
 	// UFlowNodeBase
 	virtual void UpdateNodeConfigText_Implementation() override;
 	// --
 
+	// UAIFlowNodeAddOn
+	virtual void ResetInstanceForReuse() override;
+	// --
+
 	// IBlackboardAssetProvider
 	virtual UBlackboardData* GetBlackboardAsset() const override;
 	// --
@@ -44,6 +49,16 @@ protected:
 
 	virtual UBlackboardComponent* TryEnsureBlackboardComponentToApplyTo(AActor* SpawnedActor, UFlowNodeBase* SpawningNodeOrAddOn);
 
+	// Find or add the blackboard component on the actor, with the component class (and the manager, if bMayInjectComponent) already resolved
+	UBlackboardComponent* FindOrAddBlackboardComponentOnSpawnedActor(AActor& SpawnedActor, TSubclassOf<UBlackboardComponent> BlackboardComponentClass, bool bMayInjectComponent);
+
+	// Queue the options for the spawned actors that represent Mass agents (see UAIFlowMassBlackboardSubsystem),
+	// removing them from InOutSpawnedActors.  Returns the number of Mass agents that the options were queued for.
+	int32 QueueBlackboardOptionsForMassAgents(TArray<AActor*>& InOutSpawnedActors);
+
+	// The BlackboardComponentClass to use when injecting (sourced from the AIFlowAsset, if there is one)
+	TSubclassOf<UBlackboardComponent> GetBlackboardComponentClassToInject() const;
+
 protected:
 
 	// Specify an explicit blackboard asset to write to
@@ -72,4 +87,7 @@ protected:
 	// Helper struct that shared functionality for manipulating Actor blackboards
 	UPROPERTY(EditAnywhere, Category = Configuration, meta = (ShowOnlyInnerProperties, DisplayPriority = 4))
 	FAIFlowActorBlackboardHelper ActorBlackboardHelper;
+
+	// Reused by FinishedSpawningActor_Implementation, so the per-actor path does not allocate an array for every spawned actor
+	TArray<AActor*> SpawnedActorScratch;
 };
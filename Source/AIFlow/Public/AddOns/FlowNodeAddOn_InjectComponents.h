@@ -8,6 +8,7 @@
 
 class UActorComponent;
 class UFlowInjectComponentsManager;
+class UAIFlowInjectionQueueSubsystem;
 
 // Inject a component on a spawned actor
 UCLASS(Blueprintable, meta = (DisplayName = "Inject Components"))
@@ -21,14 +22,43 @@ public:
 
 	// IFlowPerSpawnedActorInterface
 	void FinishedSpawningActor_Implementation(AActor* SpawnedActor, UFlowNodeBase* SpawningFlowNodeBase) override;
+	virtual void FinishedSpawningActors(TArrayView<AActor* const> SpawnedActors, UFlowNodeBase* SpawningFlowNodeBase) override;
+	// --
+
+	// IFlowCoreExecutableInterface
+	virtual void DeinitializeInstance() override;
 	// --
 
 	// UFlowNodeBase
 	virtual void UpdateNodeConfigText_Implementation() override;
 	// --
 
+	// Creates and injects the components on the Actor immediately
+	void InjectComponentsOnActorNow(AActor& SpawnedActor);
+
+	// Injects the components for a queued request, then finishes the spawned actor
+	// (called by the UAIFlowInjectionQueueSubsystem when servicing the request)
+	void FinishQueuedInjection(AActor& SpawnedActor, UFlowNodeBase* SpawningFlowNodeBase);
+
+protected:
+
+	// Creates and injects the components on the Actor with an already-resolved Manager
+	// (so that batches resolve the manager once, rather than per actor)
+	void InjectComponentsOnActorWithManager(AActor& SpawnedActor, UFlowInjectComponentsManager& Manager);
+
+	// The world's injection queue, if bUseInjectionQueue is set (and the queue exists)
+	UAIFlowInjectionQueueSubsystem* FindInjectionQueue() const;
+
+	bool HasComponentsToInject() const;
+
 protected:
 
 	UPROPERTY(EditAnywhere, Category = Configuration, meta = (ShowOnlyInnerProperties))
 	FFlowInjectComponentsHelper InjectComponentsHelper;
+
+	// Queue the injection with the world's UAIFlowInjectionQueueSubsystem,
+	// to spread the cost of injecting into many actors across multiple frames.
+	// Use UAIFlowInjectionQueueSubsystem::IsActorPendingInjection to check if an actor is still waiting for its components.
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay)
+	bool bUseInjectionQueue = false;
 };
@@ -45,6 +45,11 @@ protected:
 	virtual void OnStartMonitoringActor(AActor& Actor) { }
 	virtual void OnStopMonitoringActor(AActor& Actor) { }
 
+	// True if BatchingClass is this object's most-derived native class, so that no native subclass has customized the per-actor spawn path
+	// (blueprint overrides are already routed to the per-actor path by DispatchFinishedSpawningActors).
+	// Subclasses' batched FinishedSpawningActors fall back to the per-actor path if not.
+	bool CanUseBatchedSpawnPath(const UClass& BatchingClass) const;
+
 protected:
 
 	// Manager object to inject and remove components from actors
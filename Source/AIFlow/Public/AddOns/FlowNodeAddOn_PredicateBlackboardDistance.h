@@ -0,0 +1,119 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "AddOns/AIFlowNodeAddOn.h"
+#include "AIFlowActorBlackboardHelper.h"
+#include "Blackboard/AIFlowDistanceKernel.h"
+#include "Interfaces/FlowPredicateInterface.h"
+#include "Types/FlowBlackboardEntry.h"
+#include "Types/FlowEnumUtils.h"
+
+#include "FlowNodeAddOn_PredicateBlackboardDistance.generated.h"
+
+// Forward Declarations
+class UBlackboardComponent;
+class UBlackboardData;
+struct FAIFlowMassBlackboardFragment;
+
+// Source of the location that the distance predicate measures Key (A) against
+UENUM(BlueprintType)
+enum class EAIFlowDistanceOperandSource : uint8
+{
+	// A Vector key, or an Object key holding an Actor
+	BlackboardKey UMETA(DisplayName = "Blackboard Key"),
+
+	// The flow graph's owning actor
+	OwnerActor UMETA(DisplayName = "Flow Owner Actor"),
+
+	// An explicit world location
+	ExplicitLocation UMETA(DisplayName = "Explicit Location"),
+
+	Max UMETA(Hidden),
+	Invalid UMETA(Hidden),
+	Min = 0 UMETA(Hidden),
+};
+FLOW_ENUM_RANGE_VALUES(EAIFlowDistanceOperandSource);
+
+/**
+ * Predicate for the distance between a blackboard key's location (a Vector key, or an Object key holding an Actor)
+ * and another location (another key, the flow owner actor, or an explicit location), within or outside a radius.
+ * Distances are compared squared.  Predicates measured against an explicit location are batched (one query point, many agents)
+ * with FAIFlowDistanceBatch when they are evaluated through UAIFlowPredicateBatchSubsystem.
+ */
+UCLASS(MinimalApi, NotBlueprintable, meta = (DisplayName = "Blackboard Distance"))
+class UFlowNodeAddOn_PredicateBlackboardDistance
+	: public UAIFlowNodeAddOn
+	, public IFlowPredicateInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	UFlowNodeAddOn_PredicateBlackboardDistance();
+
+	// IFlowPredicateInterface
+	virtual bool EvaluatePredicate_Implementation() const override;
+	// --
+
+	// Batched evaluation support (see UAIFlowPredicateBatchSubsystem).  Only predicates measured against an Explicit Location
+	// can be batched, as that location is shared by all of the instances of the predicate.
+	bool CanEvaluateAsBatch() const { return SourceB == EAIFlowDistanceOperandSource::ExplicitLocation; }
+	AIFLOW_API FAIFlowCachedBlackboardReference ResolveBlackboardForEvaluation() const;
+
+	// Evaluate the predicate for each of BlackboardComponents (instances of BlackboardData) with FAIFlowDistanceBatch,
+	// returns false (without results) if the predicate cannot be batched for BlackboardData (eg, Key (A) is an Object key)
+	AIFLOW_API bool TryEvaluateBatch(const UBlackboardData& BlackboardData, TConstArrayView<const UBlackboardComponent*> BlackboardComponents, TArray<bool>& OutResults) const;
+
+#if WITH_EDITOR
+	// UFlowNodeBase
+	virtual FText K2_GetNodeTitle_Implementation() const override;
+	// --
+
+	// IFlowBlackboardAssetProvider
+	virtual UBlackboardData* GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const override;
+	// --
+#endif // WITH_EDITOR
+
+protected:
+
+	// Location of a Vector key (or the location of the Actor in an Object key)
+	bool TryGetKeyLocation(const UBlackboardComponent& BlackboardComponent, const FFlowBlackboardEntry& Key, FVector& OutLocation) const;
+	bool TryGetKeyLocation(const FAIFlowMassBlackboardFragment& MassBlackboardFragment, const FFlowBlackboardEntry& Key, FVector& OutLocation) const;
+
+	bool TryGetNonKeyLocationB(FVector& OutLocation) const;
+
+protected:
+
+	// Key whose location is measured (a Vector key, or an Object key holding an Actor)
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Key (A)")
+	FFlowBlackboardEntry KeyA;
+
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	EAIFlowDistanceCompare Compare = EAIFlowDistanceCompare::WithinRadius;
+
+	UPROPERTY(EditAnywhere, Category = Configuration, meta = (ClampMin = 0, Units = "Centimeters"))
+	float Radius = 500.0f;
+
+	// Where the location that Key (A) is measured against comes from
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Source (B)")
+	EAIFlowDistanceOperandSource SourceB = EAIFlowDistanceOperandSource::OwnerActor;
+
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Key (B)", meta = (EditCondition = "SourceB == EAIFlowDistanceOperandSource::BlackboardKey", EditConditionHides))
+	FFlowBlackboardEntry KeyB;
+
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Explicit Location (B)", meta = (EditCondition = "SourceB == EAIFlowDistanceOperandSource::ExplicitLocation", EditConditionHides))
+	FVector ExplicitLocationB = FVector::ZeroVector;
+
+	// Measure the distance in the XY plane only
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	bool bIgnoreZ = false;
+
+	// Specific blackboard to use for the keys
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard")
+	TObjectPtr<UBlackboardData> SpecificBlackboardAsset = nullptr;
+
+	// Search rule to use to find the "Specific Blackboard" (if specified)
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard Search Rule", meta = (EditCondition = "SpecificBlackboardAsset"))
+	EActorBlackboardSearchRule SpecificBlackboardSearchRule = EActorBlackboardSearchRule::ActorAndControllerAndGameState;
+};
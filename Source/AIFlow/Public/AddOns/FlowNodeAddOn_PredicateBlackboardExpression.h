@@ -0,0 +1,68 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "AddOns/AIFlowNodeAddOn.h"
+#include "AIFlowActorBlackboardHelper.h"
+#include "Blackboard/AIFlowBlackboardExpression.h"
+#include "Interfaces/FlowPredicateInterface.h"
+
+#include "FlowNodeAddOn_PredicateBlackboardExpression.generated.h"
+
+/**
+ * Predicate for a list of blackboard comparisons, combined with AND/OR/NOT (AND is evaluated before OR).
+ * Equivalent to a composition of Compare Blackboard Value predicates, but the blackboard is resolved once,
+ * and the clauses are compiled to a compact instruction stream that runs over the blackboard's raw key memory
+ * (see FAIFlowBlackboardExpressionProgram).
+ */
+UCLASS(MinimalApi, NotBlueprintable, meta = (DisplayName = "Blackboard Expression"))
+class UFlowNodeAddOn_PredicateBlackboardExpression
+	: public UAIFlowNodeAddOn
+	, public IFlowPredicateInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	UFlowNodeAddOn_PredicateBlackboardExpression();
+
+	// IFlowPredicateInterface
+	virtual bool EvaluatePredicate_Implementation() const override;
+	// --
+
+#if WITH_EDITOR
+	// UObject
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	// --
+
+	// UFlowNodeBase
+	virtual FText K2_GetNodeTitle_Implementation() const override;
+	// --
+
+	// IFlowBlackboardAssetProvider
+	virtual UBlackboardData* GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const override;
+	// --
+#endif // WITH_EDITOR
+
+protected:
+
+	// Compile the Clauses for BlackboardData (if they are not already compiled for it, or already failed to compile for it)
+	bool EnsureProgramCompiled(const UBlackboardData& BlackboardData) const;
+
+protected:
+
+	// Clauses of the expression (each joined to the clauses before it with AND or OR)
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	TArray<FAIFlowBlackboardExpressionClause> Clauses;
+
+	// Specific blackboard to use for the expression
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard")
+	TObjectPtr<UBlackboardData> SpecificBlackboardAsset = nullptr;
+
+	// Search rule to use to find the "Specific Blackboard" (if specified)
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard Search Rule", meta = (EditCondition = "SpecificBlackboardAsset"))
+	EActorBlackboardSearchRule SpecificBlackboardSearchRule = EActorBlackboardSearchRule::ActorAndControllerAndGameState;
+
+	// Compiled on first evaluation (the predicate interface is const)
+	mutable FAIFlowBlackboardExpressionProgram Program;
+};
@@ -0,0 +1,77 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "AddOns/AIFlowNodeAddOn.h"
+#include "AIFlowActorBlackboardHelper.h"
+#include "Interfaces/FlowPredicateInterface.h"
+#include "Types/FlowBlackboardEntry.h"
+#include "Types/FlowEnumUtils.h"
+
+#include "FlowNodeAddOn_PredicateBlackboardKeyAge.generated.h"
+
+// How a key's age (the time since it was last written) is compared to the threshold
+UENUM(BlueprintType)
+enum class EAIFlowKeyAgeCompare : uint8
+{
+	// Written within the last ThresholdSeconds
+	WrittenWithin UMETA(DisplayName = "Written Within"),
+
+	// Not written within the last ThresholdSeconds (including never written)
+	NotWrittenWithin UMETA(DisplayName = "Not Written Within"),
+
+	Max UMETA(Hidden),
+	Invalid UMETA(Hidden),
+	Min = 0 UMETA(Hidden),
+};
+FLOW_ENUM_RANGE_VALUES(EAIFlowKeyAgeCompare);
+
+/**
+ * Predicate for how recently a blackboard key was written (eg, "target location updated within 2s"),
+ * using the write times tracked by UAIFlowBlackboardKeyAgeSubsystem.
+ */
+UCLASS(MinimalApi, NotBlueprintable, meta = (DisplayName = "Blackboard Key Age"))
+class UFlowNodeAddOn_PredicateBlackboardKeyAge
+	: public UAIFlowNodeAddOn
+	, public IFlowPredicateInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	UFlowNodeAddOn_PredicateBlackboardKeyAge();
+
+	// IFlowPredicateInterface
+	virtual bool EvaluatePredicate_Implementation() const override;
+	// --
+
+#if WITH_EDITOR
+	// UFlowNodeBase
+	virtual FText K2_GetNodeTitle_Implementation() const override;
+	// --
+
+	// IFlowBlackboardAssetProvider
+	virtual UBlackboardData* GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const override;
+	// --
+#endif // WITH_EDITOR
+
+protected:
+
+	// Key whose age to test
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	FFlowBlackboardEntry Key;
+
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	EAIFlowKeyAgeCompare Compare = EAIFlowKeyAgeCompare::WrittenWithin;
+
+	UPROPERTY(EditAnywhere, Category = Configuration, meta = (ClampMin = 0.0, Units = "s"))
+	float ThresholdSeconds = 1.0f;
+
+	// Specific blackboard to use for the key
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard")
+	TObjectPtr<UBlackboardData> SpecificBlackboardAsset = nullptr;
+
+	// Search rule to use to find the "Specific Blackboard" (if specified)
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard Search Rule", meta = (EditCondition = "SpecificBlackboardAsset"))
+	EActorBlackboardSearchRule SpecificBlackboardSearchRule = EActorBlackboardSearchRule::ActorAndControllerAndGameState;
+};
@@ -0,0 +1,125 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "AddOns/AIFlowNodeAddOn.h"
+#include "AIFlowActorBlackboardHelper.h"
+#include "Interfaces/FlowPredicateInterface.h"
+#include "Types/ConfigurableEnumProperty.h"
+#include "Types/FlowBlackboardEntry.h"
+
+#include "FlowNodeAddOn_PredicateBlackboardValueInSet.generated.h"
+
+// Forward Declarations
+class UBlackboardKeyType;
+
+// Inclusive range of int values
+USTRUCT(BlueprintType)
+struct FAIFlowIntRange
+{
+	GENERATED_BODY()
+
+public:
+
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	int32 Min = 0;
+
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	int32 Max = 0;
+
+	bool Contains(int32 Value) const { return Value >= Min && Value <= Max; }
+};
+
+// Membership mask for the 256 possible (uint8) values of a blackboard enum key
+struct FAIFlowEnumValueMask
+{
+public:
+
+	void Reset() { FMemory::Memzero(Words); }
+	void Add(uint8 Value) { Words[Value >> 6] |= (1ull << (Value & 63)); }
+	bool Contains(uint8 Value) const { return (Words[Value >> 6] & (1ull << (Value & 63))) != 0; }
+
+protected:
+
+	uint64 Words[4] = { 0, 0, 0, 0 };
+};
+
+/**
+ * Predicate for an Enum key's value being one of a set of values, or an Int key's value being in one of a set of
+ * inclusive ranges.  Replaces an OR of Equal comparisons: the enum values are compiled to a 256-bit mask
+ * on first evaluation, so the test is a single bit test.
+ */
+UCLASS(MinimalApi, NotBlueprintable, meta = (DisplayName = "Blackboard Value In Set"))
+class UFlowNodeAddOn_PredicateBlackboardValueInSet
+	: public UAIFlowNodeAddOn
+	, public IFlowPredicateInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	UFlowNodeAddOn_PredicateBlackboardValueInSet();
+
+	// IFlowPredicateInterface
+	virtual bool EvaluatePredicate_Implementation() const override;
+	// --
+
+#if WITH_EDITOR
+	// UObject
+	virtual void PostInitProperties() override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	// --
+
+	// UFlowNodeBase
+	virtual FText K2_GetNodeTitle_Implementation() const override;
+	// --
+
+	// IFlowBlackboardAssetProvider
+	virtual UBlackboardData* GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const override;
+	// --
+#endif // WITH_EDITOR
+
+protected:
+
+	bool EvaluateRawKeyValue(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const;
+
+	// Build the EnumValueMask from the AllowedEnumValues (if it has not been built)
+	void EnsureEnumValueMaskBuilt() const;
+
+#if WITH_EDITOR
+	UBlackboardData* GetBlackboardAssetForEditor() const;
+
+	// Point the AllowedEnumValues at the Key's enum, so their values can be selected
+	void RefreshAllowedEnumValuesFromKey();
+#endif // WITH_EDITOR
+
+protected:
+
+	// Enum or Int key to test
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	FFlowBlackboardEntry Key;
+
+	// NOT the result (ie, "is not in set")
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "NOT")
+	bool bNot = false;
+
+	// Allowed values, for an Enum key
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	TArray<FConfigurableEnumProperty> AllowedEnumValues;
+
+	// Allowed (inclusive) ranges, for an Int key
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	TArray<FAIFlowIntRange> AllowedIntRanges;
+
+	// Specific blackboard to use for the key
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard")
+	TObjectPtr<UBlackboardData> SpecificBlackboardAsset = nullptr;
+
+	// Search rule to use to find the "Specific Blackboard" (if specified)
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard Search Rule", meta = (EditCondition = "SpecificBlackboardAsset"))
+	EActorBlackboardSearchRule SpecificBlackboardSearchRule = EActorBlackboardSearchRule::ActorAndControllerAndGameState;
+
+	// Built on first evaluation (the predicate interface is const)
+	mutable FAIFlowEnumValueMask EnumValueMask;
+	mutable bool bIsEnumValueMaskBuilt = false;
+};
@@ -10,6 +10,7 @@
 #include "GameplayTagContainer.h"
 #include "BehaviorTree/Blackboard/BlackboardKey.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyEnums.h"
+#include "BehaviorTree/BlackboardComponent.h"
 #include "Templates/SubclassOf.h"
 
 #include "FlowNodeAddOn_PredicateCompareBlackboardValue.generated.h"
@@ -19,7 +20,9 @@
 // Forward Declarations
 class UFlowBlackboardEntryValue;
 class UBlackboardKeyType;
+struct FAIFlowBlackboardExpressionClause;
 struct FAIFlowCachedBlackboardReference;
+struct FAIFlowMassBlackboardFragment;
 struct FBlackboardEntry;
 
 // Operator for UFlowNodeAddOn_PredicateCompareBlackboardValue's compare operation
@@ -84,10 +87,33 @@ public:
 
 	UFlowNodeAddOn_PredicateCompareBlackboardValue();
 
+	// UFlowNodeBase
+	virtual void DeinitializeInstance() override;
+	// --
+
 	// IFlowPredicateInterface
 	virtual bool EvaluatePredicate_Implementation() const override;
 	// --
 
+	// UAIFlowNodeAddOn
+	virtual void ResetInstanceForReuse() override;
+	// --
+
+	// Number of evaluations answered from the cached result (and the number that computed it), see bCacheResultWithObservers
+	int32 GetCachedResultHitCount() const { return CachedResultHitCount; }
+	int32 GetRecomputeCount() const { return RecomputeCount; }
+
+	// Batched evaluation support (see UAIFlowPredicateBatchSubsystem)
+	AIFLOW_API FAIFlowCachedBlackboardReference ResolveBlackboardForEvaluation() const;
+	AIFLOW_API FAIFlowBlackboardExpressionClause MakeExpressionClause() const;
+	bool IsCachingResultWithObservers() const { return bCacheResultWithObservers; }
+
+	// Number of result changes absorbed by the HysteresisMargin or MinimumHoldSeconds
+	int32 GetAbsorbedFlipCount() const { return AbsorbedFlipCount; }
+
+	// True if the result depends on the previous results (and so cannot be evaluated as a stateless expression clause)
+	bool HasStatefulResult() const { return HysteresisMargin > 0.0f || MinimumHoldSeconds > 0.0f; }
+
 #if WITH_EDITOR
 	// UObject
 	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
@@ -134,6 +160,28 @@ protected:
 		const FBlackboard::FKey LeftKeyID,
 		const FBlackboard::FKey RightKeyID) const;
 
+	// Mass agents (see UAIFlowMassBlackboardSubsystem) have no blackboard component,
+	// so the predicate is evaluated on the values in their blackboard fragment
+	bool EvaluatePredicateOnMassBlackboard(const FAIFlowMassBlackboardFragment& MassBlackboardFragment) const;
+
+	bool ComputePredicateResult(const FAIFlowCachedBlackboardReference& CachedBlackboard) const;
+
+	// Run an arithmetic TestWithRightValues, retesting against the exit threshold (see HysteresisMargin) if it fails while the result is true
+	bool TestArithmeticWithHysteresis(TFunctionRef<bool(int32 RightIntValue, float RightFloatValue)> TestWithRightValues, int32 RightIntValue, float RightFloatValue) const;
+
+	// Arithmetic compare of gathered numerical values, on floats for Float keys and on ints otherwise
+	// (as the blackboard key types' TestArithmeticOperation do)
+	bool TestArithmeticOnValues(bool bCompareAsFloat, int32 LeftIntValue, float LeftFloatValue, int32 RightIntValue, float RightFloatValue) const;
+
+	// Hold the previous result instead of ComputedResult, if it changed less than MinimumHoldSeconds ago
+	bool ApplyMinimumHoldTime(bool bComputedResult) const;
+
+	// Observe KeyLeft (and KeyRight) on BlackboardComponent, to invalidate the cached result when they change.
+	// Const, since the observers only manage the (mutable) cached result state.
+	bool TryObserveKeysForCachedResult(UBlackboardComponent& BlackboardComponent) const;
+	void StopObservingKeys() const;
+	EBlackboardNotificationResult OnObservedKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey ChangedKeyID) const;
+
 	FORCEINLINE static bool IsEqualityOperation(EPredicateCompareOperatorType Operation)
 	{
 		return
@@ -178,6 +226,37 @@ protected:
 	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard")
 	TObjectPtr<UBlackboardData> SpecificBlackboardAsset = nullptr;
 
+	// Cache the result, and only recompute it when a blackboard observer reports that KeyLeft (or KeyRight) has changed.
+	// Makes repeated evaluation (eg, by a gate or branch that polls) close to free while the keys are unchanged.
+	// Results from Mass agent blackboards (which cannot be observed) are not cached.
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Cache Result With Observers")
+	bool bCacheResultWithObservers = false;
+
+	// Cached result state (see bCacheResultWithObservers)
+	mutable TWeakObjectPtr<UBlackboardComponent> ObservedBlackboardComponent;
+	mutable bool bHasCachedResult = false;
+	mutable bool bCachedResult = false;
+
+	mutable int32 CachedResultHitCount = 0;
+	mutable int32 RecomputeCount = 0;
+
+	// For arithmetic operations, once the result is true it stays true until Key (left) is past the right-hand value by more than this margin
+	// (ie, separate enter and exit thresholds).  Eg, "Health < 30" with a margin of 5 becomes true below 30, and false again at 35 or above.
+	// Int and Enum keys use the margin rounded up.  0 to disable.
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, meta = (ClampMin = 0.0))
+	float HysteresisMargin = 0.0f;
+
+	// Minimum time (in world seconds) that a result is held for before it may change.  0 to disable.
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, meta = (ClampMin = 0.0, Units = "s"))
+	float MinimumHoldSeconds = 0.0f;
+
+	// Last reported result state (see HysteresisMargin and MinimumHoldSeconds)
+	mutable bool bHasLastResult = false;
+	mutable bool bLastResult = false;
+	mutable double LastResultChangeTime = 0.0;
+
+	mutable int32 AbsorbedFlipCount = 0;
+
 #if WITH_EDITORONLY_DATA
 	UPROPERTY(EditAnywhere, Category = Configuration, meta = (EditCondition = "bIsKeyLeftSelected && bIsKeyLeftSelected"))
 	bool bUseExplicitValueForRightHandSide = false;
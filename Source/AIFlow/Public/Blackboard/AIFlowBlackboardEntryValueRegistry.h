@@ -0,0 +1,54 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Templates/SharedPointer.h"
+#include "UObject/ObjectKey.h"
+#include "UObject/WeakObjectPtrTemplates.h"
+
+// Forward Declarations
+class UClass;
+
+/**
+ * Process-wide registry of the UFlowBlackboardEntryValue subclasses, and of which subclass supports each blackboard key type.
+ *
+ * The registry is published as an immutable snapshot (behind a read/write lock), so it can be read from any thread
+ * and by any number of worlds in the same process.  The snapshot is published once after engine init; loading or reloading
+ * modules only marks it dirty, and it is rebuilt lazily by the next GetSnapshot() on the game thread.
+ * Holders of an older snapshot continue to see a consistent view until they release their FSnapshotRef.
+ */
+class AIFLOW_API FAIFlowBlackboardEntryValueRegistry
+{
+public:
+
+	struct FSnapshot
+	{
+		// All of the (non-abstract) subclasses of UFlowBlackboardEntryValue
+		TArray<TWeakObjectPtr<UClass>> EntryValueSubclasses;
+
+		// The first UFlowBlackboardEntryValue subclass that supports each blackboard key type
+		TMap<TObjectKey<UClass>, TWeakObjectPtr<UClass>> EntryValueSubclassBySupportedKeyType;
+	};
+
+	using FSnapshotRef = TSharedRef<const FSnapshot, ESPMode::ThreadSafe>;
+
+	// Get the current snapshot (building it, if one has not been published yet or it is dirty and we are on the game thread)
+	static FSnapshotRef GetSnapshot();
+
+	// Returns the first found UFlowBlackboardEntryValue subclass that supports KeyTypeClass (or one of its superclasses)
+	static UClass* FindEntryValueSubclassForKeyType(const UClass* KeyTypeClass);
+
+	// Rebuild and publish a new snapshot (must be called on the game thread)
+	static void Republish();
+
+	// Mark the published snapshot as out of date, so the next GetSnapshot() on the game thread rebuilds it
+	static void MarkDirty();
+
+	// Register (and unregister) the republish callbacks, called by the AIFlow module
+	static void StartupRegistry();
+	static void ShutdownRegistry();
+
+protected:
+
+	static FSnapshotRef BuildSnapshot();
+};
@@ -0,0 +1,191 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "AddOns/FlowNodeAddOn_PredicateCompareBlackboardValue.h"
+#include "Types/FlowBlackboardEntry.h"
+#include "Types/FlowEnumUtils.h"
+
+#include "BehaviorTree/BehaviorTreeTypes.h"
+
+#include "AIFlowBlackboardExpression.generated.h"
+
+// Forward Declarations
+class UBlackboardData;
+class UBlackboardKeyType;
+class UFlowBlackboardEntryValue;
+
+// How a clause is combined with the clauses before it (AND is evaluated before OR)
+UENUM(BlueprintType)
+enum class EAIFlowBlackboardExpressionJoin : uint8
+{
+	And UMETA(DisplayName = "AND"),
+	Or UMETA(DisplayName = "OR"),
+
+	Max UMETA(Hidden),
+	Invalid UMETA(Hidden),
+	Min = 0 UMETA(Hidden),
+};
+FLOW_ENUM_RANGE_VALUES(EAIFlowBlackboardExpressionJoin);
+
+// One comparison in a blackboard expression: Key (left) Operator (Key (right) or Explicit Value (right))
+USTRUCT(BlueprintType)
+struct FAIFlowBlackboardExpressionClause
+{
+	GENERATED_BODY()
+
+public:
+
+	// How this clause is combined with the clauses before it (ignored for the first clause)
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	EAIFlowBlackboardExpressionJoin Join = EAIFlowBlackboardExpressionJoin::And;
+
+	// NOT the result of this clause's comparison
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "NOT")
+	bool bNot = false;
+
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Key (left)")
+	FFlowBlackboardEntry KeyLeft;
+
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Operator")
+	EPredicateCompareOperatorType OperatorType = EPredicateCompareOperatorType::Equal;
+
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	bool bUseExplicitValueForRightHandSide = false;
+
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Key (right)", meta = (EditCondition = "!bUseExplicitValueForRightHandSide"))
+	FFlowBlackboardEntry KeyRight;
+
+	UPROPERTY(EditAnywhere, Instanced, Category = Configuration, DisplayName = "Explicit Value (right)", meta = (EditCondition = "bUseExplicitValueForRightHandSide"))
+	TObjectPtr<UFlowBlackboardEntryValue> ExplicitValueRight = nullptr;
+};
+
+// How an instruction compares its operands' raw key memory
+enum class EAIFlowBlackboardExpressionValueKind : uint8
+{
+	// Bitwise (Bool)
+	Bytes,
+	// FName values (compared as names, not bitwise, since case-preserving names also store their display index)
+	Name,
+	Float,
+	Int,
+	// uint8 values (Enum, NativeEnum)
+	Enum,
+	Vector,
+	Rotator,
+};
+
+// One compiled clause
+struct FAIFlowBlackboardExpressionInstruction
+{
+	FBlackboard::FKey LeftKeyID = FBlackboard::InvalidKey;
+
+	// Right operand is either a key, or (if RightKeyID is InvalidKey) a value in the program's ConstantMemory
+	FBlackboard::FKey RightKeyID = FBlackboard::InvalidKey;
+	uint16 RightConstantOffset = 0;
+
+	uint16 ValueSize = 0;
+	EAIFlowBlackboardExpressionValueKind ValueKind = EAIFlowBlackboardExpressionValueKind::Bytes;
+	EPredicateCompareOperatorType OperatorType = EPredicateCompareOperatorType::Equal;
+	bool bNot = false;
+
+	// True for the last clause of an AND group (so the expression is true if this clause is)
+	bool bEndsGroup = false;
+
+	// Instruction to continue from if this clause is false (the first clause of the next OR group, or Num() for false)
+	uint16 NextGroupIndex = 0;
+};
+
+/**
+ * A blackboard expression (a list of clauses, combined with AND/OR/NOT) compiled for one blackboard asset.
+ *
+ * The clauses are compiled to a flat instruction stream in sum-of-products form (AND groups, OR-ed together)
+ * with the KeyIDs, value layouts and jump targets resolved, and the explicit values snapshotted into ConstantMemory.
+ * Execution reads the raw key memory of any source with GetKeyRawData(KeyID) (a UBlackboardComponent or
+ * an FAIFlowMassBlackboardFragment), short-circuits each AND group on its first false clause, and does not allocate.
+ * Only the plain-old-data key types are supported.
+ */
+struct AIFLOW_API FAIFlowBlackboardExpressionProgram
+{
+public:
+
+	// Compile Clauses for BlackboardData. On failure, OutError describes the first clause that could not be compiled.
+	bool Compile(const UBlackboardData& BlackboardData, TConstArrayView<FAIFlowBlackboardExpressionClause> Clauses, FString& OutError);
+
+	void Reset();
+
+	bool IsCompiledFor(const UBlackboardData& BlackboardData) const { return bIsCompiled && CompiledForBlackboardData.Get() == &BlackboardData; }
+
+	// Did the last Compile for BlackboardData fail (and the blackboard keys have not changed since)?
+	bool HasFailedToCompileFor(const UBlackboardData& BlackboardData) const;
+
+	int32 GetNumInstructions() const { return Instructions.Num(); }
+
+	// The compiled instructions and explicit values (eg, for batched evaluation of single-clause programs)
+	TConstArrayView<FAIFlowBlackboardExpressionInstruction> GetInstructions() const { return Instructions; }
+	const uint8* GetConstantMemory(uint16 ConstantOffset) const { return ConstantMemory.GetData() + ConstantOffset; }
+
+	// Run the program over the raw key memory of RawKeyMemorySource (an empty expression is true)
+	template <typename TRawKeyMemorySource>
+	bool Execute(const TRawKeyMemorySource& RawKeyMemorySource) const;
+
+protected:
+
+	bool CompileClauses(const UBlackboardData& BlackboardData, TConstArrayView<FAIFlowBlackboardExpressionClause> Clauses, FString& OutError);
+
+	static bool TryClassifyKeyType(const UBlackboardKeyType& KeyType, EAIFlowBlackboardExpressionValueKind& OutValueKind);
+	bool ExecuteInstruction(const FAIFlowBlackboardExpressionInstruction& Instruction, const uint8* LeftMemory, const uint8* RightMemory) const;
+
+protected:
+
+	TArray<FAIFlowBlackboardExpressionInstruction> Instructions;
+
+	// Snapshotted explicit values (each aligned to its size, up to 8 bytes)
+	TArray<uint8> ConstantMemory;
+
+	TWeakObjectPtr<const UBlackboardData> CompiledForBlackboardData;
+	bool bIsCompiled = false;
+
+	// The blackboard (and key table generation) that the last Compile failed for, so it is not retried every evaluation
+	TWeakObjectPtr<const UBlackboardData> FailedForBlackboardData;
+	uint32 FailedForKeyTableGeneration = 0;
+};
+
+template <typename TRawKeyMemorySource>
+bool FAIFlowBlackboardExpressionProgram::Execute(const TRawKeyMemorySource& RawKeyMemorySource) const
+{
+	if (Instructions.IsEmpty())
+	{
+		return true;
+	}
+
+	int32 InstructionIndex = 0;
+	while (InstructionIndex < Instructions.Num())
+	{
+		const FAIFlowBlackboardExpressionInstruction& Instruction = Instructions[InstructionIndex];
+
+		const uint8* LeftMemory = RawKeyMemorySource.GetKeyRawData(Instruction.LeftKeyID);
+		const uint8* RightMemory =
+			Instruction.RightKeyID != FBlackboard::InvalidKey ?
+				RawKeyMemorySource.GetKeyRawData(Instruction.RightKeyID) :
+				ConstantMemory.GetData() + Instruction.RightConstantOffset;
+
+		const bool bClauseResult = (LeftMemory && RightMemory) ? ExecuteInstruction(Instruction, LeftMemory, RightMemory) : false;
+
+		if (bClauseResult)
+		{
+			if (Instruction.bEndsGroup)
+			{
+				return true;
+			}
+
+			++InstructionIndex;
+		}
+		else
+		{
+			InstructionIndex = Instruction.NextGroupIndex;
+		}
+	}
+
+	return false;
+}
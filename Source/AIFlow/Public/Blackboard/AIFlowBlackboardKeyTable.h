@@ -0,0 +1,77 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "BehaviorTree/BlackboardData.h"
+#include "Containers/ArrayView.h"
+#include "Templates/SharedPointer.h"
+
+// Forward Declarations
+class UBlackboardKeyType;
+class FAIFlowBlackboardKeyTable;
+
+using FAIFlowBlackboardKeyTableRef = TSharedRef<const FAIFlowBlackboardKeyTable, ESPMode::ThreadSafe>;
+
+// One key in a flattened blackboard key table.
+// The KeyType is owned by the blackboard data, so it is only valid until the blackboard's keys are changed.
+struct FAIFlowBlackboardKeyTableEntry
+{
+	FName KeyName = NAME_None;
+	FBlackboard::FKey KeyID = FBlackboard::InvalidKey;
+	UBlackboardKeyType* KeyType = nullptr;
+};
+
+/**
+ * Flattened view of a blackboard's keys (including the keys of all of its Parent blackboards),
+ * with an open-addressing hash from key name to KeyID and key type.
+ *
+ * Tables are built on first use, cached per UBlackboardData and discarded whenever blackboard keys are changed
+ * (key updates, property edits, undo/redo and hot reload).  The cache is guarded by a read/write lock
+ * and a table is immutable once published, so lookups are safe from any thread.
+ * Hold the returned reference (rather than the table's entries) for as long as the entries are used,
+ * and do not keep it beyond the current scope (an invalidated table is not rebuilt for its holders,
+ * so its KeyTypes may be stale once the blackboard's keys have changed).
+ */
+class AIFLOW_API FAIFlowBlackboardKeyTable
+{
+public:
+
+	// Get (building, if necessary) the cached key table for BlackboardData
+	static FAIFlowBlackboardKeyTableRef Get(const UBlackboardData& BlackboardData);
+
+	// Discard all of the cached key tables (they will be rebuilt on their next use)
+	static void InvalidateAll();
+
+	// Discard the cached key tables of BlackboardData and of the blackboards that derive from it (its keys have changed)
+	static void Invalidate(const UBlackboardData& BlackboardData);
+
+	// Incremented by InvalidateAll and Invalidate (eg, to tell whether a result derived from a blackboard's keys may be out of date)
+	static uint32 GetGeneration();
+
+	// Register (and unregister) the invalidation callbacks, called by the AIFlow module
+	static void StartupKeyTables();
+	static void ShutdownKeyTables();
+
+	const FAIFlowBlackboardKeyTableEntry* FindEntry(const FName& KeyName) const;
+
+	FBlackboard::FKey FindKeyID(const FName& KeyName) const;
+	UBlackboardKeyType* FindKeyType(const FName& KeyName) const;
+
+	// All of the keys, in the blackboard's search order (a blackboard's keys before its Parent's keys)
+	TConstArrayView<FAIFlowBlackboardKeyTableEntry> GetEntries() const { return Entries; }
+
+protected:
+
+	void Build(const UBlackboardData& BlackboardData);
+
+	int32 FindEntryIndex(const FName& KeyName) const;
+
+protected:
+
+	TArray<FAIFlowBlackboardKeyTableEntry> Entries;
+
+	// Open-addressing (linear probing) slots, holding indices into Entries (INDEX_NONE for empty slots).
+	// Sized to a power of two, at least twice the number of Entries.
+	TArray<int32> Slots;
+	uint32 SlotMask = 0;
+};
@@ -0,0 +1,42 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "BehaviorTree/BlackboardComponent.h"
+
+#include "AIFlowColumnarBlackboardComponent.generated.h"
+
+/**
+ * Blackboard component whose Float, Int and Bool keys are mirrored into the world's UAIFlowColumnarBlackboardSubsystem,
+ * for bulk operations across every agent that uses the same blackboard asset.
+ *
+ * Opt-in for a flow via its BlackboardComponentClass (see UAIFlowAsset::GetBlackboardComponentClass).
+ * The component API (GetValue/SetValue, observers, etc.) works as usual.
+ */
+UCLASS(ClassGroup = AI, meta = (BlueprintSpawnableComponent))
+class AIFLOW_API UAIFlowColumnarBlackboardComponent : public UBlackboardComponent
+{
+	GENERATED_BODY()
+
+public:
+
+	// UActorComponent
+	virtual void BeginPlay() override;
+	virtual void OnUnregister() override;
+	// --
+
+	// Register with (or move between) the world's columnar stores, to match the current blackboard asset.
+	// Call after (re-)initializing the blackboard with InitializeBlackboard.
+	void SyncColumnarStoreRegistration();
+
+	bool IsRegisteredWithColumnarStore() const { return RegisteredBlackboardAsset.IsValid(); }
+
+protected:
+
+	void UnregisterFromColumnarStore();
+
+protected:
+
+	// The blackboard asset whose columnar store this component is registered with
+	TWeakObjectPtr<const UBlackboardData> RegisteredBlackboardAsset;
+};
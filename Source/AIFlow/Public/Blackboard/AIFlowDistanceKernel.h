@@ -0,0 +1,63 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Types/FlowEnumUtils.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+
+#include "AIFlowDistanceKernel.generated.h"
+
+// Forward Declarations
+class UBlackboardComponent;
+
+// Distance comparison for the blackboard distance predicate (and FAIFlowDistanceBatch)
+UENUM(BlueprintType)
+enum class EAIFlowDistanceCompare : uint8
+{
+	WithinRadius UMETA(DisplayName = "Is Within Radius"),
+	OutsideRadius UMETA(DisplayName = "Is Outside Radius"),
+
+	Max UMETA(Hidden),
+	Invalid UMETA(Hidden),
+	Min = 0 UMETA(Hidden),
+};
+FLOW_ENUM_RANGE_VALUES(EAIFlowDistanceCompare);
+
+/**
+ * Batched radius test of one query point against many locations (eg, many agents' Vector keys).
+ *
+ * The locations are gathered as float offsets from the query point (rebased in double precision,
+ * so that large world coordinates keep their precision) in structure-of-arrays form,
+ * then tested four at a time with squared-distance vector math.  Invalid locations (eg, unset Vector keys)
+ * fail both the within and outside radius tests.
+ */
+struct AIFLOW_API FAIFlowDistanceBatch
+{
+public:
+
+	void Reset(const FVector& InQueryPoint, int32 ExpectedNum = 0);
+
+	// Add a location to test, returning its index in the results
+	int32 AddLocation(const FVector& Location);
+	int32 AddInvalidLocation();
+
+	// Add VectorKeyID's value on each of the BlackboardComponents (null components are added as invalid locations)
+	void AddBlackboardVectorKeys(TConstArrayView<const UBlackboardComponent*> BlackboardComponents, FBlackboard::FKey VectorKeyID);
+
+	int32 Num() const { return OffsetsX.Num(); }
+
+	// Test every added location, OutResults[Index] is the result for the location added at Index
+	void Test(EAIFlowDistanceCompare Compare, double Radius, bool bIgnoreZ, TArray<bool>& OutResults) const;
+
+	// Single-pair version of the test (for unbatched evaluation)
+	static bool TestPair(const FVector& LocationA, const FVector& LocationB, EAIFlowDistanceCompare Compare, double Radius, bool bIgnoreZ);
+
+protected:
+
+	FVector QueryPoint = FVector::ZeroVector;
+
+	TArray<float> OffsetsX;
+	TArray<float> OffsetsY;
+	TArray<float> OffsetsZ;
+	TArray<bool> IsValidLocation;
+};
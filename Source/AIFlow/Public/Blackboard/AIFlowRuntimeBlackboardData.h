@@ -0,0 +1,42 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "BehaviorTree/BlackboardData.h"
+#include "Containers/ArrayView.h"
+
+/**
+ * Registry of runtime-extended blackboard data (a base blackboard plus keys added at runtime),
+ * deduplicated by content so that flow instances that add the same keys share one UBlackboardData.
+ *
+ * The registry only holds weak references, the shared blackboard data is kept alive by the instances using it.
+ * The registry is process-wide (shared by all worlds) and must only be used from the game thread.
+ * Instances that need to modify their runtime blackboard data must clone it first (see UAIFlowAsset::DivergeRuntimeBlackboardData).
+ */
+class AIFLOW_API FAIFlowRuntimeBlackboardDataRegistry
+{
+public:
+
+	// Find the shared runtime blackboard data for BaseBlackboardData extended by RuntimeKeys, creating it if necessary
+	static UBlackboardData* FindOrCreateShared(UBlackboardData& BaseBlackboardData, TConstArrayView<FBlackboardEntry> RuntimeKeys);
+
+	// Create (unshared) runtime blackboard data for BaseBlackboardData extended by RuntimeKeys
+	static UBlackboardData* CreateUnshared(UObject& Outer, UBlackboardData& BaseBlackboardData, TConstArrayView<FBlackboardEntry> RuntimeKeys);
+
+	// Create an unshared copy of SourceBlackboardData (eg, when an instance diverges from the shared version)
+	static UBlackboardData* CloneUnshared(UObject& Outer, const UBlackboardData& SourceBlackboardData);
+
+	// Is BlackboardData owned by this registry (and so must not be modified)?
+	static bool IsShared(const UBlackboardData& BlackboardData);
+
+	// Number of shared runtime blackboard data objects that are currently alive
+	static int32 GetNumShared();
+
+	// Finalize the keys after the Parent or Keys have been changed
+	static void UpdateRuntimeKeys(UBlackboardData& RuntimeBlackboardData);
+
+protected:
+
+	// Content signature of BaseBlackboardData extended by RuntimeKeys (key names, key types and their configured values)
+	static FString BuildContentSignature(const UBlackboardData& BaseBlackboardData, TConstArrayView<FBlackboardEntry> RuntimeKeys);
+};
@@ -47,6 +47,12 @@ public:
 	// Uses the data in this UFlowBlackboardEntryValue to set the matching key's value on the given blackboard
 	virtual void SetOnBlackboardComponent(UBlackboardComponent* BlackboardComponent) const PURE_VIRTUAL(SetOnBlackboardComponent);
 
+	// Version of SetOnBlackboardComponent that uses an already resolved KeyID (for Key) rather than looking it up by name.
+	// Used when the KeyIDs for many writes are resolved up-front (eg, once per blackboard asset for a batch of components),
+	// and only the writes remain.  The batched writes call this directly, so it is the override point for the write:
+	// the built-in value classes implement it (and SetOnBlackboardComponent, which is final for them, forwards to it).
+	virtual void SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const { SetOnBlackboardComponent(&BlackboardComponent); }
+
 	// Compares the value contained in this object vs. the given key's value on the blackboard,
 	// similar to UBlackboardComponent::CompareKeyValues()
 	virtual EBlackboardCompare::Type CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const PURE_VIRTUAL(CompareKeyValues, return EBlackboardCompare::NotEqual;);
@@ -61,6 +67,13 @@ public:
 	// Set this UFlowBlackboardEntryValue's value to the value from a Data Pin, resolved by PinOwnerFlowNode
 	virtual bool TrySetValueFromInputDataPin(const FName& PinName, UFlowNode& PinOwnerFlowNode) PURE_VIRTUAL(TrySetValueFromInputDataPin, return false;);
 
+	// Raw key memory versions of the blackboard functions, for blackboards that are not UBlackboardComponents
+	// (eg, FAIFlowMassBlackboardFragment), where RawKeyMemory is laid out as it is for KeyType in a UBlackboardComponent.
+	// Only the plain-old-data value types support raw key memory (the defaults fail).
+	virtual bool TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const { return false; }
+	virtual EBlackboardCompare::Type CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const { return EBlackboardCompare::NotEqual; }
+	virtual bool TryProvideFlowDataPinPropertyFromRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory, TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const { return false; }
+
 #if WITH_EDITOR
 	// Does this class support arithmetic compare operations (of the form EArithmeticCompare) and 
 	// thus supports TryGetNumericalValuesForArithmeticOperation ?
@@ -104,8 +117,8 @@ public:
 		UBlackboardComponent* OptionalBlackboardComponent,
 		TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const PURE_VIRTUAL(TryProvideFlowDataPinPropertyFromBlackboardEntry, return false;);
 
-	// Ensures the CachedBlackboardEntryValueSubclassArray has been cached and returns its value
-	static const TArray<TWeakObjectPtr<UClass>>& EnsureBlackboardEntryValueSubclassArray();
+	// Returns a copy of all of the subclasses of UFlowBlackboardEntryValue (from FAIFlowBlackboardEntryValueRegistry's current snapshot)
+	static TArray<TWeakObjectPtr<UClass>> EnsureBlackboardEntryValueSubclassArray();
 
 protected:
 
@@ -132,15 +145,57 @@ protected:
 		return false;
 	}
 
+	// Template worker functions for the raw key memory functions
+	template <typename TBlackboardEntryType>
+	static bool TryApplyToRawKeyMemoryTemplate(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory, const typename TBlackboardEntryType::FDataType& Value)
+	{
+		if (RawKeyMemory && KeyType.IsA<TBlackboardEntryType>())
+		{
+			// The static SetValue only writes to RawKeyMemory (the key type is non-const for the instanced key types)
+			TBlackboardEntryType::SetValue(const_cast<TBlackboardEntryType*>(static_cast<const TBlackboardEntryType*>(&KeyType)), RawKeyMemory, Value);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	template <typename TBlackboardEntryType>
+	static bool TryGetValueFromRawKeyMemoryTemplate(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory, typename TBlackboardEntryType::FDataType& OutValue)
+	{
+		if (RawKeyMemory && KeyType.IsA<TBlackboardEntryType>())
+		{
+			OutValue = TBlackboardEntryType::GetValue(static_cast<const TBlackboardEntryType*>(&KeyType), RawKeyMemory);
+
+			return true;
+		}
+
+		return false;
+	}
+
+	template <typename TBlackboardEntryType, typename TFlowDataPinOutputPropertyType>
+	static bool TryProvideFlowDataPinPropertyFromRawKeyMemoryTemplate(
+		const UBlackboardKeyType& KeyType,
+		const uint8* RawKeyMemory,
+		TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty)
+	{
+		typename TBlackboardEntryType::FDataType Value;
+		if (TryGetValueFromRawKeyMemoryTemplate<TBlackboardEntryType>(KeyType, RawKeyMemory, Value))
+		{
+			OutFlowDataPinProperty.InitializeAs<TFlowDataPinOutputPropertyType>(Value);
+
+			return true;
+		}
+
+		return false;
+	}
+
 public:
 
 	// Target blackboard key for this entry to set
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = Configuration, meta = (EditCondition = "KeyVisibility == EFlowBlackboardEntryValueKeyVisibility::Visible", EditConditionHides))
 	FFlowBlackboardEntry Key;
 
-	// Cached array of all of the subclasses of UFlowBlackboardEntryValue
-	static TArray<TWeakObjectPtr<UClass>> CachedBlackboardEntryValueSubclassArray;
-
 #if WITH_EDITORONLY_DATA
 	// Used to control visibility of Key property
 	// (in some use-cases, we only want to use the value portion of the FFlowBlackboardEntry, 
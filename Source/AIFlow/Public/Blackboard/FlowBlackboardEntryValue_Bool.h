@@ -17,10 +17,14 @@ class AIFLOW_API UFlowBlackboardEntryValue_Bool : public UFlowBlackboardEntryVal
 public:
 
 	//~Begin UFlowBlackboardEntryValue
-	virtual void SetOnBlackboardComponent(UBlackboardComponent* BlackboardComponent) const override;
+	virtual void SetOnBlackboardComponent(UBlackboardComponent* BlackboardComponent) const override final;
+	virtual void SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const override;
 	virtual EBlackboardCompare::Type CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const override;
 	virtual TSubclassOf<UBlackboardKeyType> GetSupportedBlackboardKeyType() const override;
 	virtual bool TrySetValueFromInputDataPin(const FName& PinName, UFlowNode& PinOwnerFlowNode) override;
+	virtual bool TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const override;
+	virtual EBlackboardCompare::Type CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const override;
+	virtual bool TryProvideFlowDataPinPropertyFromRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory, TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const override;
 #if WITH_EDITOR
 	virtual FString GetEditorValueString() const override;
 #endif // WITH_EDITOR
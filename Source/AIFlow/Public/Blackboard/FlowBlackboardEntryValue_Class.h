@@ -17,7 +17,8 @@ class UFlowBlackboardEntryValue_Class : public UFlowBlackboardEntryValue
 public:
 
 	//~Begin UFlowBlackboardEntryValue
-	virtual void SetOnBlackboardComponent(UBlackboardComponent* BlackboardComponent) const override;
+	virtual void SetOnBlackboardComponent(UBlackboardComponent* BlackboardComponent) const override final;
+	virtual void SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const override;
 	virtual EBlackboardCompare::Type CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const override;
 	virtual TSubclassOf<UBlackboardKeyType> GetSupportedBlackboardKeyType() const override;
 	virtual bool TrySetValueFromInputDataPin(const FName& PinName, UFlowNode& PinOwnerFlowNode) override;
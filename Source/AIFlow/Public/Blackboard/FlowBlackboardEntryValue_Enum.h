@@ -21,10 +21,14 @@ class UFlowBlackboardEntryValue_Enum : public UFlowBlackboardEntryValue
 public:
 
 	//~Begin UFlowBlackboardEntryValue
-	virtual void SetOnBlackboardComponent(UBlackboardComponent* BlackboardComponent) const override;
+	virtual void SetOnBlackboardComponent(UBlackboardComponent* BlackboardComponent) const override final;
+	virtual void SetOnBlackboardComponentWithKeyID(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID) const override;
 	virtual EBlackboardCompare::Type CompareKeyValues(const UBlackboardComponent* BlackboardComponent, const FName& OtherKeyName) const override;
 	virtual TSubclassOf<UBlackboardKeyType> GetSupportedBlackboardKeyType() const override;
 	virtual bool TrySetValueFromInputDataPin(const FName& PinName, UFlowNode& PinOwnerFlowNode) override;
+	virtual bool TryApplyToRawKeyMemory(const UBlackboardKeyType& KeyType, uint8* RawKeyMemory) const override;
+	virtual EBlackboardCompare::Type CompareRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory) const override;
+	virtual bool TryProvideFlowDataPinPropertyFromRawKeyMemory(const UBlackboardKeyType& KeyType, const uint8* RawKeyMemory, TInstancedStruct<FFlowDataPinValue>& OutFlowDataPinProperty) const override;
 	virtual bool TryGetNumericalValuesForArithmeticOperation(int32* OutIntValue, float* OutFloatValue) const override;
 #if WITH_EDITOR
 	virtual bool SupportsArithmeticOperations() const override { return true; }
@@ -2,6 +2,7 @@
  
 #pragma once
 
+#include "Containers/ArrayView.h"
 #include "UObject/Interface.h"
 
 #include "FlowPerSpawnedActorInterface.generated.h"
@@ -27,6 +28,19 @@ public:
 	void FinishedSpawningActor(AActor* SpawnedActor, UFlowNodeBase* SpawningNodeOrAddOn);
 	virtual void FinishedSpawningActor_Implementation(AActor* SpawnedActor, UFlowNodeBase* SpawningNodeOrAddOn) { }
 
+	// Batched version of FinishedSpawningActor, for spawners that finish spawning a group of actors at once (eg, waves).
+	// The default implementation forwards to FinishedSpawningActor for each actor,
+	// subclasses may override to hoist work that is invariant across the batch.
+	virtual void FinishedSpawningActors(TArrayView<AActor* const> SpawnedActors, UFlowNodeBase* SpawningNodeOrAddOn);
+
+	// Dispatches a batch of spawned actors to an object implementing this interface,
+	// using the native batch entry point if available, or the per-actor (possibly blueprint) version otherwise.
+	static void DispatchFinishedSpawningActors(UObject* Implementer, TArrayView<AActor* const> SpawnedActors, UFlowNodeBase* SpawningNodeOrAddOn);
+
+	// Function called by the flow node or addon that spawned a batch of actors, to dispatch the batch to its per-spawned actor AddOns
+	// (with DispatchFinishedSpawningActors), and then FinishedSpawningActorFromFlow to the actors and their components.
+	static void DispatchFinishedSpawningActorsToAddOnsAndActors(UFlowNodeBase& SpawningNodeOrAddOn, TArrayView<AActor* const> SpawnedActors);
+
 	static bool ImplementsInterfaceSafe(const UFlowNodeAddOn* AddOnTemplate);
 };
 
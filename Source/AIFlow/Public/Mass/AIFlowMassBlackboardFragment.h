@@ -0,0 +1,106 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "MassEntityTypes.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+
+#include "AIFlowMassBlackboardFragment.generated.h"
+
+// Forward Declarations
+class UBlackboardKeyType;
+
+/**
+ * Mass fragment holding the values of a blackboard (including its Parent blackboards' keys),
+ * for Mass agents that do not have a UBlackboardComponent.
+ *
+ * Each key's value is stored exactly as a UBlackboardComponent stores it (indexed by KeyID),
+ * so the blackboard key types' static GetValue/SetValue (and UFlowBlackboardEntryValue's raw key memory functions)
+ * work on it unchanged.  Only the plain-old-data key types (Bool, Int, Float, Enum, Name, Vector and Rotator)
+ * are supported; the other keys are given no storage.
+ *
+ * AI flow nodes do not write the fragment directly, they queue writes with UAIFlowMassBlackboardSubsystem,
+ * which UAIFlowMassBlackboardWriteProcessor applies during Mass processing.
+ */
+USTRUCT()
+struct AIFLOW_API FAIFlowMassBlackboardFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+public:
+
+	// (Re)build the value layout for BlackboardData, with every value reset to its key type's initial value
+	bool InitializeFromBlackboardData(const UBlackboardData& InBlackboardData);
+
+	bool IsInitialized() const { return BlackboardData.IsValid(); }
+	const UBlackboardData* GetBlackboardData() const { return BlackboardData.Get(); }
+
+	FBlackboard::FKey GetKeyID(const FName& KeyName) const;
+	const UBlackboardKeyType* GetKeyType(FBlackboard::FKey KeyID) const;
+
+	// Size of the key's value (0 for keys that have no storage)
+	uint16 GetKeyValueSize(FBlackboard::FKey KeyID) const { return ValueSizes.IsValidIndex(KeyID) ? ValueSizes[KeyID] : 0; }
+
+	// Raw memory for the key's value (null for keys that have no storage)
+	const uint8* GetKeyRawData(FBlackboard::FKey KeyID) const;
+	uint8* GetKeyRawData(FBlackboard::FKey KeyID) { return const_cast<uint8*>(static_cast<const FAIFlowMassBlackboardFragment*>(this)->GetKeyRawData(KeyID)); }
+
+	// Typed access, as UBlackboardComponent::GetValue/SetValue
+	template <class TDataClass>
+	typename TDataClass::FDataType GetValue(FBlackboard::FKey KeyID) const;
+
+	template <class TDataClass>
+	bool SetValue(FBlackboard::FKey KeyID, typename TDataClass::FDataType Value);
+
+	// Compare the values of two keys of the same type (bitwise, as the supported key types are plain-old-data)
+	EBlackboardCompare::Type CompareKeyValues(FBlackboard::FKey KeyA, FBlackboard::FKey KeyB) const;
+
+	// Value of a Float, Int or Enum key, for arithmetic comparisons (Int and Enum values are provided as both)
+	bool TryGetNumericalValue(FBlackboard::FKey KeyID, int32& OutIntValue, float& OutFloatValue) const;
+
+protected:
+
+	TWeakObjectPtr<const UBlackboardData> BlackboardData;
+
+	// Values for all of the keys, at ValueOffsets[KeyID] (each aligned to its size, up to 8 bytes)
+	TArray<uint8> ValueMemory;
+	TArray<uint16> ValueOffsets;
+	TArray<uint16> ValueSizes;
+};
+
+template <>
+struct TMassFragmentTraits<FAIFlowMassBlackboardFragment> final
+{
+	enum
+	{
+		AuthorAcceptsItsNotTriviallyCopyable = true
+	};
+};
+
+template <class TDataClass>
+typename TDataClass::FDataType FAIFlowMassBlackboardFragment::GetValue(FBlackboard::FKey KeyID) const
+{
+	const UBlackboardKeyType* KeyType = GetKeyType(KeyID);
+	const uint8* RawData = GetKeyRawData(KeyID);
+	if (!RawData || !KeyType || KeyType->GetClass() != TDataClass::StaticClass())
+	{
+		return TDataClass::InvalidValue;
+	}
+
+	return TDataClass::GetValue(static_cast<const TDataClass*>(KeyType), RawData);
+}
+
+template <class TDataClass>
+bool FAIFlowMassBlackboardFragment::SetValue(FBlackboard::FKey KeyID, typename TDataClass::FDataType Value)
+{
+	const UBlackboardKeyType* KeyType = GetKeyType(KeyID);
+	uint8* RawData = GetKeyRawData(KeyID);
+	if (!RawData || !KeyType || KeyType->GetClass() != TDataClass::StaticClass())
+	{
+		return false;
+	}
+
+	// The static SetValue only writes to RawData
+	return TDataClass::SetValue(const_cast<TDataClass*>(static_cast<const TDataClass*>(KeyType)), RawData, Value);
+}
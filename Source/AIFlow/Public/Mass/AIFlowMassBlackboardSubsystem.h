@@ -0,0 +1,106 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "MassEntityHandle.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+#include "Engine/TimerHandle.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "AIFlowMassBlackboardSubsystem.generated.h"
+
+// Forward Declarations
+class AActor;
+class UBlackboardData;
+class UFlowBlackboardEntryValue;
+struct FAIFlowMassBlackboardFragment;
+struct FMassEntityManager;
+
+// A blackboard value queued for a Mass entity, snapshotted when it was queued
+struct FAIFlowMassPendingBlackboardWrite
+{
+	FBlackboard::FKey KeyID = FBlackboard::InvalidKey;
+	TArray<uint8, TInlineAllocator<16>> Value;
+};
+
+/**
+ * Per-world bridge between the AIFlow blackboard nodes and Mass entities with an FAIFlowMassBlackboardFragment.
+ *
+ * The AIFlow nodes work with actors, so a Mass agent is addressed through the actor that represents it
+ * (bound with BindActorToEntity, eg, by the game's Mass actor representation or spawner code).
+ *
+ * Writes are queued here (in the order the nodes made them) and applied by UAIFlowMassBlackboardWriteProcessor,
+ * in chunk order, during Mass processing.  Reads (GetBlackboardValues, the compare predicate) see the fragment,
+ * so they do not see queued writes until the processor has run.
+ */
+UCLASS()
+class AIFLOW_API UAIFlowMassBlackboardSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// USubsystem
+	virtual void Deinitialize() override;
+	// --
+
+	// UWorldSubsystem
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	// --
+
+	// Bind (or unbind) the actor that represents a Mass entity, for the AIFlow nodes that address agents by actor
+	void BindActorToEntity(const AActor& Actor, FMassEntityHandle Entity);
+	void UnbindActor(const AActor& Actor);
+	FMassEntityHandle FindEntityForActor(const AActor* Actor) const;
+
+	// Add (or re-initialize) the entity's blackboard fragment for BlackboardData.
+	// A newly added fragment is added with a deferred command, so it is available after the Mass command buffer is flushed.
+	bool InitializeEntityBlackboard(FMassEntityHandle Entity, const UBlackboardData& BlackboardData);
+
+	// As InitializeEntityBlackboard, but leaves an entity that already has a blackboard (for any BlackboardData) untouched
+	bool EnsureEntityBlackboard(FMassEntityHandle Entity, const UBlackboardData& BlackboardData);
+
+	// Blackboard data that the entity's fragment was (or is about to be) initialized for
+	const UBlackboardData* FindEntityBlackboardData(FMassEntityHandle Entity) const { return EntityBlackboardData.FindRef(Entity).Get(); }
+
+	// The entity's blackboard fragment, if it has one (and it has been added)
+	const FAIFlowMassBlackboardFragment* FindBlackboardFragment(FMassEntityHandle Entity) const;
+	const FAIFlowMassBlackboardFragment* FindBlackboardFragmentForActor(const AActor* Actor) const { return FindBlackboardFragment(FindEntityForActor(Actor)); }
+
+	// The blackboard fragment of the Mass agent that Actor represents in World, if it has one
+	// (and it is for OptionalSpecificBlackboardData, when that is set), eg, for the AIFlow predicates' Mass agent fallback
+	static const FAIFlowMassBlackboardFragment* FindBlackboardFragmentForActorInWorld(const UWorld* World, const AActor* Actor, const UBlackboardData* OptionalSpecificBlackboardData = nullptr);
+
+	// Queue the Entries' current values to be written to the entity's blackboard.
+	// Entries for keys that the entity's blackboard does not have (or cannot store) are skipped with a warning.
+	void QueueEntryWrites(FMassEntityHandle Entity, TConstArrayView<UFlowBlackboardEntryValue*> Entries);
+
+	// Move the actors that are bound to Mass entities out of InOutActors and into OutMassAgentActors
+	void ExtractMassAgentActors(TArray<AActor*>& InOutActors, TArray<AActor*>& OutMassAgentActors) const;
+
+	// Processor support
+	bool HasPendingWrites() const { return !PendingWrites.IsEmpty(); }
+	void ApplyPendingWrites(FMassEntityHandle Entity, FAIFlowMassBlackboardFragment& Fragment);
+
+	// Discard the pending writes and bookkeeping for entities (and actors) that no longer exist.
+	// Runs on a timer (rather than with every processor execution), so stale entries can linger for up to StaleEntitySweepInterval.
+	void RemoveStaleEntities();
+
+protected:
+
+	FMassEntityManager* GetEntityManager() const;
+
+protected:
+
+	TMap<TObjectKey<AActor>, FMassEntityHandle> EntityByActor;
+	TMap<FMassEntityHandle, TWeakObjectPtr<const UBlackboardData>> EntityBlackboardData;
+
+	// Queued writes for each entity, in the order they were queued
+	TMap<FMassEntityHandle, TArray<FAIFlowMassPendingBlackboardWrite>> PendingWrites;
+
+	// Seconds between the RemoveStaleEntities sweeps
+	static constexpr float StaleEntitySweepInterval = 1.0f;
+
+	FTimerHandle StaleEntitySweepTimerHandle;
+};
@@ -0,0 +1,34 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "MassProcessor.h"
+#include "MassEntityQuery.h"
+
+#include "AIFlowMassBlackboardWriteProcessor.generated.h"
+
+/**
+ * Applies the blackboard writes queued with UAIFlowMassBlackboardSubsystem to the FAIFlowMassBlackboardFragments,
+ * chunk by chunk (each entity's writes in the order they were queued).
+ * Runs on the game thread, as the writes are queued there by the AIFlow nodes.
+ */
+UCLASS()
+class AIFLOW_API UAIFlowMassBlackboardWriteProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+
+	UAIFlowMassBlackboardWriteProcessor();
+
+protected:
+
+	// UMassProcessor
+	virtual void ConfigureQueries(const TSharedRef<FMassEntityManager>& EntityManager) override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+	// --
+
+protected:
+
+	FMassEntityQuery EntityQuery;
+};
@@ -34,6 +34,10 @@ public:
 	virtual int32 GetRandomSeed() const override;
 	// --
 
+	// Called on a deinitialized instance (via UAIFlowAsset::ResetInstanceForReuse) before its flow asset is returned to an instance pool
+	// (and this instance is replaced by a fresh one).  Subclasses must release any runtime registrations that DeinitializeInstance does not.
+	virtual void ResetInstanceForReuse() { }
+
 #if WITH_EDITOR
 	// IFlowBlackboardAssetProvider
 	virtual UBlackboardData* GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const override;
@@ -44,6 +44,10 @@ public:
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void Cleanup() override;
 
+	// UAIFlowNode
+	virtual void ResetInstanceForReuse() override;
+	// --
+
 #if WITH_EDITOR
 	virtual FString GetNodeDescription() const override;
 #endif
@@ -0,0 +1,70 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Nodes/AIFlowNode.h"
+
+#include "FlowNode_BlackboardPredicateBranch.generated.h"
+
+/**
+ * Trigger "True" if all of the node's predicate AddOns are true, or "False" otherwise.
+ *
+ * The predicates are evaluated together, in a shared FAIFlowPredicateEvaluationContext.
+ * With "Defer To Predicate Batch", they are instead handed to UAIFlowPredicateBatchSubsystem,
+ * and the output is triggered when the batch is next evaluated (on the next tick), so that the evaluations
+ * of the same predicate across many instances of a flow asset are evaluated together.
+ */
+UCLASS(DisplayName = "Blackboard Predicate Branch")
+class AIFLOW_API UFlowNode_BlackboardPredicateBranch : public UAIFlowNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UFlowNode_BlackboardPredicateBranch();
+
+	// IFlowCoreExecutableInterface
+	virtual void ExecuteInput(const FName& PinName) override;
+	virtual void Cleanup() override;
+	// --
+
+	// UFlowNodeBase
+	virtual EFlowAddOnAcceptResult AcceptFlowNodeAddOnChild_Implementation(const UFlowNodeAddOn* AddOnTemplate, const TArray<UFlowNodeAddOn*>& AdditionalAddOnsToAssumeAreChildren) const override;
+	// --
+
+	// UAIFlowNode
+	virtual void ResetInstanceForReuse() override;
+	// --
+
+protected:
+
+	// Evaluate the predicate AddOns now, returns true if all of them are true
+	bool EvaluatePredicateAddOns();
+
+	// Hand the predicate AddOns to the batch subsystem, returns false if they could not be requested
+	bool RequestBatchedEvaluation();
+
+	void OnBatchedPredicateEvaluated(bool bResult, uint32 EvaluationSerial);
+
+	void CancelBatchedEvaluation();
+
+protected:
+
+	// Evaluate the predicates with UAIFlowPredicateBatchSubsystem (triggering the output on the next tick)
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	bool bDeferToPredicateBatch = false;
+
+	// Serial of the current batched evaluation (results of earlier evaluations are discarded)
+	uint32 BatchedEvaluationSerial = 0;
+
+	// Results still to be delivered for the current batched evaluation
+	int32 NumPendingBatchedResults = 0;
+
+	// AND of the results delivered so far for the current batched evaluation
+	bool bBatchedResult = true;
+
+public:
+
+	static const FName OUTPIN_True;
+	static const FName OUTPIN_False;
+};
@@ -9,6 +9,7 @@
 
 // Forward Declarations
 class UFlowBlackboardEntryValue;
+struct FAIFlowMassBlackboardFragment;
 
 /**
  * Get blackboard values and provide them as output data pins
@@ -34,7 +35,7 @@ public:
 public:
 
 	// IFlowContextPinSupplierInterface
-	virtual bool SupportsContextPins() const override { return Super::SupportsContextPins() || !BlackboardEntries.IsEmpty(); }
+	virtual bool SupportsContextPins() const override { return Super::SupportsContextPins() || !BlackboardEntries.IsEmpty() || !KeyAgeEntries.IsEmpty(); }
 	// --
 
 	// UObject
@@ -60,9 +61,20 @@ protected:
 
 	static UBlackboardKeyType* GetBlackboardKeyTypeFromBlackboardKeyName(const UBlackboardData* BlackboardAsset, const FName& KeyName);
 
+	// Name of the output data pin for a key's age ("<KeyName> Age")
+	static FName MakeKeyAgePinName(const FName& KeyName);
+
+	// Find the KeyAgeEntries key for a key age pin name, returns false if PinName is not a key age pin
+	bool TryFindKeyAgeKeyNameForPin(const FName& PinName, FName& OutKeyName) const;
+
+	FFlowDataPinResult SupplyKeyAgeDataPin(const FName& KeyName) const;
+
 	UBlackboardComponent* GetBlackboardComponentToApplyTo() const;
 	AActor* TryResolveActorForBlackboard() const;
 
+	// Blackboard fragment of the Mass agent to read from, for actors that represent Mass agents (and have no blackboard component)
+	const FAIFlowMassBlackboardFragment* FindMassBlackboardFragmentToReadFrom() const;
+
 protected:
 
 	// Optional specific actor to use for the blackboard query.
@@ -77,6 +89,11 @@ protected:
 	// Blackboard entries to get from the blackboard and output as data pins
 	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Blackboard Entries", meta = (DisplayPriority = 3))
 	TArray<FFlowBlackboardEntry> BlackboardEntries;
+
+	// Blackboard entries to output the age of (seconds since the key was last written, or -1 if it has not been written) as "<Key> Age" float data pins.
+	// See UAIFlowBlackboardKeyAgeSubsystem.
+	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Key Age Entries", meta = (DisplayPriority = 3))
+	TArray<FFlowBlackboardEntry> KeyAgeEntries;
 	
 	// Search rule to use to find the "Specific Blackboard" (if specified)
 	UPROPERTY(EditAnywhere, Category = Configuration, DisplayName = "Specific Blackboard Search Rule", meta = (EditCondition = "SpecificBlackboardAsset", DisplayAfter = SpecificBlackboardAsset))
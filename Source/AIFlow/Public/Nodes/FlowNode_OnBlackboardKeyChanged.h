@@ -0,0 +1,107 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Nodes/AIFlowNode.h"
+#include "AIFlowActorBlackboardHelper.h"
+#include "Engine/TimerHandle.h"
+#include "Types/FlowBlackboardEntry.h"
+#include "BehaviorTree/BehaviorTreeTypes.h"
+
+#include "FlowNode_OnBlackboardKeyChanged.generated.h"
+
+// Forward Declarations
+class UBlackboardComponent;
+class UFlowBlackboardEntryValue;
+
+/**
+ * Trigger "Changed" when any of the observed blackboard keys change, while the node is started.
+ *
+ * Changes can be filtered to changes to specific values, and bursts of changes can be coalesced
+ * (to one trigger per frame) or debounced (to one trigger, once the keys have stopped changing for an interval).
+ * The node observes the keys with blackboard observers (so it does not poll), and removes its observers
+ * when it is stopped, cleaned up or deinitialized.  "Failed" is triggered (finishing the node) if none of the keys
+ * can be observed (eg, there is no blackboard, or it has none of the keys).
+ */
+UCLASS(DisplayName = "On Blackboard Key Changed")
+class AIFLOW_API UFlowNode_OnBlackboardKeyChanged : public UAIFlowNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UFlowNode_OnBlackboardKeyChanged();
+
+	// IFlowCoreExecutableInterface
+	virtual void ExecuteInput(const FName& PinName) override;
+	virtual void DeinitializeInstance() override;
+	virtual void Cleanup() override;
+	// --
+
+	// UAIFlowNode
+	virtual void ResetInstanceForReuse() override;
+	// --
+
+#if WITH_EDITOR
+	// IFlowBlackboardAssetProvider
+	virtual UBlackboardData* GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const override;
+	// --
+#endif // WITH_EDITOR
+
+protected:
+
+	bool StartObserving();
+	void StopObserving();
+
+	// Index the ChangeToValueFilters by their KeyIDs in the observed blackboard
+	void BuildValueFilters(const UBlackboardData& BlackboardData);
+	bool PassesValueFilters(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey ChangedKeyID) const;
+
+	EBlackboardNotificationResult OnObservedKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey ChangedKeyID);
+	void OnDeferredTrigger();
+
+protected:
+
+	// Keys to observe for changes
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	TArray<FFlowBlackboardEntry> KeysToObserve;
+
+	// Optional values to filter the changes by.  A change to a key with filters only triggers if the key's new value
+	// is equal to one of its filters' values (changes to keys without filters always trigger).
+	UPROPERTY(EditAnywhere, Instanced, Category = Configuration, DisplayName = "Change-To Value Filters")
+	TArray<TObjectPtr<UFlowBlackboardEntryValue>> ChangeToValueFilters;
+
+	// Coalesce the changes made during a frame into a single trigger, on the next frame
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	bool bCoalescePerFrame = false;
+
+	// Trigger once the observed keys have not changed for this many seconds (0 to trigger without debouncing).
+	// When debouncing, bursts of changes are always coalesced.
+	UPROPERTY(EditAnywhere, Category = Configuration, meta = (ClampMin = 0, Units = "Seconds"))
+	float DebounceSeconds = 0.0f;
+
+	// Specific blackboard to observe
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard")
+	TObjectPtr<UBlackboardData> SpecificBlackboardAsset = nullptr;
+
+	// Search rule to use to find the "Specific Blackboard" (if specified)
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard Search Rule", meta = (EditCondition = "SpecificBlackboardAsset"))
+	EActorBlackboardSearchRule SpecificBlackboardSearchRule = EActorBlackboardSearchRule::ActorAndControllerAndGameState;
+
+	// Blackboard component whose keys are observed (while started)
+	TWeakObjectPtr<UBlackboardComponent> ObservedBlackboardComponent;
+
+	// ChangeToValueFilters, by the KeyIDs they filter (owned by ChangeToValueFilters)
+	TMap<FBlackboard::FKey, TArray<const UFlowBlackboardEntryValue*, TInlineAllocator<2>>> FiltersByKeyID;
+
+	// Timer for a coalesced or debounced trigger
+	FTimerHandle DeferredTriggerTimerHandle;
+
+public:
+
+	static const FName INPIN_Stop;
+
+	static const FName OUTPIN_Changed;
+	static const FName OUTPIN_Stopped;
+	static const FName OUTPIN_Failed;
+};
@@ -26,12 +26,17 @@ public:
 	// IFlowCoreExecutableInterface
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void DeinitializeInstance() override;
+	virtual void Cleanup() override;
 	// --
 
 	// UFlowNodeBase
 	virtual void UpdateNodeConfigText_Implementation() override;
 	// --
 
+	// UAIFlowNode
+	virtual void ResetInstanceForReuse() override;
+	// --
+
 #if WITH_EDITOR
 public:
 
@@ -65,6 +70,12 @@ protected:
 	void EnsureInjectComponentsManager();
 	void CleanupInjectComponentsManager();
 
+	// Time-sliced application (see bTimeSliceApplication).
+	// ApplyNextTimeSlice returns true when every blackboard has been applied (otherwise, OnNextTimeSlice is scheduled)
+	bool ApplyNextTimeSlice();
+	void OnNextTimeSlice();
+	void CancelTimeSlicedApplication();
+
 	UFUNCTION()
 	void OnBeforeActorRemoved(AActor* RemovedActor);
 
@@ -106,6 +117,21 @@ protected:
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = Configuration, DisplayName = "Specific Blackboard Component", meta = (EditCondition = "SpecificBlackboardAsset", DisplayAfter = SpecificBlackboardAsset))
 	TSubclassOf<UBlackboardComponent> SpecificBlackboardComponentClass = nullptr;
 
+	// Apply the values over multiple frames, rather than all at once (for large numbers of actors).
+	// "Out" is triggered when the application begins and "Completed" once every blackboard has been applied.
+	// (Without time-slicing, only "Out" is triggered, once every blackboard has been applied.)
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = Configuration, meta = (DisplayPriority = 1))
+	bool bTimeSliceApplication = false;
+
+	// Maximum number of blackboards to apply to each frame, when time-slicing (0 for no limit)
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = Configuration, meta = (ClampMin = 0, EditCondition = "bTimeSliceApplication", DisplayPriority = 1))
+	int32 MaxBlackboardsPerFrame = 32;
+
+	// Maximum time (in microseconds) to spend applying blackboards each frame, when time-slicing (0 for no limit).
+	// At least one blackboard is applied each frame, so the application always makes progress.
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = Configuration, meta = (ClampMin = 0, EditCondition = "bTimeSliceApplication", DisplayPriority = 1))
+	int32 MaxMicrosecondsPerFrame = 0;
+
 	// Helper struct that shared functionality for manipulating Actor blackboards
 	UPROPERTY()
 	FAIFlowActorBlackboardHelper ActorBlackboardHelper;
@@ -113,4 +139,8 @@ protected:
 	// Manager object to inject and remove components from actors
 	UPROPERTY(Transient)
 	TObjectPtr<UFlowInjectComponentsManager> InjectComponentsManager = nullptr;
+
+public:
+
+	static const FName OUTPIN_Completed;
 };
@@ -32,12 +32,17 @@ public:
 	// IFlowCoreExecutableInterface
 	virtual void ExecuteInput(const FName& PinName) override;
 	virtual void DeinitializeInstance() override;
+	virtual void Cleanup() override;
 	// --
 
 	// UFlowNodeBase
 	virtual void UpdateNodeConfigText_Implementation() override;
 	// --
 
+	// UAIFlowNode
+	virtual void ResetInstanceForReuse() override;
+	// --
+
 #if WITH_EDITOR
 	// UObject
 	virtual void PostEditChangeChainProperty(FPropertyChangedChainEvent& PropertyChangedEvent) override;
@@ -63,9 +68,15 @@ protected:
 	// --
 
 	// Blackboard handling helpers (from base class)
-	TArray<UBlackboardComponent*> GetBlackboardComponentsToApplyTo() const;
+	TArray<UBlackboardComponent*> GetBlackboardComponentsToApplyTo(const TArray<AActor*>& ResolvedActors) const;
 	void EnsureInjectComponentsManager();
 	void CleanupInjectComponentsManager();
+
+	// Time-sliced application (see bTimeSliceApplication).
+	// ApplyNextTimeSlice returns true when every blackboard has been applied (otherwise, OnNextTimeSlice is scheduled)
+	bool ApplyNextTimeSlice();
+	void OnNextTimeSlice();
+	void CancelTimeSlicedApplication();
 	// --
 
 	UFUNCTION()
@@ -123,6 +134,21 @@ protected:
 	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = BlackboardAsset, DisplayName = "Specific Blackboard Component", meta = (EditCondition = "SpecificBlackboardAsset", DisplayAfter = SpecificBlackboardAsset))
 	TSubclassOf<UBlackboardComponent> SpecificBlackboardComponentClass = nullptr;
 
+	// Apply the values over multiple frames, rather than all at once (for large numbers of actors).
+	// "Out" is triggered when the application begins and "Completed" once every blackboard has been applied.
+	// (Without time-slicing, only "Out" is triggered, once every blackboard has been applied.)
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = BlackboardEntriesToSet, meta = (DisplayPriority = 1))
+	bool bTimeSliceApplication = false;
+
+	// Maximum number of blackboards to apply to each frame, when time-slicing (0 for no limit)
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = BlackboardEntriesToSet, meta = (ClampMin = 0, EditCondition = "bTimeSliceApplication", DisplayPriority = 1))
+	int32 MaxBlackboardsPerFrame = 32;
+
+	// Maximum time (in microseconds) to spend applying blackboards each frame, when time-slicing (0 for no limit).
+	// At least one blackboard is applied each frame, so the application always makes progress.
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = BlackboardEntriesToSet, meta = (ClampMin = 0, EditCondition = "bTimeSliceApplication", DisplayPriority = 1))
+	int32 MaxMicrosecondsPerFrame = 0;
+
 	// Helper struct that shared functionality for manipulating Actor blackboards
 	UPROPERTY()
 	FAIFlowActorBlackboardHelper ActorBlackboardHelper;
@@ -131,5 +157,9 @@ protected:
 	UPROPERTY(Transient)
 	TObjectPtr<UFlowInjectComponentsManager> InjectComponentsManager = nullptr;
 
+public:
+
+	static const FName OUTPIN_Completed;
+
 	static FName INPIN_SpecificActors;
 };
\ No newline at end of file
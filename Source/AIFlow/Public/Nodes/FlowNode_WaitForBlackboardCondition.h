@@ -0,0 +1,96 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Nodes/AIFlowNode.h"
+#include "AIFlowActorBlackboardHelper.h"
+#include "Blackboard/AIFlowBlackboardExpression.h"
+#include "Engine/TimerHandle.h"
+
+#include "FlowNode_WaitForBlackboardCondition.generated.h"
+
+// Forward Declarations
+class UBlackboardComponent;
+
+/**
+ * Wait for a blackboard condition (a list of Compare Blackboard Value-style comparisons, combined with AND/OR/NOT) to be true.
+ *
+ * Rather than polling, the node observes the keys that the condition reads, and re-evaluates the condition
+ * only when one of them changes, triggering "Condition Met" as soon as it is true (immediately, if it is already true).
+ * The observers are removed when the node finishes or is cleaned up.
+ */
+UCLASS(DisplayName = "Wait For Blackboard Condition")
+class AIFLOW_API UFlowNode_WaitForBlackboardCondition : public UAIFlowNode
+{
+	GENERATED_BODY()
+
+public:
+
+	UFlowNode_WaitForBlackboardCondition();
+
+	// IFlowCoreExecutableInterface
+	virtual void ExecuteInput(const FName& PinName) override;
+	virtual void Cleanup() override;
+	// --
+
+	// UFlowNodeBase
+	virtual void UpdateNodeConfigText_Implementation() override;
+	// --
+
+	// UAIFlowNode
+	virtual void ResetInstanceForReuse() override;
+	// --
+
+#if WITH_EDITOR
+	// UObject
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+	// --
+
+	// IFlowBlackboardAssetProvider
+	virtual UBlackboardData* GetBlackboardAssetForPropertyHandle(const TSharedPtr<IPropertyHandle>& PropertyHandle) const override;
+	// --
+#endif // WITH_EDITOR
+
+protected:
+
+	// Compile the Conditions for BlackboardData (if they are not already compiled for it)
+	bool EnsureProgramCompiled(const UBlackboardData& BlackboardData);
+
+	void StartObservingKeys(UBlackboardComponent& BlackboardComponent);
+	void StopWaiting();
+
+	EBlackboardNotificationResult OnObservedKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey ChangedKeyID);
+	void OnTimeout();
+
+protected:
+
+	// Comparisons to wait for (each joined to the comparisons before it with AND or OR)
+	UPROPERTY(EditAnywhere, Category = Configuration)
+	TArray<FAIFlowBlackboardExpressionClause> Conditions;
+
+	// Seconds to wait before triggering "Timed Out" (0 to wait indefinitely)
+	UPROPERTY(EditAnywhere, Category = Configuration, meta = (ClampMin = 0, Units = "Seconds"))
+	float TimeoutSeconds = 0.0f;
+
+	// Specific blackboard to use for the condition
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard")
+	TObjectPtr<UBlackboardData> SpecificBlackboardAsset = nullptr;
+
+	// Search rule to use to find the "Specific Blackboard" (if specified)
+	UPROPERTY(EditAnywhere, Category = Configuration, AdvancedDisplay, DisplayName = "Specific Blackboard Search Rule", meta = (EditCondition = "SpecificBlackboardAsset"))
+	EActorBlackboardSearchRule SpecificBlackboardSearchRule = EActorBlackboardSearchRule::ActorAndControllerAndGameState;
+
+	// Compiled when the node is first executed
+	FAIFlowBlackboardExpressionProgram Program;
+
+	// Blackboard component whose keys are observed while waiting
+	TWeakObjectPtr<UBlackboardComponent> ObservedBlackboardComponent;
+
+	FTimerHandle TimeoutTimerHandle;
+
+public:
+
+	static const FName OUTPIN_ConditionMet;
+	static const FName OUTPIN_TimedOut;
+	static const FName OUTPIN_Failed;
+};
@@ -0,0 +1,118 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+
+#include "AIFlowAssetPoolSubsystem.generated.h"
+
+// Forward Declarations
+class UAIFlowAsset;
+class UFlowAsset;
+
+// Hit rate and size statistics for the AI flow asset instance pools
+USTRUCT(BlueprintType)
+struct AIFLOW_API FAIFlowAssetPoolStats
+{
+	GENERATED_BODY()
+
+	// Acquires that were satisfied from a pool
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	int32 Hits = 0;
+
+	// Acquires that found no pooled instance (and the caller had to create a new instance)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	int32 Misses = 0;
+
+	// Instances returned to a pool
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	int32 Returned = 0;
+
+	// Instances that could not be returned, because their pool was full
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	int32 Discarded = 0;
+
+	// Instances currently waiting in all pools
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	int32 PooledInstances = 0;
+
+	float GetHitRate() const { return (Hits + Misses) > 0 ? static_cast<float>(Hits) / static_cast<float>(Hits + Misses) : 0.0f; }
+};
+
+// Pooled (deinitialized and reset) instances for a single template asset
+USTRUCT()
+struct FAIFlowAssetInstancePool
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Transient)
+	TArray<TObjectPtr<UAIFlowAsset>> Instances;
+};
+
+/**
+ * Per-world pool of deinitialized UAIFlowAsset instances, keyed by their template asset.
+ *
+ * AcquireOrCreateInstance is the pooled replacement for creating and initializing a flow instance,
+ * and ReleaseInstance deinitializes the instance and returns it to its template's pool.
+ * (Code that creates its own instances can use TryAcquireInstance and ReturnInstance directly.)
+ *
+ * Pools are keyed weakly, so the pool map does not keep template assets loaded
+ * (the pooled instances still reference their template, until they are released with EmptyPool or EmptyPools).
+ */
+UCLASS(Config = Game)
+class AIFLOW_API UAIFlowAssetPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// USubsystem
+	virtual void Deinitialize() override;
+	// --
+
+	// Returns an instance of TemplateAsset in Outer (from its pool, or newly created), initialized for InOwner
+	UAIFlowAsset* AcquireOrCreateInstance(UAIFlowAsset& TemplateAsset, UObject& Outer, const TWeakObjectPtr<UObject> InOwner);
+
+	// Batched AcquireOrCreateInstance (eg, for a wave of spawns), initialized with UAIFlowAsset::InitializeInstances.
+	// OutInstances[Index] is the instance for Owners[Index].
+	void AcquireOrCreateInstances(UAIFlowAsset& TemplateAsset, UObject& Outer, TArrayView<const TWeakObjectPtr<UObject>> Owners, TArray<UAIFlowAsset*>& OutInstances);
+
+	// Deinitialize an instance from AcquireOrCreateInstance and return it to its template's pool
+	void ReleaseInstance(UAIFlowAsset& Instance);
+
+	// Returns a pooled instance for TemplateAsset (or nullptr, if none are available)
+	UAIFlowAsset* TryAcquireInstance(const UFlowAsset& TemplateAsset);
+
+	// Reset a deinitialized instance and add it to its template's pool.
+	// Returns false if the instance cannot be pooled (the caller should let it be garbage collected).
+	bool ReturnInstance(UAIFlowAsset& DeinitializedInstance);
+
+	// Release the pooled instances of a single template (eg, when its last spawner is unloaded)
+	void EmptyPool(const UFlowAsset& TemplateAsset);
+
+	// Release all pooled instances (eg, on memory pressure)
+	void EmptyPools();
+
+	UFUNCTION(BlueprintPure, Category = AIFlow)
+	FAIFlowAssetPoolStats GetPoolStats() const { return Stats; }
+
+	UFUNCTION(BlueprintPure, Category = AIFlow)
+	float GetPoolHitRate() const { return Stats.GetHitRate(); }
+
+protected:
+
+	// Returns a pooled (or new) instance of TemplateAsset that has not been initialized yet
+	UAIFlowAsset* AcquireOrCreateUninitializedInstance(UAIFlowAsset& TemplateAsset, UObject& Outer);
+
+	// Remove the pools whose template assets have been garbage collected
+	void PruneStalePools();
+
+	// Maximum number of pooled instances per template asset (0 disables pooling)
+	UPROPERTY(Config, EditAnywhere, Category = Configuration, meta = (ClampMin = 0))
+	int32 MaxPooledInstancesPerTemplate = 32;
+
+	UPROPERTY(Transient)
+	TMap<TWeakObjectPtr<UFlowAsset>, FAIFlowAssetInstancePool> InstancePools;
+
+	FAIFlowAssetPoolStats Stats;
+};
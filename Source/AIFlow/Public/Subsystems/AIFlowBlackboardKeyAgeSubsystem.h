@@ -0,0 +1,80 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "AIFlowBlackboardKeyAgeSubsystem.generated.h"
+
+/**
+ * Per-world side table of the last time each blackboard key was written, per blackboard component.
+ *
+ * AIFlow's own writes (FAIFlowActorBlackboardHelper) are recorded directly (including writes of an unchanged value),
+ * other writes (eg, from behavior trees or game code) are recorded by blackboard observers, which are registered
+ * on a key the first time its age is asked for (or on every key, by StartObservingEngineWrites).
+ *
+ * Write times are stored as world time seconds (a double per KeyID), so a component's table is a single small array.
+ */
+UCLASS()
+class AIFLOW_API UAIFlowBlackboardKeyAgeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// USubsystem
+	virtual void Deinitialize() override;
+	// --
+
+	// Record that a key was written (now) on BlackboardComponent
+	void RecordKeyWrite(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID);
+	void RecordKeyWrite(const UBlackboardComponent& BlackboardComponent, const FName& KeyName);
+
+	// Write a key with WriteKey and record the write.  The write's observer notification (if the key is observed)
+	// is not recorded again.
+	void WriteAndRecordKey(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, TFunctionRef<void()> WriteKey);
+
+	// Observe a key of BlackboardComponent (or every key), so that writes from outside of AIFlow are recorded
+	void StartObservingKey(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID);
+	void StartObservingEngineWrites(UBlackboardComponent& BlackboardComponent);
+
+	// Seconds since the key was last written, returns false if it has not been written since it was first tracked.
+	// The key is observed from its first query on, so earlier writes made outside of AIFlow are not known.
+	bool TryGetKeyAge(UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID, float& OutAgeSeconds);
+	bool TryGetKeyAge(UBlackboardComponent& BlackboardComponent, const FName& KeyName, float& OutAgeSeconds);
+
+protected:
+
+	struct FComponentKeyWriteTimes
+	{
+		TWeakObjectPtr<UBlackboardComponent> BlackboardComponent;
+
+		// Last write time (world seconds) by KeyID, negative for never written
+		TArray<double> WriteTimes;
+
+		// Keys with an observer registered by this subsystem, by KeyID
+		TBitArray<> ObservedKeys;
+	};
+
+	FComponentKeyWriteTimes& FindOrAddEntry(const UBlackboardComponent& BlackboardComponent);
+
+	// Remove the entries for components that have been destroyed
+	void PruneStaleEntries();
+
+	static FBlackboard::FKey FindKeyID(const UBlackboardComponent& BlackboardComponent, const FName& KeyName);
+
+	EBlackboardNotificationResult OnObservedKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID);
+
+protected:
+
+	TMap<TObjectKey<UBlackboardComponent>, FComponentKeyWriteTimes> EntriesByComponent;
+
+	// Entries added since the last prune
+	int32 NumEntriesAddedSincePrune = 0;
+
+	// Key being written by WriteAndRecordKey (whose observer notification is not recorded)
+	TObjectKey<UBlackboardComponent> DirectWriteComponent;
+	FBlackboard::FKey DirectWriteKeyID = FBlackboard::InvalidKey;
+};
@@ -0,0 +1,137 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "BehaviorTree/BlackboardComponent.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "AIFlowColumnarBlackboardSubsystem.generated.h"
+
+// Forward Declarations
+class UBlackboardData;
+
+// Column storage type for a blackboard key in a columnar store
+enum class EAIFlowBlackboardColumnType : uint8
+{
+	Float,
+	Int,
+	Bool,
+};
+
+// One column (the values of one key, for every agent) in a columnar blackboard store
+struct FAIFlowBlackboardColumn
+{
+	FName KeyName = NAME_None;
+	FBlackboard::FKey KeyID = FBlackboard::InvalidKey;
+	EAIFlowBlackboardColumnType Type = EAIFlowBlackboardColumnType::Float;
+
+	// Float keys use Floats, Int and Bool keys use Ints (with Bools as 0 or 1)
+	TArray<float> Floats;
+	TArray<int32> Ints;
+};
+
+// Structure-of-arrays values for all of the agents (blackboard components) that use one blackboard asset
+struct FAIFlowColumnarBlackboardStore
+{
+	// Components, by row (rows are kept dense, removal swaps the last row into the removed row)
+	TArray<TObjectKey<UBlackboardComponent>> Rows;
+	TMap<TObjectKey<UBlackboardComponent>, int32> RowByComponent;
+
+	TArray<FAIFlowBlackboardColumn> Columns;
+	TMap<FBlackboard::FKey, int32> ColumnIndexByKeyID;
+
+	const FAIFlowBlackboardColumn* FindColumn(const FName& KeyName) const;
+	FAIFlowBlackboardColumn* FindColumn(const FName& KeyName) { return const_cast<FAIFlowBlackboardColumn*>(static_cast<const FAIFlowColumnarBlackboardStore*>(this)->FindColumn(KeyName)); }
+};
+
+/**
+ * Per-world columnar (structure-of-arrays) store of blackboard values, keyed by blackboard asset,
+ * for UAIFlowColumnarBlackboardComponent agents.
+ *
+ * The Float, Int and Bool keys of every registered agent are mirrored into contiguous columns,
+ * so that cross-agent passes (eg, decaying a "threat" float on everyone) run over packed memory (with vector math for floats),
+ * rather than touching a cache line per blackboard component.  Only the rows that a bulk operation changed are written back
+ * to their components (through the usual SetValue, so observers are still notified).
+ *
+ * The components remain the source of truth for per-agent Get/Set, changes made through the component API are mirrored
+ * into the columns by blackboard observers.
+ */
+UCLASS()
+class AIFLOW_API UAIFlowColumnarBlackboardSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// USubsystem
+	virtual void Deinitialize() override;
+	// --
+
+	// Add (or remove) a component's row in the store for its blackboard asset.
+	// Unregistering while rows are being written back is deferred until the write-back has finished.
+	void RegisterComponent(UBlackboardComponent& BlackboardComponent);
+	void UnregisterComponent(UBlackboardComponent& BlackboardComponent);
+
+	// Call after (re-)initializing BlackboardComponent's blackboard, so that a columnar component's row
+	// moves to the store for its new blackboard asset (does nothing for other blackboard components)
+	static void SyncComponentRegistration(UBlackboardComponent& BlackboardComponent);
+
+	// Value = Clamp(Value * Scale + Offset, ClampMin, ClampMax), for a float key on every agent using BlackboardData.
+	// Returns the number of agents whose value changed.
+	int32 BulkMultiplyAddFloat(const UBlackboardData& BlackboardData, const FName& KeyName, float Scale, float Offset, float ClampMin = -UE_BIG_NUMBER, float ClampMax = UE_BIG_NUMBER);
+
+	// Set a float key to Value on every agent using BlackboardData, returns the number of agents whose value changed
+	int32 BulkSetFloat(const UBlackboardData& BlackboardData, const FName& KeyName, float Value);
+
+	// Value = Clamp(Value + Delta, ClampMin, ClampMax), for an int key on every agent using BlackboardData.
+	// Returns the number of agents whose value changed.
+	int32 BulkAddInt(const UBlackboardData& BlackboardData, const FName& KeyName, int32 Delta, int32 ClampMin = MIN_int32, int32 ClampMax = MAX_int32);
+
+	// Set a bool key to bValue on every agent using BlackboardData, returns the number of agents whose value changed
+	int32 BulkSetBool(const UBlackboardData& BlackboardData, const FName& KeyName, bool bValue);
+
+	// Gather the components whose float key is within [RangeMin, RangeMax] (a column scan, the components are not touched)
+	int32 GatherComponentsWithFloatInRange(const UBlackboardData& BlackboardData, const FName& KeyName, float RangeMin, float RangeMax, TArray<UBlackboardComponent*>& OutComponents) const;
+
+	// Read-only access to a store (eg, for custom column scans), null if no agents using BlackboardData have been registered
+	const FAIFlowColumnarBlackboardStore* FindStore(const UBlackboardData& BlackboardData) const;
+
+	// Mutable access to a store, for the bulk operations (values changed directly in the columns are not written back to the components)
+	FAIFlowColumnarBlackboardStore* FindStore(const UBlackboardData& BlackboardData);
+
+protected:
+
+	FAIFlowColumnarBlackboardStore& FindOrAddStore(const UBlackboardData& BlackboardData);
+
+	void ReadRowFromComponent(FAIFlowColumnarBlackboardStore& Store, int32 Row, const UBlackboardComponent& BlackboardComponent) const;
+	void RemoveRow(FAIFlowColumnarBlackboardStore& Store, int32 Row);
+
+	// Remove the component's row (from whichever store it is in), and the store if it is left empty
+	void RemoveComponentRow(const TObjectKey<UBlackboardComponent>& ComponentKey);
+
+	// Unregister the components whose unregistration was deferred by a write-back
+	void FlushPendingUnregistrations();
+
+	// Write the changed rows of a column back to their components.
+	// The components and values are snapshotted before any are written, since SetValue notifies observers synchronously
+	// (which may register or unregister components, or run other bulk operations).
+	int32 WriteBackRows(const FAIFlowColumnarBlackboardStore& Store, const FAIFlowBlackboardColumn& Column, TConstArrayView<int32> ChangedRows);
+
+	EBlackboardNotificationResult OnColumnKeyChanged(const UBlackboardComponent& BlackboardComponent, FBlackboard::FKey KeyID);
+
+protected:
+
+	TMap<TObjectKey<UBlackboardData>, TUniquePtr<FAIFlowColumnarBlackboardStore>> Stores;
+
+	// Set while writing bulk results back to the components (unregistrations are deferred until the write-back has finished)
+	bool bWritingBackRows = false;
+
+	// The component and key currently being written back, whose (first) change notification is already reflected in the column.
+	// Notifications for any other component or key during a write-back are still mirrored.
+	TObjectKey<UBlackboardComponent> WritingBackComponent;
+	FBlackboard::FKey WritingBackKeyID = FBlackboard::InvalidKey;
+
+	// Components unregistered during a write-back, to unregister when it has finished
+	TArray<TObjectKey<UBlackboardComponent>> PendingUnregistrations;
+};
@@ -0,0 +1,170 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Subsystems/WorldSubsystem.h"
+#include "Types/FlowEnumUtils.h"
+#include "UObject/ObjectKey.h"
+
+#include "AIFlowInjectionQueueSubsystem.generated.h"
+
+// Forward Declarations
+class AActor;
+class UFlowNodeAddOn_InjectComponents;
+class UFlowNodeBase;
+
+// Order in which the queued injection requests are serviced
+UENUM()
+enum class EAIFlowInjectionQueuePriority : uint8
+{
+	// Service the requests in the order they were queued
+	FirstInFirstOut UMETA(DisplayName = "First In, First Out"),
+
+	// Service the requests for Actors closest to a local player's viewpoint (when the request was queued) first
+	NearestToPlayerFirst UMETA(DisplayName = "Nearest To Player First"),
+
+	Max UMETA(Hidden),
+	Invalid UMETA(Hidden),
+	Min = 0 UMETA(Hidden),
+};
+FLOW_ENUM_RANGE_VALUES(EAIFlowInjectionQueuePriority);
+
+// Runtime statistics for the injection queue (also published to "stat AIFlow")
+USTRUCT(BlueprintType)
+struct AIFLOW_API FAIFlowInjectionQueueStats
+{
+	GENERATED_BODY()
+
+	// Number of requests currently waiting in the queue
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	int32 QueueDepth = 0;
+
+	// Largest QueueDepth seen since the subsystem was initialized
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	int32 PeakQueueDepth = 0;
+
+	// Total requests serviced since the subsystem was initialized
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	int32 TotalCompleted = 0;
+
+	// Time (in seconds) between a request being queued and it being serviced, for the most recent tick
+	// (including any requests serviced by FlushQueue since the previous tick)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	float LastTickMaxLatencySeconds = 0.0f;
+
+	// Largest latency (in seconds) seen since the subsystem was initialized
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = AIFlow)
+	float PeakLatencySeconds = 0.0f;
+};
+
+DECLARE_MULTICAST_DELEGATE_TwoParams(FAIFlowOnQueuedInjectionCompleted, AActor* /* Actor */, UFlowNodeAddOn_InjectComponents* /* Requester */);
+
+/**
+ * Per-world queue that time-slices component injection for spawned actors,
+ * so that a large number of actors spawning in one frame does not inject all of their components synchronously.
+ */
+UCLASS(Config = Game)
+class AIFLOW_API UAIFlowInjectionQueueSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// USubsystem
+	virtual void Deinitialize() override;
+	// --
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// --
+
+	// Queue an injection request for Actor, to be serviced by Requester in a later tick
+	// (the Requester is notified of the spawned actor, from SpawningFlowNodeBase, after its components are injected)
+	void EnqueueInjection(AActor& Actor, UFlowNodeAddOn_InjectComponents& Requester, UFlowNodeBase* SpawningFlowNodeBase);
+
+	// Remove all of the outstanding requests from Requester (eg, when it is deinitialized)
+	void CancelRequestsFrom(const UFlowNodeAddOn_InjectComponents& Requester);
+
+	// Service all outstanding requests immediately, ignoring the frame budget
+	void FlushQueue();
+
+	// Is the Actor waiting for (at least one) queued injection to complete?
+	UFUNCTION(BlueprintPure, Category = AIFlow)
+	bool IsActorPendingInjection(const AActor* Actor) const;
+
+	UFUNCTION(BlueprintPure, Category = AIFlow)
+	FAIFlowInjectionQueueStats GetQueueStats() const { return Stats; }
+
+	// Broadcast after a queued injection request has been serviced
+	FAIFlowOnQueuedInjectionCompleted OnInjectionCompleted;
+
+protected:
+
+	struct FQueuedInjection
+	{
+		TWeakObjectPtr<AActor> Actor;
+		TObjectKey<AActor> ActorKey;
+		TWeakObjectPtr<UFlowNodeAddOn_InjectComponents> Requester;
+		TWeakObjectPtr<UFlowNodeBase> SpawningFlowNodeBase;
+		double EnqueueTimeSeconds = 0.0;
+		double PrioritySortKey = 0.0;
+		uint32 Sequence = 0;
+		bool bCancelled = false;
+	};
+
+	// Heap order for QueuedInjections (lowest PrioritySortKey first, then first-in, first-out)
+	struct FQueuedInjectionPriorityPredicate
+	{
+		bool operator()(const FQueuedInjection& A, const FQueuedInjection& B) const
+		{
+			return A.PrioritySortKey < B.PrioritySortKey || (A.PrioritySortKey == B.PrioritySortKey && A.Sequence < B.Sequence);
+		}
+	};
+
+	void ServiceQueue(bool bRespectFrameBudget);
+
+	// Sort key for a request for Actor (its squared distance to the nearest local player viewpoint, for NearestToPlayerFirst)
+	double ComputePrioritySortKey(const AActor& Actor);
+	const TArray<FVector, TInlineAllocator<4>>& GetLocalPlayerViewLocations();
+
+	// Returns true if the request was serviced (false if it was cancelled or its Actor or Requester is gone)
+	bool ServiceRequest(const FQueuedInjection& Request, double NowSeconds);
+	void RemovePendingActor(const TObjectKey<AActor>& ActorKey);
+	void PublishStats();
+
+protected:
+
+	// Per-frame time budget (in milliseconds) for servicing queued injection requests
+	UPROPERTY(Config, EditAnywhere, Category = Configuration, meta = (ClampMin = 0.0))
+	float FrameBudgetMilliseconds = 1.0f;
+
+	// Minimum number of requests serviced each frame (regardless of budget), so the queue always makes progress
+	UPROPERTY(Config, EditAnywhere, Category = Configuration, meta = (ClampMin = 1))
+	int32 MinRequestsPerFrame = 1;
+
+	UPROPERTY(Config, EditAnywhere, Category = Configuration)
+	EAIFlowInjectionQueuePriority PriorityOrder = EAIFlowInjectionQueuePriority::NearestToPlayerFirst;
+
+	// Outstanding requests, a heap ordered by FQueuedInjectionPriorityPredicate.
+	// The PrioritySortKey is computed when the request is queued, so the queue is never re-sorted.
+	TArray<FQueuedInjection> QueuedInjections;
+
+	// Number of the QueuedInjections that have been cancelled (and are discarded when they reach the top of the heap)
+	int32 NumCancelledInjections = 0;
+
+	// Local player viewpoints, gathered at most once per frame
+	TArray<FVector, TInlineAllocator<4>> CachedViewLocations;
+	uint64 CachedViewLocationsFrame = MAX_uint64;
+
+	// Number of outstanding requests per Actor
+	TMap<TObjectKey<AActor>, int32> PendingCountByActor;
+
+	FAIFlowInjectionQueueStats Stats;
+
+	// QueueDepth last added to the (all worlds) queue depth stat
+	int32 PublishedQueueDepth = 0;
+
+	uint32 NextSequence = 0;
+};
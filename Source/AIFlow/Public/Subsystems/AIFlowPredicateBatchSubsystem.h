@@ -0,0 +1,96 @@
+// Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
+
+#pragma once
+
+#include "Blackboard/AIFlowBlackboardExpression.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+
+#include "AIFlowPredicateBatchSubsystem.generated.h"
+
+// Forward Declarations
+class UBlackboardComponent;
+class UBlackboardData;
+class UFlowNodeAddOn;
+
+DECLARE_DELEGATE_OneParam(FAIFlowOnBatchedPredicateEvaluated, bool /* bResult */);
+
+/**
+ * Opt-in per-world scheduler for predicate evaluations, for nodes that can accept their predicate's result a tick later.
+ *
+ * Pending evaluations of the same Compare Blackboard Value predicate (the same predicate in the template flow asset)
+ * on the same blackboard asset are evaluated together: the predicate is compiled once for the batch,
+ * the keys' raw values are gathered from every instance's blackboard into contiguous arrays,
+ * compared four at a time with vector math (for Float, Int and Enum keys), and the results scattered back to the requesters.
+ * Pending evaluations of the same Blackboard Distance predicate (measured against an explicit location) are likewise
+ * tested together against that location with FAIFlowDistanceBatch.
+ * Other predicates (and predicates that cannot be batched, eg, on Mass agents) are evaluated individually.
+ * Float equality uses the same tolerance as the Float key type, so batched and individual results agree.
+ *
+ * Nodes opt in per node (eg, UFlowNode_BlackboardPredicateBranch's "Defer To Predicate Batch").
+ */
+UCLASS()
+class AIFLOW_API UAIFlowPredicateBatchSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+
+	// USubsystem
+	virtual void Deinitialize() override;
+	// --
+
+	// FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// --
+
+	// Queue PredicateAddOn's evaluation, OnEvaluated is executed with the result when the pending evaluations are next evaluated
+	// (in this subsystem's next tick, or by FlushPendingEvaluations).  Bind OnEvaluated to the requester, so that
+	// the results for requesters that have been destroyed are discarded.
+	void RequestEvaluation(const UFlowNodeAddOn& PredicateAddOn, FAIFlowOnBatchedPredicateEvaluated OnEvaluated);
+
+	// Evaluate all of the pending evaluations now
+	void FlushPendingEvaluations();
+
+	int32 GetNumPendingEvaluations() const { return NumPendingEvaluations; }
+
+protected:
+
+	struct FPendingEvaluation
+	{
+		TWeakObjectPtr<const UFlowNodeAddOn> PredicateAddOn;
+		TWeakObjectPtr<const UBlackboardComponent> BlackboardComponent;
+		FAIFlowOnBatchedPredicateEvaluated OnEvaluated;
+		bool bResult = false;
+	};
+
+	// Pending evaluations of one (template) predicate on one blackboard asset, and the predicate compiled for it
+	// (groups are removed once they have been evaluated)
+	struct FBatchGroup
+	{
+		TWeakObjectPtr<const UBlackboardData> BlackboardData;
+		FAIFlowBlackboardExpressionProgram Program;
+		TArray<FPendingEvaluation> PendingEvaluations;
+	};
+
+	using FBatchGroupKey = TPair<TObjectKey<UObject>, TObjectKey<UBlackboardData>>;
+
+	void EvaluateBatchGroup(FBatchGroup& BatchGroup, TArray<FPendingEvaluation>& InOutEvaluations) const;
+	static void EvaluateIndividually(FPendingEvaluation& Evaluation);
+
+	// Distance predicates are tested against their (shared) explicit location with FAIFlowDistanceBatch
+	static void EvaluateDistanceBatchGroup(const UBlackboardData& BlackboardData, TArray<FPendingEvaluation>& InOutEvaluations);
+
+	// Vectorized compare kernels, for Count values (RightValues may be null, to compare against RightConstant)
+	static void CompareFloats(const float* LeftValues, const float* RightValues, float RightConstant, int32 Count, EPredicateCompareOperatorType OperatorType, bool* OutResults);
+	static void CompareInts(const int32* LeftValues, const int32* RightValues, int32 RightConstant, int32 Count, EPredicateCompareOperatorType OperatorType, bool* OutResults);
+
+protected:
+
+	TMap<FBatchGroupKey, FBatchGroup> BatchGroups;
+	TArray<FPendingEvaluation> IndividualEvaluations;
+
+	int32 NumPendingEvaluations = 0;
+};
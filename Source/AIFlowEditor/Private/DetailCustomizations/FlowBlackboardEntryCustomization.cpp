@@ -1,11 +1,13 @@
 // Copyright https://github.com/MothCocoon/FlowGraph/graphs/contributors
 
 #include "FlowBlackboardEntryCustomization.h"
+#include "Blackboard/AIFlowBlackboardKeyTable.h"
 #include "Interfaces/FlowBlackboardAssetProvider.h"
 #include "Types/FlowBlackboardEntry.h"
 
 #include "BehaviorTree/BlackboardData.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_NativeEnum.h"
 #include "IDetailChildrenBuilder.h"
 #include "UObject/UnrealType.h"
 
@@ -59,51 +61,59 @@ TArray<FName> FFlowBlackboardEntryCustomization::GetFlowBlackboardEntries(
 
 	const TArray<TObjectPtr<UBlackboardKeyType>>& AllowedTypes = FlowBlackboardEntry.AllowedTypes;
 
-	for (const UBlackboardData* It = &BlackboardAsset; It; It = It->Parent)
+	const FAIFlowBlackboardKeyTableRef KeyTable = FAIFlowBlackboardKeyTable::Get(BlackboardAsset);
+	for (const FAIFlowBlackboardKeyTableEntry& Entry : KeyTable->GetEntries())
 	{
-		for (int32 KeyIndex = 0; KeyIndex < It->Keys.Num(); KeyIndex++)
+		if (!Entry.KeyType)
 		{
-			const FBlackboardEntry& EntryInfo = It->Keys[KeyIndex];
-			if (!EntryInfo.KeyType)
-			{
-				continue;
-			}
+			continue;
+		}
+
+		// Add all BlackboardKeys that pass the AllowedTypes filters
+		bool bFilterPassed = true;
+		if (AllowedTypes.Num())
+		{
+			bFilterPassed = false;
 
-			// Add all BlackboardKeys that pass the AllowedTypes filters
-			bool bFilterPassed = true;
-			if (AllowedTypes.Num())
+			for (int32 FilterIndex = 0; FilterIndex < AllowedTypes.Num(); FilterIndex++)
 			{
-				bFilterPassed = false;
+				UBlackboardKeyType* AllowedType = AllowedTypes[FilterIndex];
 
-				for (int32 FilterIndex = 0; FilterIndex < AllowedTypes.Num(); FilterIndex++)
+				if (Entry.KeyType->IsAllowedByFilter(AllowedType))
 				{
-					UBlackboardKeyType* AllowedType = AllowedTypes[FilterIndex];
+					bFilterPassed = true;
+
+					break;
+				}
 
-					if (EntryInfo.KeyType->IsAllowedByFilter(AllowedType))
+				// Special-case for enum filter without an EnumType set
+				//  (that is, show all enum type blackboard entries when no specific enum type filter is set)
+				if (UBlackboardKeyType_Enum* AllowedTypeEnum = Cast<UBlackboardKeyType_Enum>(AllowedType))
+				{
+					if (Entry.KeyType->IsA<UBlackboardKeyType_Enum>() && !AllowedTypeEnum->EnumType)
 					{
 						bFilterPassed = true;
 
 						break;
 					}
+				}
 
-					// Special-case for enum filter without an EnumType set
-					//  (that is, show all enum type blackboard entries when no specific enum type filter is set)
-					if (UBlackboardKeyType_Enum* AllowedTypeEnum = Cast<UBlackboardKeyType_Enum>(AllowedType))
+				// (and likewise for a native enum filter without an EnumName)
+				if (UBlackboardKeyType_NativeEnum* AllowedTypeNativeEnum = Cast<UBlackboardKeyType_NativeEnum>(AllowedType))
+				{
+					if (Entry.KeyType->IsA<UBlackboardKeyType_NativeEnum>() && AllowedTypeNativeEnum->EnumName.IsEmpty())
 					{
-						if (EntryInfo.KeyType->IsA<UBlackboardKeyType_Enum>() && !AllowedTypeEnum->EnumType)
-						{
-							bFilterPassed = true;
+						bFilterPassed = true;
 
-							break;
-						}
+						break;
 					}
 				}
 			}
+		}
 
-			if (bFilterPassed)
-			{
-				ValidBlackboardEntries.Add(EntryInfo.EntryName);
-			}
+		if (bFilterPassed)
+		{
+			ValidBlackboardEntries.Add(Entry.KeyName);
 		}
 	}
 